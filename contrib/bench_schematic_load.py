@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""
+Measures how long Qucs-S takes to open a large schematic.
+
+A synthetic schematic with the given number of resistors (50000 by default)
+is written into a temporary directory: rows of resistors joined by short
+wires, the wires of every tenth row labeled. It is then netlisted with
+batch mode, once per given executable, and the open time reported in the
+batch summary ("load_ms") and the peak memory of the process are printed.
+
+Example, to compare two builds:
+
+    bench_schematic_load.py build-old/qucs/qucs-s build-new/qucs/qucs-s
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+PER_ROW = 250
+PITCH = 80   # resistor pins are 60 apart, the rest is wire
+
+
+def write_schematic(path, count):
+    rows = (count + PER_ROW - 1) // PER_ROW
+    with open(path, "w", encoding="utf-8") as f:
+        f.write("<Qucs Schematic 25.1.2>\n")
+        f.write("<Properties>\n  <View=0,0,%d,%d,1,0,0>\n</Properties>\n"
+                % (PER_ROW * PITCH, rows * PITCH))
+        f.write("<Symbol>\n</Symbol>\n<Components>\n")
+        n = 0
+        for row in range(rows):
+            y = row * PITCH
+            for col in range(min(PER_ROW, count - n)):
+                n += 1
+                f.write('  <R R%d 1 %d %d -26 15 0 0 "1k" 1 "26.85" 0 "0.0" 0 '
+                        '"0.0" 0 "26.85" 0 "european" 0>\n'
+                        % (n, col * PITCH + 30, y))
+        f.write("</Components>\n<Wires>\n")
+        n = 0
+        for row in range(rows):
+            y = row * PITCH
+            cols = min(PER_ROW, count - n)
+            n += cols
+            for col in range(cols - 1):
+                x = col * PITCH + 60
+                label = '"n%d_%d" %d %d 0' % (row, col, x, y - 30) if row % 10 == 0 else '"" 0 0 0'
+                f.write("  <%d %d %d %d %s \"\">\n" % (x, y, x + PITCH - 60, y, label))
+        f.write("</Wires>\n<Diagrams>\n</Diagrams>\n<Paintings>\n</Paintings>\n")
+
+
+def run(executable, schematic, outdir):
+    summary = os.path.join(outdir, "summary.json")
+    proc = subprocess.Popen([executable, "-n", "--ngspice", "--batch", schematic,
+                             "-o", outdir, "--summary", summary],
+                            stdout=subprocess.DEVNULL)
+    _, status, usage = os.wait4(proc.pid, 0)
+    proc.returncode = os.waitstatus_to_exitcode(status)
+    if proc.returncode != 0:
+        sys.exit("%s exited with %d" % (executable, proc.returncode))
+    with open(summary, encoding="utf-8") as f:
+        result = json.load(f)["results"][0]
+    if result["status"] != "passed":
+        sys.exit("%s: %s" % (executable, result.get("error", "failed")))
+    return result["load_ms"], usage.ru_maxrss   # in kB
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("executables", nargs="+", help="qucs-s binaries to compare")
+    parser.add_argument("-c", "--components", type=int, default=50000)
+    parser.add_argument("-r", "--repeat", type=int, default=3)
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as outdir:
+        schematic = os.path.join(outdir, "large.sch")
+        write_schematic(schematic, args.components)
+        print("%d components, %.1f MB" % (args.components,
+              os.path.getsize(schematic) / 1e6))
+        for exe in args.executables:
+            times = []
+            peak = 0
+            for _ in range(args.repeat):
+                ms, rss = run(exe, schematic, outdir)
+                times.append(ms)
+                peak = max(peak, rss)
+            print("%s: open %d ms (best of %d), peak memory %.0f MB"
+                  % (exe, min(times), args.repeat, peak / 1024))
+
+
+if __name__ == "__main__":
+    main()
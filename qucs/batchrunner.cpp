@@ -0,0 +1,298 @@
+/***************************************************************************
+                              batchrunner.cpp
+                             -----------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "batchrunner.h"
+#include "main.h"
+#include "module.h"
+#include "schematic.h"
+#include "extsimkernels/externsimdialog.h"
+#include "extsimkernels/ngspice.h"
+#include "extsimkernels/spicecompat.h"
+#include "extsimkernels/xyce.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QRegularExpression>
+#include <QScopedPointer>
+#include <QTextStream>
+#include <QThread>
+
+#include <cstdio>
+
+BatchRunner::BatchRunner(int simulator, bool simulate, QObject *parent)
+  : QObject(parent), Simulator(simulator), Simulate(simulate),
+    Jobs(qMax(1, QThread::idealThreadCount()))
+{
+}
+
+/*!
+   Returns the schematics named by "spec". It is either a file listing
+   one schematic per line (relative to the list file, lines starting
+   with '#' are skipped) or a wildcard pattern like "tests/*.sch".
+*/
+QStringList BatchRunner::expandInputs(const QString& spec, QString& error)
+{
+  QStringList Files;
+  QFileInfo Info(spec);
+  static const QRegularExpression Wildcard("[*?\\[]");
+
+  if (Info.fileName().contains(Wildcard)) {
+    QDir Dir(Info.path());
+    const QStringList Names =
+      Dir.entryList(QStringList(Info.fileName()), QDir::Files, QDir::Name);
+    for (const QString& Name : Names)
+      Files.append(Dir.absoluteFilePath(Name));
+  } else {
+    QFile File(spec);
+    if (!File.open(QIODevice::ReadOnly | QIODevice::Text)) {
+      error = QStringLiteral("Could not read list %1").arg(spec);
+      return Files;
+    }
+    QDir Base = Info.absoluteDir();
+    QTextStream Stream(&File);
+    while (!Stream.atEnd()) {
+      QString Line = Stream.readLine().trimmed();
+      if (Line.isEmpty() || Line.startsWith('#')) continue;
+      Files.append(QDir::cleanPath(Base.absoluteFilePath(Line)));
+    }
+  }
+
+  if (Files.isEmpty())
+    error = QStringLiteral("No schematics found in %1").arg(spec);
+  return Files;
+}
+
+/*!
+   Processes all schematics and returns the number of failed ones.
+*/
+int BatchRunner::run(const QStringList& schematics)
+{
+  QucsSettings.DefaultSimulator = Simulator;
+  Module::registerModules();  // once for all schematics
+
+  Items.clear();
+  for (const QString& Input : schematics) {
+    Item New;
+    New.Input = Input;
+    Items.append(New);
+  }
+  if (!OutputDir.isEmpty()) QDir().mkpath(OutputDir);
+
+  Timer.start();
+  if (Simulate) {
+    Next = 0;
+    FreeSlots.clear();
+    for (int i = 0; i < Jobs; i++) FreeSlots.append(i);
+    QMetaObject::invokeMethod(this, &BatchRunner::startNext, Qt::QueuedConnection);
+    Loop.exec();
+  } else {
+    for (Item& It : Items) writeNetlist(It);
+  }
+
+  int Failed = 0;
+  for (const Item& It : Items)
+    if (!It.Passed) Failed++;
+  return Failed;
+}
+
+/*!
+   Returns the output file for "input" with the extension "ext". It is
+   placed into the output directory, or next to the schematic if none
+   is given.
+*/
+QString BatchRunner::outputName(const QString& input, const QString& ext) const
+{
+  QFileInfo Info(input);
+  QDir Dir(OutputDir.isEmpty() ? Info.absolutePath() : OutputDir);
+  return Dir.absoluteFilePath(Info.completeBaseName() + ext);
+}
+
+void BatchRunner::writeNetlist(Item& It)
+{
+  QElapsedTimer Total;
+  Total.start();
+  QScopedPointer<Schematic> Doc(openSchematic(It.Input));
+  It.LoadMs = Total.elapsed();
+  if (!Doc) {
+    It.Error = QStringLiteral("Could not load schematic");
+    It.TotalMs = Total.elapsed();
+    return;
+  }
+
+  It.Netlist = outputName(It.Input,
+                          Simulator == spicecompat::simQucsator ? ".net" : ".cir");
+  QFile::remove(It.Netlist);
+  switch (Simulator) {
+  case spicecompat::simNgspice:
+    Ngspice(Doc.get()).SaveNetlist(It.Netlist, false);
+    It.Passed = QFile::exists(It.Netlist);
+    break;
+  case spicecompat::simXyce:
+    Xyce(Doc.get()).SaveNetlist(It.Netlist, false);
+    It.Passed = QFile::exists(It.Netlist);
+    break;
+  default: {
+    QFile File(It.Netlist);
+    if (File.open(QIODevice::WriteOnly)) {
+      QTextStream Stream(&File);
+      It.Passed = writeQucsatorNetlist(Doc.get(), Stream);
+    }
+    break;
+  }
+  }
+  if (!It.Passed) It.Error = QStringLiteral("Could not write netlist");
+
+  It.TotalMs = Total.elapsed();
+  It.NetlistMs = It.TotalMs - It.LoadMs;
+  fprintf(stderr, "%s: %s\n", It.Input.toLocal8Bit().constData(),
+          It.Passed ? "passed" : It.Error.toLocal8Bit().constData());
+}
+
+/*!
+   Starts simulations while there are free slots. Quits the event loop
+   when all schematics are done.
+*/
+void BatchRunner::startNext()
+{
+  while (!FreeSlots.isEmpty() && Next < Items.size())
+    startSimulation(Next++, FreeSlots.takeFirst());
+  if (Kernels.isEmpty() && Next >= Items.size()) Loop.quit();
+}
+
+void BatchRunner::startSimulation(int index, int slot)
+{
+  Item& It = Items[index];
+  Running Job;
+  Job.Index = index;
+  Job.Slot = slot;
+  Job.Started.start();
+  Job.Doc = openSchematic(It.Input);
+  It.LoadMs = Job.Started.elapsed();
+  if (!Job.Doc) {
+    It.Error = QStringLiteral("Could not load schematic");
+    It.TotalMs = It.LoadMs;
+    FreeSlots.append(slot);
+    return;
+  }
+
+  AbstractSpiceKernel *Kernel;
+  if (Simulator == spicecompat::simXyce) {
+    Kernel = new Xyce(Job.Doc, this);
+    It.Dataset = outputName(It.Input, ".dat.xyce");
+  } else {
+    Kernel = new Ngspice(Job.Doc, this);
+    It.Dataset = outputName(It.Input, ".dat.ngspice");
+  }
+  It.Log = outputName(It.Input, ".log");
+  QFile::remove(It.Dataset);
+
+  // the simulations running at the same time must not share their files
+  Kernel->setWorkdir(QucsSettings.S4Qworkdir + QDir::separator()
+                     + QStringLiteral("batch%1").arg(slot));
+  Kernel->setUseResultCache(!Force);
+  connect(Kernel, &AbstractSpiceKernel::finished, this,
+          [this, Kernel]() { finishSimulation(Kernel, QString()); });
+  connect(Kernel, &AbstractSpiceKernel::errors, this,
+          [this, Kernel](QProcess::ProcessError err) {
+    if (err == QProcess::FailedToStart) {  // no finished() follows
+      finishSimulation(Kernel, QStringLiteral("Simulator did not start"));
+    } else if (Kernels.contains(Kernel)) {
+      Item& Failed = Items[Kernels.value(Kernel).Index];
+      if (Failed.Error.isEmpty())
+        Failed.Error = err == QProcess::Crashed ? QStringLiteral("Simulator crashed")
+                                                : QStringLiteral("Simulator error");
+    }
+  });
+
+  Kernels.insert(Kernel, Job);
+  Kernel->slotSimulate();  // writes the netlist and starts the simulator
+  if (It.NetlistMs < 0) It.NetlistMs = Job.Started.elapsed() - It.LoadMs;
+}
+
+void BatchRunner::finishSimulation(AbstractSpiceKernel *Kernel, const QString& error)
+{
+  auto Found = Kernels.find(Kernel);
+  if (Found == Kernels.end()) return;  // already done
+  Running Job = Found.value();
+  Kernels.erase(Found);
+  Kernel->disconnect(this);
+
+  Item& It = Items[Job.Index];
+  if (It.NetlistMs < 0) It.NetlistMs = Job.Started.elapsed() - It.LoadMs;
+  if (It.Error.isEmpty()) It.Error = error;
+  if (It.Error.isEmpty()) {
+    Kernel->convertToQucsData(It.Dataset);
+    if (!QFile::exists(It.Dataset))
+      It.Error = QStringLiteral("Could not write dataset");
+  }
+
+  QString Output = Kernel->getOutput();
+  QFile Log(It.Log);
+  if (Log.open(QIODevice::WriteOnly)) Log.write(Output.toUtf8());
+  if (It.Error.isEmpty() && ExternSimDialog::logContainsError(Output))
+    It.Error = QStringLiteral("Simulation errors, see log");
+
+  It.Passed = It.Error.isEmpty();
+  It.TotalMs = Job.Started.elapsed();
+  It.SimulateMs = It.TotalMs - It.LoadMs - It.NetlistMs;
+  fprintf(stderr, "%s: %s\n", It.Input.toLocal8Bit().constData(),
+          It.Passed ? "passed" : It.Error.toLocal8Bit().constData());
+
+  // the kernel is still emitting, the schematic goes with it
+  Schematic *Doc = Job.Doc;
+  connect(Kernel, &QObject::destroyed, this, [Doc]() { delete Doc; });
+  Kernel->deleteLater();
+
+  FreeSlots.append(Job.Slot);
+  QMetaObject::invokeMethod(this, &BatchRunner::startNext, Qt::QueuedConnection);
+}
+
+/*!
+   Returns the results as JSON, with the output files and timings of
+   every schematic.
+*/
+QJsonObject BatchRunner::summary() const
+{
+  QJsonArray Results;
+  int Failed = 0;
+  for (const Item& It : Items) {
+    QJsonObject Result;
+    Result["input"] = It.Input;
+    if (!It.Netlist.isEmpty()) Result["netlist"] = It.Netlist;
+    if (!It.Dataset.isEmpty()) Result["dataset"] = It.Dataset;
+    if (!It.Log.isEmpty()) Result["log"] = It.Log;
+    Result["status"] = It.Passed ? "passed" : "failed";
+    if (!It.Error.isEmpty()) Result["error"] = It.Error;
+    Result["load_ms"] = It.LoadMs;
+    Result["netlist_ms"] = It.NetlistMs;
+    if (Simulate) Result["simulation_ms"] = It.SimulateMs;
+    Result["total_ms"] = It.TotalMs;
+    Results.append(Result);
+    if (!It.Passed) Failed++;
+  }
+
+  QJsonObject Summary;
+  Summary["simulator"] = spicecompat::getDefaultSimulatorName(Simulator);
+  Summary["action"] = Simulate ? "simulate" : "netlist";
+  Summary["jobs"] = Simulate ? Jobs : 1;
+  Summary["total"] = Items.size();
+  Summary["passed"] = Items.size() - Failed;
+  Summary["failed"] = Failed;
+  Summary["wall_ms"] = Timer.isValid() ? Timer.elapsed() : 0;
+  Summary["results"] = Results;
+  return Summary;
+}
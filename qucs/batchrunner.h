@@ -0,0 +1,100 @@
+/***************************************************************************
+                               batchrunner.h
+                              ---------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+
+class AbstractSpiceKernel;
+class Schematic;
+
+/*!
+ * \file batchrunner.h
+ * \brief Netlisting and simulation of many schematics in one run.
+ *
+ * The schematics are loaded and netlisted one after the other, because
+ * a schematic is a widget and lives in the GUI thread. The simulators
+ * run as separate processes, so up to "jobs" of them run at the same
+ * time, each in its own working directory.
+ */
+class BatchRunner : public QObject {
+  Q_OBJECT
+
+public:
+  BatchRunner(int simulator, bool simulate, QObject *parent = nullptr);
+
+  static QStringList expandInputs(const QString& spec, QString& error);
+
+  void setOutputDir(const QString& dir) { OutputDir = dir; }
+  void setJobs(int jobs) { Jobs = qMax(1, jobs); }
+  void setForce(bool force) { Force = force; }
+
+  int run(const QStringList& schematics);
+  QJsonObject summary() const;
+
+private slots:
+  void startNext();
+
+private:
+  struct Item {
+    QString Input;
+    QString Netlist;
+    QString Dataset;
+    QString Log;
+    bool Passed = false;
+    QString Error;
+    qint64 LoadMs = -1;
+    qint64 NetlistMs = -1;
+    qint64 SimulateMs = -1;
+    qint64 TotalMs = -1;
+  };
+
+  // a simulation in progress
+  struct Running {
+    int Index;
+    int Slot;           // its working directory
+    Schematic *Doc;
+    QElapsedTimer Started;
+  };
+
+  QString outputName(const QString& input, const QString& ext) const;
+  void writeNetlist(Item&);
+  void startSimulation(int index, int slot);
+  void finishSimulation(AbstractSpiceKernel*, const QString& error);
+
+  int Simulator;
+  bool Simulate;
+  QString OutputDir;
+  int Jobs;
+  bool Force = false;
+
+  QList<Item> Items;
+  int Next = 0;
+  QHash<AbstractSpiceKernel*, Running> Kernels;
+  QList<int> FreeSlots;
+  QElapsedTimer Timer;
+  QEventLoop Loop;
+};
+
+#endif
@@ -28,11 +28,15 @@
 #include "module.h"
 #include "node.h"
 #include "misc.h"
+#include "schematictokenizer.h"
 
 #include <QPen>
 #include <QString>
 #include <QMessageBox>
 #include <QPainter>
+#include <QPicture>
+#include <QCache>
+#include <QHash>
 #include <QDebug>
 
 /*!
@@ -243,9 +247,26 @@ bool Component::getSelected(int x_, int y_) {
 void Component::paint(QPainter *p) {
     p->save();
     p->translate(cx, cy);
-
     drawSymbol(p);
+    paintDecorations(p);
+    p->restore();
+}
 
+// Same as paint(), but takes the symbol from a cache of rendered symbols
+// where possible. Only for the schematic view, printing and exporting
+// must stay vector graphics.
+void Component::paintCached(QPainter *p) {
+    p->save();
+    p->translate(cx, cy);
+    if (!drawCachedSymbol(p)) {
+        drawSymbol(p);
+    }
+    paintDecorations(p);
+    p->restore();
+}
+
+// Name, properties, the cross of inactive components and the selection box.
+void Component::paintDecorations(QPainter *p) {
     p->setPen(QPen(Qt::black, 1));
     QRect text_br{tx, ty, 0, 0};
 
@@ -275,8 +296,123 @@ void Component::paint(QPainter *p) {
         p->setPen(QPen(Qt::darkGray, 3));
         p->drawRoundedRect(x1, y1, x2 - x1, y2 - y1, 4, 4);
     }
+}
 
-    p->restore();
+namespace {
+
+size_t hashPen(const QPen& pen, size_t seed) {
+    return qHashMulti(seed, pen.color().rgba(), pen.widthF(), int(pen.style()),
+                      int(pen.capStyle()), int(pen.joinStyle()));
+}
+
+size_t hashBrush(const QBrush& brush, size_t seed) {
+    return qHashMulti(seed, brush.color().rgba(), int(brush.style()));
+}
+
+struct CachedSymbol {
+    QPixmap pixmap;
+    QRectF bounds;   // of the symbol, in component coordinates
+};
+
+// Least recently used symbols are dropped first. The cost is in bytes.
+QCache<QString, CachedSymbol> SymbolCache(64 * 1024 * 1024);
+
+constexpr int MaxSymbolPixels = 2048 * 2048;
+
+} // namespace
+
+size_t Component::symbolKey() const {
+    size_t key = qHashMulti(0, Lines.size(), Polylines.size(), Arcs.size(),
+                            Rects.size(), Ellipses.size(), Texts.size());
+    for (auto *l : Lines) {
+        key = hashPen(l->style, qHashMulti(key, l->x1, l->y1, l->x2, l->y2));
+    }
+    for (auto *pl : Polylines) {
+        for (const auto &pt : pl->points) {
+            key = qHashMulti(key, pt.x(), pt.y());
+        }
+        key = hashBrush(pl->brush, hashPen(pl->pen, key));
+    }
+    for (auto *a : Arcs) {
+        key = hashPen(a->style, qHashMulti(key, a->x, a->y, a->w, a->h, a->angle, a->arclen));
+    }
+    for (auto *r : Rects) {
+        key = hashBrush(r->Brush, hashPen(r->Pen, qHashMulti(key, r->x, r->y, r->w, r->h)));
+    }
+    for (auto *e : Ellipses) {
+        key = hashBrush(e->Brush, hashPen(e->Pen, qHashMulti(key, e->x, e->y, e->w, e->h)));
+    }
+    for (auto *t : Texts) {
+        key = qHashMulti(key, t->x, t->y, t->s, t->Color.rgba(), t->Size,
+                         t->mSin, t->mCos, t->over, t->under);
+    }
+    return key == 0 ? 1 : key;
+}
+
+// Draws the symbol as a pixmap rendered for the current zoom. The cache is
+// keyed by the look of the symbol, so all instances of a device share one
+// pixmap and a changed symbol simply gets a new one. Zoom levels are rounded
+// up to quarter octaves, so pixmaps are only ever scaled down a little.
+// Returns false if the symbol has to be drawn directly.
+bool Component::drawCachedSymbol(QPainter *p) {
+    const size_t key = symbolKey();
+    if (key == 0) {
+        return false;
+    }
+
+    const double scale = std::sqrt(std::abs(p->transform().determinant()))
+                         * p->device()->devicePixelRatioF();
+    if (scale <= 0.0) {
+        return false;
+    }
+    const int zoomStep = int(std::ceil(std::log2(scale) * 4.0));
+    const double pixmapScale = std::exp2(zoomStep / 4.0);
+
+    const bool correctSimulator = (Simulator & QucsSettings.DefaultSimulator) == QucsSettings.DefaultSimulator;
+    const size_t lookKey = correctSimulator
+        ? qHashMulti(key, qHash(p->font()))
+        : hashPen(WrongSimulatorPen, qHashMulti(key, qHash(p->font()), 1));
+    const QString name = QStringLiteral("%1:%2")
+        .arg(qulonglong(lookKey), 16, 16, QChar('0'))
+        .arg(zoomStep);
+
+    CachedSymbol *cached = SymbolCache.object(name);
+    if (!cached) {
+        // find the extent of the symbol by recording it once
+        QPicture picture;
+        QPainter recorder(&picture);
+        recorder.setFont(p->font());
+        drawSymbol(&recorder);
+        recorder.end();
+
+        QRectF bounds = QRectF(picture.boundingRect())
+            .united(QRectF(x1, y1, x2 - x1, y2 - y1))
+            .adjusted(-4, -4, 4, 4);
+        const QSize size(int(std::ceil(bounds.width() * pixmapScale)),
+                         int(std::ceil(bounds.height() * pixmapScale)));
+        if (size.isEmpty() || qint64(size.width()) * size.height() > MaxSymbolPixels) {
+            return false;
+        }
+
+        auto *symbol = new CachedSymbol{QPixmap(size), bounds};
+        symbol->pixmap.fill(Qt::transparent);
+        QPainter painter(&symbol->pixmap);
+        painter.setRenderHints(p->renderHints());
+        painter.setFont(p->font());
+        painter.scale(pixmapScale, pixmapScale);
+        painter.translate(-bounds.topLeft());
+        drawSymbol(&painter);
+        painter.end();
+
+        const int cost = size.width() * size.height() * 4;
+        if (!SymbolCache.insert(name, symbol, cost)) {
+            return false;   // larger than the whole cache, already deleted
+        }
+        cached = SymbolCache.object(name);
+    }
+
+    p->drawPixmap(cached->bounds, cached->pixmap, QRectF(cached->pixmap.rect()));
+    return true;
 }
 
 void Component::drawSymbol(QPainter* p) {
@@ -428,6 +564,7 @@ bool Component::rotate() noexcept {
     if ((Model != "Sub") && (Model != "VHDL") && (Model != "Verilog")
         && (Model != "SpLib")) // skip port count
         if (Ports.count() < 1) return false;  // do not rotate components without ports
+    markChanged();
     int tmp, dx, dy;
 
     // rotate all lines
@@ -541,6 +678,7 @@ bool Component::mirrorX() noexcept {
     if ((Model != "Sub") && (Model != "VHDL") && (Model != "Verilog")
         && (Model != "SpLib")) // skip port count
         if (Ports.count() < 1) return false;  // do not rotate components without ports
+    markChanged();
 
     // mirror all lines
     for (qucs::Line *p1: Lines) {
@@ -611,6 +749,7 @@ bool Component::mirrorY() noexcept {
     if ((Model != "Sub") && (Model != "VHDL") && (Model != "Verilog")
         && (Model != "SpLib")) // skip port count
         if (Ports.count() < 1) return false;  // do not rotate components without ports
+    markChanged();
 
     // mirror all lines
     for (qucs::Line *p1: Lines) {
@@ -931,18 +1070,14 @@ QString Component::save() {
 bool Component::load(const QString &_s) {
     bool ok;
     int ttx, tty, tmp;
-    QString s = _s;
-
-    if (s.at(0) != '<') return false;
-    if (s.at(s.length() - 1) != '>') return false;
-    s = s.mid(1, s.length() - 2);   // cut off start and end character
+    const SchematicTokenizer s(_s);   // fields are split only once
+    if (!s.isValid()) return false;
 
     QString n;
-    Name = s.section(' ', 1, 1);    // Name
+    Name = s.at(1).toString();    // Name
     if (Name == "*") Name = "";
 
-    n = s.section(' ', 2, 2);      // isActive
-    tmp = n.toInt(&ok);
+    tmp = s.at(2).toInt(&ok);     // isActive
     if (!ok) return false;
     isActive = tmp & 3;
 
@@ -951,30 +1086,24 @@ bool Component::load(const QString &_s) {
     else
         showName = true;
 
-    n = s.section(' ', 3, 3);    // cx
-    cx = n.toInt(&ok);
+    cx = s.at(3).toInt(&ok);      // cx
     if (!ok) return false;
 
-    n = s.section(' ', 4, 4);    // cy
-    cy = n.toInt(&ok);
+    cy = s.at(4).toInt(&ok);      // cy
     if (!ok) return false;
 
-    n = s.section(' ', 5, 5);    // tx
-    ttx = n.toInt(&ok);
+    ttx = s.at(5).toInt(&ok);     // tx
     if (!ok) return false;
 
-    n = s.section(' ', 6, 6);    // ty
-    tty = n.toInt(&ok);
+    tty = s.at(6).toInt(&ok);     // ty
     if (!ok) return false;
 
     if (Model.at(0) != '.') {  // is simulation component (dc, ac, ...) ?
 
-        n = s.section(' ', 7, 7);    // mirroredX
-        if (n.toInt(&ok) == 1) mirrorX();
+        if (s.at(7).toInt(&ok) == 1) mirrorX();    // mirroredX
         if (!ok) return false;
 
-        n = s.section(' ', 8, 8);    // rotated
-        tmp = n.toInt(&ok);
+        tmp = s.at(8).toInt(&ok);    // rotated
         if (!ok) return false;
         if (rotated > tmp)  // necessary because of historical flaw in ...
             tmp += 4;        // ... components like "volt_dc"
@@ -985,7 +1114,7 @@ bool Component::load(const QString &_s) {
     tx = ttx;
     ty = tty; // restore text position (was changed by rotate/mirror)
 
-    unsigned int counts = s.count('"');
+    unsigned int counts = 2 * s.quotedCount();   // number of '"'
     if (Model == "Sub")
         tmp = 2;   // first property (File) already exists
     else if (Model == "Lib")
@@ -1009,7 +1138,7 @@ bool Component::load(const QString &_s) {
     unsigned int z = 0;
     for (auto p1 = Props.begin(); p1 != Props.end(); ++p1) {
         z++;
-        n = s.section('"', z, z);    // property value
+        n = s.quoted(z / 2).toString();    // property value
         n.replace("\\n", "\n");
         n.replace("''", "\"");
         z++;
@@ -1096,8 +1225,7 @@ bool Component::load(const QString &_s) {
         }
         (*p1)->Value = n;
 
-        n = s.section('"', z, z);    // display
-        (*p1)->display = (n.at(1) == '1');
+        (*p1)->display = s.afterQuoted(z / 2 - 1).startsWith(u'1');   // display
     }
 
     return true;
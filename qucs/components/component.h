@@ -59,6 +59,7 @@ public:
   QString get_VHDL_Code(int);
   QString get_Verilog_Code(int);
   void    paint(QPainter* painter);
+  void    paintCached(QPainter* painter);   // for the screen, see drawCachedSymbol()
   void    paintScheme(Schematic*) override;
   int     textSize(int&, int&) const;
   void    Bounding(int&, int&, int&, int&);
@@ -132,6 +133,13 @@ protected:
   Schematic* containingSchematic;
 
   virtual void drawSymbol(QPainter* p);
+  // Identifies the look of the symbol drawn by drawSymbol(). Zero if
+  // the symbol must not be cached.
+  virtual size_t symbolKey() const;
+
+private:
+  void paintDecorations(QPainter* p);
+  bool drawCachedSymbol(QPainter* p);
 };
 
 
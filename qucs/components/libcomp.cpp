@@ -19,12 +19,17 @@
 #include "main.h"
 #include "misc.h"
 #include "node.h"
+#include "parsedsymbol.h"
 #include "extsimkernels/qucs2spice.h"
 #include "extsimkernels/spicecompat.h"
 
 
 #include <QTextStream>
+#include <QDateTime>
 #include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
 #include <QRegularExpression>
 #include <QDebug>
 
@@ -81,58 +86,111 @@ void LibComp::createSymbol()
   }
 }
 
+// ---------------------------------------------------------------------
+// Library files parsed into their components. All library components
+// share this cache, so a library file is read once and again only after
+// it changed on disk.
+namespace {
+
+struct LibFile {
+  QDateTime Modified;
+  qint64 Size = -1;
+  int Error = 0;                  // error of the file header, see loadSection()
+  VersionTriplet Version;
+  QString DefaultSymbol;
+  QHash<QString, QString> Components;   // name -> "<Component name>" block
+};
+
+QMutex LibFilesMutex;
+QHash<QString, LibFile> LibFiles;
+
+// Splits the library file "Content" into its components.
+void parseLibFile(const QString& Content, LibFile& Lib)
+{
+  if(Content.left(14) != "<Qucs Library ") {  // wrong file type ?
+    Lib.Error = -2;
+    return;
+  }
+  int Start, End = Content.indexOf(' ', 14);
+  if(End < 15) {
+    Lib.Error = -3;
+    return;
+  }
+  Lib.Version = VersionTriplet(Content.mid(14, End-14)); // extract version string
+
+  Start = Content.indexOf("\n<", 14); // library has default symbol
+  if(Start > 0)
+    if(Content.mid(Start+2, 14) == "DefaultSymbol>") {
+      Start += 16;
+      End = Content.indexOf("\n</DefaultSymbol>", Start);
+      if(End < 0)  Lib.Error = -9;
+      else  Lib.DefaultSymbol = Content.mid(Start, End-Start);
+    }
+
+  // the block of a component starts with its "<Component name>" line
+  Start = Content.indexOf("\n<Component ");
+  while(Start >= 0) {
+    int NameEnd = Content.indexOf('>', Start+12);
+    if(NameEnd < 0) break;
+    QString Name = Content.mid(Start+12, NameEnd-Start-12);
+    End = Content.indexOf("\n</Component>", Start+1);
+    if(!Lib.Components.contains(Name))  // the first one is used
+      Lib.Components.insert(Name, End < 0 ? QString() : Content.mid(Start+1, End-Start));
+    Start = Content.indexOf("\n<Component ", Start+1);
+  }
+}
+
+} // namespace
+
 // ---------------------------------------------------------------------
 // Loads the section with name "Name" from library file into "Section".
 int LibComp::loadSection(const QString& Name, QString& Section,
              QStringList *Includes, QStringList *Attach)
 {
   QDir Directory(QucsSettings.LibDir);
-  QFile file(misc::properAbsFileName(Directory.absoluteFilePath(Props.at(0)->Value + ".lib"), containingSchematic));
-  if(!file.open(QIODevice::ReadOnly))
+  QString FileName = misc::properAbsFileName(Directory.absoluteFilePath(Props.at(0)->Value + ".lib"), containingSchematic);
+  QFileInfo Info(FileName);
+  if(!Info.exists())
     return -1;
 
+  int Start, End;
   QString libDefaultSymbol;
+  {
+    QMutexLocker Lock(&LibFilesMutex);
+    auto Lib = LibFiles.find(FileName);
+    if(Lib == LibFiles.end() || Lib->Modified != Info.lastModified()
+       || Lib->Size != Info.size()) {
+      QFile file(FileName);
+      if(!file.open(QIODevice::ReadOnly))
+        return -1;
+      QTextStream ReadWhole(&file);
+      LibFile Parsed;
+      Parsed.Modified = Info.lastModified();
+      Parsed.Size = Info.size();
+      parseLibFile(ReadWhole.readAll(), Parsed);
+      file.close();
+      Lib = LibFiles.insert(FileName, Parsed);
+    }
 
-  QTextStream ReadWhole(&file);
-  Section = ReadWhole.readAll();
-  file.close();
-
-
-  if(Section.left(14) != "<Qucs Library ")  // wrong file type ?
-    return -2;
-
-  int Start, End = Section.indexOf(' ', 14);
-  if(End < 15) return -3;
-  QString Line = Section.mid(14, End-14); // extract version string
-  VersionTriplet LibVersion = VersionTriplet(Line);
-  if (LibVersion > QucsVersion) {// wrong version number ?
+    if(Lib->Error == -2 || Lib->Error == -3)
+      return Lib->Error;
+    if (Lib->Version > QucsVersion) {// wrong version number ?
       if (!QucsSettings.IgnoreFutureVersion) {
           return -3;
       }
-  }
+    }
+    if(Name == "Symbol") {
+      if(Lib->Error < 0)  return Lib->Error;
+      libDefaultSymbol = Lib->DefaultSymbol;
+    }
 
-  if(Name == "Symbol") {
-    Start = Section.indexOf("\n<", 14); // library has default symbol
-    if(Start > 0)
-      if(Section.mid(Start+2, 14) == "DefaultSymbol>") {
-        Start += 16;
-        End = Section.indexOf("\n</DefaultSymbol>", Start);
-        if(End < 0)  return -9;
-        libDefaultSymbol = Section.mid(Start, End-Start);
-      }
+    // search component
+    auto Comp = Lib->Components.constFind(Props.at(1)->Value);
+    if(Comp == Lib->Components.constEnd())  return -4;  // component not found
+    if(Comp->isNull())  return -6;  // file corrupt
+    Section = *Comp;
   }
 
-  // search component
-  Line = "\n<Component " + Props.at(1)->Value + ">";
-  Start = Section.indexOf(Line);
-  if(Start < 0)  return -4;  // component not found
-  Start = Section.indexOf('\n', Start);
-  if(Start < 0)  return -5;  // file corrupt
-  Start++;
-  End = Section.indexOf("\n</Component>", Start);
-  if(End < 0)  return -6;  // file corrupt
-  Section = Section.mid(Start, End-Start+1);
-  
   // search model includes
   if(Includes) {
     int StartI, EndI;
@@ -196,7 +254,7 @@ int LibComp::loadSection(const QString& Name, QString& Section,
 // returns the number of painting elements.
 int LibComp::loadSymbol()
 {
-  int z, Result;
+  int z;
   QString FileString, Line;
   z = loadSection("Symbol", FileString);
   if(z < 0) {
@@ -215,26 +273,17 @@ int LibComp::loadSymbol()
   }
 
 
-  z  = 0;
-  x1 = y1 = INT_MAX;
-  x2 = y2 = INT_MIN;
-
-  QTextStream stream(&FileString, QIODevice::ReadOnly);
-  while(!stream.atEnd()) {
-    Line = stream.readLine();
-    Line = Line.trimmed();
-    if(Line.isEmpty())  continue;
-    if(Line.at(0) != '<') return -11;
-    if(Line.at(Line.length()-1) != '>') return -12;
-    Line = Line.mid(1, Line.length()-2); // cut off start and end character
-    Result = analyseLine(Line, 2);
-    if(Result < 0) return -13;   // line format error
-    z += Result;
-  }
+  // all components with the same symbol share it parsed
+  std::shared_ptr<const ParsedSymbol> Symbol = ParsedSymbol::fromSection(FileString);
+  if(Symbol->Error < 0)  return Symbol->Error - 10;   // -11 ... -13: line format error
+
+  Symbol->copyTo(this);
+  for(const QString& IdLine : Symbol->IdLines)
+    if(analyseLine(IdLine, 2) < 0)  return -13;
 
   x1 -= 4;  x2 += 4;   // enlarge component boundings a little
   y1 -= 4;  y2 += 4;
-  return z;      // return number of ports
+  return Symbol->Count;      // return number of ports
 }
 
 // -------------------------------------------------------
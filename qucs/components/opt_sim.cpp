@@ -282,6 +282,7 @@ bool Optimize_Sim::loadASCOout()
             Props.at(i)->Value = val[0] + "|" + val[1] + "|" + val[2] + "|" +
 	      val[3] + "|" + val[4] + "|" + val[5];
 	    changed = true;
+	    markChanged();
 	    break;
 	  }
 	}
@@ -80,13 +80,18 @@ void Param_Sweep::recreate()
 }
 
 QString Param_Sweep::getNgspiceBeforeSim(QString sim, int lvl)
+{
+    return getNgspiceBeforeSim(sim, lvl, getNgspiceSweepValues());
+}
+
+// Sweep over the given values only, e.g. a part of the values of this sweep
+QString Param_Sweep::getNgspiceBeforeSim(QString sim, int lvl, const QStringList& values)
 {
     if (isActive != COMP_IS_ACTIVE) return QString();
 
-    QString s,unit;
+    QString s;
     QStringList parameter_list = getProperty("Param")->Value.split( this->param_split_str );
     QStringList::const_iterator constListIterator;
-    QString type = getProperty("Type")->Value;
     QString step_var = parameter_list.begin()->toLower();// use first element name as variable name
     step_var.remove(QRegularExpression("[\\.\\[\\]@:]"));
 
@@ -96,14 +101,53 @@ QString Param_Sweep::getNgspiceBeforeSim(QString sim, int lvl)
     else s += QStringLiteral("echo \"STEP %1.%2\" > spice4qucs.%3.cir.res%4\n").arg(sim).arg(step_var).arg(sim).arg(lvl);
 
     s += QStringLiteral("foreach  %1_act ").arg(step_var);
+    for (const QString& value : values) {
+        s += QStringLiteral("%1 ").arg(value);
+    }
+    s += "\n"; // newline after step listing
+    QString nline_char('\n');
+    for(constListIterator=parameter_list.begin(); constListIterator!=parameter_list.end();++constListIterator)
+    {
+        QString par = *constListIterator;
+        bool compfound = false;
+        bool temper_sweep = false;
+
+        Schematic *sch = getSchematic();
+        Component *pc = sch->getComponentByName(getProperty("Param")->Value);
+        if (pc != NULL) compfound = true;
+        else compfound = false;
+
+        if (step_var == "temp" || step_var == "temper") temper_sweep = true;
+
+        if (temper_sweep) { // Sweep temperature
+          s += QStringLiteral("option temp = $%1_act%2").arg(step_var).arg(nline_char);
+        } else if (compfound) { // Sweep device
+          s += QStringLiteral("alter %1 = $%2_act%3").arg(par).arg(step_var).arg(nline_char);
+        } else if (par.startsWith("@")) { // Sweep model
+          s += QStringLiteral("altermod %1 = $%2_act%3").arg(par).arg(step_var).arg(nline_char);
+        } else { // Sweep .PARAM variable
+          s += QStringLiteral("alterparam %1 = $%2_act%3reset%3").arg(par).arg(step_var).arg(nline_char);
+        }
+    }
+    return s;
+}
 
+/*!
+ * \brief Param_Sweep::getNgspiceSweepValues The values of the swept parameter
+ *        in the order they are simulated by the Ngspice "foreach" loop.
+ */
+QStringList Param_Sweep::getNgspiceSweepValues()
+{
+    QStringList values;
+    QString unit;
+    QString type = getProperty("Type")->Value;
     if((type == "list") || (type == "const")) {
         QString list_str = getProperty("Values")->Value;
         list_str.remove(0,1); // remove  [ ]
         list_str.chop(1);
         QStringList List = list_str.split(";");
         for(int i = 0; i < List.length(); i++) {
-            s += QStringLiteral("%1 ").arg(List[i]);
+            values.append(List[i]);
         }
     } else {
         double start,stop,step,fac,points,ostart,ostop;
@@ -120,7 +164,7 @@ QString Param_Sweep::getNgspiceBeforeSim(QString sim, int lvl)
         if(type == "lin") {
             step = (stop-start)/(points-1);
             while ( points > 0 ) {
-                s += QStringLiteral("%1 ").arg(start);
+                values.append(QString::number(start));
                 start += step;
                 points -= 1;
             }
@@ -130,38 +174,13 @@ QString Param_Sweep::getNgspiceBeforeSim(QString sim, int lvl)
             step = (stop - start)/(points - 1);
 
             while ( points > 0 ) {
-                s += QStringLiteral("%1 ").arg(pow(10, start));
+                values.append(QString::number(pow(10, start)));
                 start += step;
                 points -= 1;
             }
         }
     }
-    s += "\n"; // newline after step listing
-    QString nline_char('\n');
-    for(constListIterator=parameter_list.begin(); constListIterator!=parameter_list.end();++constListIterator)
-    {
-        QString par = *constListIterator;
-        bool compfound = false;
-        bool temper_sweep = false;
-
-        Schematic *sch = getSchematic();
-        Component *pc = sch->getComponentByName(getProperty("Param")->Value);
-        if (pc != NULL) compfound = true;
-        else compfound = false;
-
-        if (step_var == "temp" || step_var == "temper") temper_sweep = true;
-
-        if (temper_sweep) { // Sweep temperature
-          s += QStringLiteral("option temp = $%1_act%2").arg(step_var).arg(nline_char);
-        } else if (compfound) { // Sweep device
-          s += QStringLiteral("alter %1 = $%2_act%3").arg(par).arg(step_var).arg(nline_char);
-        } else if (par.startsWith("@")) { // Sweep model
-          s += QStringLiteral("altermod %1 = $%2_act%3").arg(par).arg(step_var).arg(nline_char);
-        } else { // Sweep .PARAM variable
-          s += QStringLiteral("alterparam %1 = $%2_act%3reset%3").arg(par).arg(step_var).arg(nline_char);
-        }
-    }
-    return s;
+    return values;
 }
 
 QString Param_Sweep::getNgspiceAfterSim(QString sim, int lvl)
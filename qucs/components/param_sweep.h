@@ -30,8 +30,10 @@ public:
   void recreate();
 
   QString getNgspiceBeforeSim(QString sim, int lvl=0);
+  QString getNgspiceBeforeSim(QString sim, int lvl, const QStringList& values);
   QString getNgspiceAfterSim(QString sim, int lvl=0);
   QString getCounterVar();
+  QStringList getNgspiceSweepValues();
 
 protected:
   QString spice_netlist(spicecompat::SpiceDialect dialect = spicecompat::SPICEDefault);
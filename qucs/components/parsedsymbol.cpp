@@ -0,0 +1,199 @@
+/***************************************************************************
+                              parsedsymbol.cpp
+                             ------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "parsedsymbol.h"
+#include "component.h"
+#include "main.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QTextStream>
+
+#include <climits>
+
+namespace {
+
+// Parses the symbol lines, as a subcircuit does for itself
+class SymbolParser : public Component {
+public:
+  using Component::analyseLine;
+};
+
+struct SchematicSymbol {
+  QDateTime Modified;
+  qint64 Size = -1;
+  QString Font;        // the size of texts depends on the application font
+  int Error = 0;
+  VersionTriplet Version;
+  std::shared_ptr<const ParsedSymbol> Symbol;
+};
+
+QMutex SymbolsMutex;
+QHash<QString, SchematicSymbol> SchematicSymbols;   // canonical path -> symbol
+QHash<QString, std::shared_ptr<const ParsedSymbol>> SectionSymbols;   // font + text -> symbol
+
+} // namespace
+
+// ---------------------------------------------------------------------
+// Parses the symbol lines "Rows". The primitives are taken over from a
+// component that has parsed the lines, so they come out exactly the same.
+std::shared_ptr<const ParsedSymbol> ParsedSymbol::parse(const QStringList& Rows)
+{
+  auto Symbol = std::make_shared<ParsedSymbol>();
+  SymbolParser Parser;
+  Parser.x1 = Parser.y1 = INT_MAX;
+  Parser.x2 = Parser.y2 = INT_MIN;
+
+  for(QString Row : Rows) {
+    Row = Row.trimmed();
+    if(Row.isEmpty())  continue;
+    if(Row.at(0) != '<') { Symbol->Error = WrongStart; break; }
+    if(Row.at(Row.length()-1) != '>') { Symbol->Error = WrongEnd; break; }
+    Row = Row.mid(1, Row.length()-2); // cut off start and end character
+
+    if(Row.section(' ', 0, 0) == ".ID") {
+      Symbol->IdLines.append(Row);
+      continue;
+    }
+    int Result = Parser.analyseLine(Row, 0);
+    if(Result < 0) { Symbol->Error = WrongLine; break; }
+    Symbol->Count += Result;
+  }
+
+  for(auto *p : Parser.Lines) { Symbol->Lines.append(*p); delete p; }
+  for(auto *p : Parser.Arcs) { Symbol->Arcs.append(*p); delete p; }
+  for(auto *p : Parser.Rects) { Symbol->Rects.append(*p); delete p; }
+  for(auto *p : Parser.Ellipses) { Symbol->Ellipses.append(*p); delete p; }
+  for(auto *p : Parser.Texts) { Symbol->Texts.append(*p); delete p; }
+  for(auto *p : Parser.Ports) { Symbol->Ports.append(*p); delete p; }
+  Parser.Lines.clear();
+  Parser.Arcs.clear();
+  Parser.Rects.clear();
+  Parser.Ellipses.clear();
+  Parser.Texts.clear();
+  Parser.Ports.clear();
+
+  Symbol->x1 = Parser.x1;
+  Symbol->y1 = Parser.y1;
+  Symbol->x2 = Parser.x2;
+  Symbol->y2 = Parser.y2;
+  return Symbol;
+}
+
+// ---------------------------------------------------------------------
+// Returns the symbol for the lines of a symbol section, e.g. of a library
+// component.
+std::shared_ptr<const ParsedSymbol> ParsedSymbol::fromSection(const QString& Section)
+{
+  const QString Key = QucsSettings.font.toString() + '\n' + Section;
+  QMutexLocker Lock(&SymbolsMutex);
+  auto Found = SectionSymbols.constFind(Key);
+  if(Found != SectionSymbols.constEnd())
+    return *Found;
+
+  auto Symbol = parse(Section.split('\n'));
+  SectionSymbols.insert(Key, Symbol);
+  return Symbol;
+}
+
+// ---------------------------------------------------------------------
+// Returns the symbol of the schematic file "DocName". The file is read
+// only if it is not yet known or has changed since.
+int ParsedSymbol::fromSchematic(const QString& DocName,
+                                std::shared_ptr<const ParsedSymbol>& Symbol,
+                                VersionTriplet& Version)
+{
+  QFileInfo Info(DocName);
+  const QString FileName = Info.canonicalFilePath();
+  if(FileName.isEmpty())
+    return -1;   // does not exist
+
+  QMutexLocker Lock(&SymbolsMutex);
+  auto Cached = SchematicSymbols.find(FileName);
+  if(Cached == SchematicSymbols.end() || Cached->Modified != Info.lastModified()
+     || Cached->Size != Info.size() || Cached->Font != QucsSettings.font.toString()) {
+    QFile file(FileName);
+    if(!file.open(QIODevice::ReadOnly))
+      return -1;
+
+    // To strongly speed up the file read operation the whole file is
+    // read into the memory in one piece.
+    QTextStream ReadWhole(&file);
+    QString FileString = ReadWhole.readAll();
+    file.close();
+    QTextStream stream(&FileString, QIODevice::ReadOnly);
+
+    SchematicSymbol Entry;
+    Entry.Modified = Info.lastModified();
+    Entry.Size = Info.size();
+    Entry.Font = QucsSettings.font.toString();
+
+    // read header **************************
+    QString Line;
+    do {
+      if(stream.atEnd()) { Entry.Error = -2; break; }
+      Line = stream.readLine().trimmed();
+    } while(Line.isEmpty());
+
+    if(Entry.Error == 0 && Line.left(16) != "<Qucs Schematic ") // wrong file type ?
+      Entry.Error = -3;
+
+    if(Entry.Error == 0) {
+      Entry.Version = VersionTriplet(Line.mid(16, Line.length() - 17));
+
+      // read content *************************
+      while(!stream.atEnd())
+        if(stream.readLine() == "<Symbol>") break;
+
+      QStringList Rows;
+      Entry.Error = -8;   // field not closed
+      while(!stream.atEnd()) {
+        Line = stream.readLine();
+        if(Line == "</Symbol>") {
+          Entry.Error = 0;
+          break;
+        }
+        Rows.append(Line);
+      }
+      if(Entry.Error == 0)
+        Entry.Symbol = parse(Rows);
+    }
+    Cached = SchematicSymbols.insert(FileName, Entry);
+  }
+
+  Symbol = Cached->Symbol;
+  Version = Cached->Version;
+  return Cached->Error;
+}
+
+// ---------------------------------------------------------------------
+// Gives the component its own copy of the symbol.
+void ParsedSymbol::copyTo(Component *c) const
+{
+  for(const auto& p : Lines)  c->Lines.append(new qucs::Line(p));
+  for(const auto& p : Arcs)  c->Arcs.append(new qucs::Arc(p));
+  for(const auto& p : Rects)  c->Rects.append(new qucs::Rect(p));
+  for(const auto& p : Ellipses)  c->Ellipses.append(new qucs::Ellips(p));
+  for(const auto& p : Texts)  c->Texts.append(new Text(p));
+  for(const auto& p : Ports)  c->Ports.append(new Port(p));
+
+  c->x1 = x1;
+  c->y1 = y1;
+  c->x2 = x2;
+  c->y2 = y2;
+}
@@ -0,0 +1,72 @@
+/***************************************************************************
+                               parsedsymbol.h
+                              ----------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef PARSEDSYMBOL_H
+#define PARSEDSYMBOL_H
+
+#include "element.h"
+#include "misc.h"
+
+#include <QList>
+#include <QStringList>
+
+#include <memory>
+
+class Component;
+
+/*!
+ * \file parsedsymbol.h
+ * \brief Symbol of a subcircuit or library component, parsed once and
+ *        shared by all components using it.
+ *
+ * The symbols are cached for the whole process. A symbol of a schematic
+ * file is parsed again only after the file changed on disk, a symbol of
+ * a library is cached by its text. The cached symbol never changes, the
+ * components get their own copies of the primitives, because rotating
+ * and mirroring changes them in place.
+ *
+ * The ".ID" lines are kept as text: they fill in the properties and the
+ * name of the component and must be applied to every component anew.
+ */
+class ParsedSymbol {
+public:
+  // errors of the symbol lines
+  enum { WrongStart = -1, WrongEnd = -2, WrongLine = -3 };
+
+  static std::shared_ptr<const ParsedSymbol> fromSection(const QString& Section);
+  // Returns 0 or the error of the file as Subcircuit::loadSymbol() does.
+  static int fromSchematic(const QString& DocName,
+                           std::shared_ptr<const ParsedSymbol>& Symbol,
+                           VersionTriplet& Version);
+
+  void copyTo(Component*) const;   // primitives, ports and boundings
+
+  int Error = 0;
+  int Count = 0;          // number of painting elements
+  QStringList IdLines;    // without "<" and ">"
+
+private:
+  static std::shared_ptr<const ParsedSymbol> parse(const QStringList& Rows);
+
+  QList<qucs::Line> Lines;
+  QList<qucs::Arc> Arcs;
+  QList<qucs::Rect> Rects;
+  QList<qucs::Ellips> Ellipses;
+  QList<Text> Texts;
+  QList<Port> Ports;
+  int x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+};
+
+#endif
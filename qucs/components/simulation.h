@@ -12,6 +12,8 @@ private:
 protected:
      void initSymbol(const QString& label);
      void drawSymbol(QPainter* p) override;
+     // The label is drawn with its own font, not from primitives
+     size_t symbolKey() const override { return 0; }
      // Override in your subclass if you want other color
      // for your simulation component
      virtual Qt::GlobalColor color() const { return Qt::darkBlue; }
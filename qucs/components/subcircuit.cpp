@@ -21,6 +21,7 @@
 #include "misc.h"
 #include "schematic.h"
 #include "node.h"
+#include "parsedsymbol.h"
 
 #include <QFileInfo>
 #include <QMutex>
@@ -132,74 +133,34 @@ void Subcircuit::remakeSymbol(int No) {
 
 // ---------------------------------------------------------------------
 // Loads the symbol for the subcircuit from the schematic file and
-// returns the number of painting elements.
+// returns the number of painting elements. The parsed symbol is shared
+// by all subcircuits, the file is read again only after it changed.
 int Subcircuit::loadSymbol(const QString &DocName) {
-  QFile file(DocName);
-  if (!file.open(QIODevice::ReadOnly))
-    return -1;
-
-  QString Line;
-  // *****************************************************************
-  // To strongly speed up the file read operation the whole file is
-  // read into the memory in one piece.
-  QTextStream ReadWhole(&file);
-  QString FileString = ReadWhole.readAll();
-  file.close();
-  QTextStream stream(&FileString, QIODevice::ReadOnly);
-
-  // read header **************************
-  do {
-    if (stream.atEnd())
-      return -2;
-    Line = stream.readLine();
-    Line = Line.trimmed();
-  } while (Line.isEmpty());
-
-  if (Line.left(16) != "<Qucs Schematic ") // wrong file type ?
-    return -3;
-
-  Line = Line.mid(16, Line.length() - 17);
-  VersionTriplet SymbolVersion = VersionTriplet(Line);
+  std::shared_ptr<const ParsedSymbol> Symbol;
+  VersionTriplet SymbolVersion;
+  int Error = ParsedSymbol::fromSchematic(DocName, Symbol, SymbolVersion);
+  if (Error < 0)
+    return Error;
+
   if (SymbolVersion > QucsVersion) { // wrong version number ?
     if (!QucsSettings.IgnoreFutureVersion) {
       return -4;
     }
   }
 
-  // read content *************************
-  while (!stream.atEnd()) {
-    Line = stream.readLine();
-    if (Line == "<Symbol>")
-      break;
-  }
-
-  x1 = y1 = INT_MAX;
-  x2 = y2 = INT_MIN;
-
-  int z = 0, Result;
-  while (!stream.atEnd()) {
-    Line = stream.readLine();
-    if (Line == "</Symbol>") {
-      x1 -= 4; // enlarge component boundings a little
-      x2 += 4;
-      y1 -= 4;
-      y2 += 4;
-      return z; // return number of ports
-    }
+  if (Symbol->Error < 0)
+    return Symbol->Error - 4; // -5 ... -7: line format error
 
-    Line = Line.trimmed();
-    if (Line.at(0) != '<')
-      return -5;
-    if (Line.at(Line.length() - 1) != '>')
-      return -6;
-    Line = Line.mid(1, Line.length() - 2); // cut off start and end character
-    Result = analyseLine(Line, 1);
-    if (Result < 0)
-      return -7; // line format error
-    z += Result;
-  }
+  Symbol->copyTo(this);
+  for (const QString &Line : Symbol->IdLines)
+    if (analyseLine(Line, 1) < 0)
+      return -7;
 
-  return -8; // field not closed
+  x1 -= 4; // enlarge component boundings a little
+  x2 += 4;
+  y1 -= 4;
+  y2 += 4;
+  return Symbol->Count; // return number of ports
 }
 
 // -------------------------------------------------------
@@ -12,6 +12,10 @@ class WireLabel;
 class Conductor : public Element {
 public:
   WireLabel *Label;
+
+  // Every change of the label goes through here, the label is saved with
+  // its owner. The old label is not deleted.
+  void setLabel(WireLabel *pl) noexcept { Label = pl; markChanged(); }
 };
 
 #endif
\ No newline at end of file
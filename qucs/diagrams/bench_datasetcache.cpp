@@ -0,0 +1,150 @@
+/***************************************************************************
+                           bench_datasetcache.cpp
+                          ------------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*
+  Measures how fast DataSetCache loads a text dataset.
+
+  Without a file argument a complex AC dataset (one frequency sweep,
+  several S-parameters, 50 MB by default) is written into a temporary
+  directory. The dataset is then loaded several times through the cache,
+  which is cleared in between, and every variable is parsed:
+
+    scan   DataSetCache::dataSet(), reading the file and building the
+           directory of the variables
+    parse  DataSet::variable() of all variables, converting the values
+
+  The best run is printed. Build the "bench_datasetcache" target, it is
+  not part of the default build.
+
+    bench_datasetcache [-s MEGABYTES] [-r REPEAT] [DATASET]
+*/
+
+#include "datasetcache.h"
+#include "main.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// datasetcache.cpp takes its memory budget from the settings
+tQucsSettings QucsSettings;
+
+static bool writeDataSet(const QString& Path, double MegaBytes)
+{
+  QFile File(Path);
+  if (!File.open(QIODevice::WriteOnly)) return false;
+
+  QRandomGenerator Random(1);
+  const int Variables = 8;
+  const int Points = int(MegaBytes * 1e6 / (Variables * 28));
+  char Line[64];
+
+  File.write("<Qucs Dataset 25.1.2>\n");
+  File.write(QByteArray("<indep frequency ") + QByteArray::number(Points) + ">\n");
+  for (int i = 0; i < Points; i++) {
+    std::snprintf(Line, sizeof(Line), "  %+.12e\n", 1e6 + i * 1e3);
+    File.write(Line);
+  }
+  File.write("</indep>\n");
+  for (int k = 0; k < Variables; k++) {
+    std::snprintf(Line, sizeof(Line), "<dep S[%d,%d] frequency>\n", k/4 + 1, k%4 + 1);
+    File.write(Line);
+    for (int i = 0; i < Points; i++) {
+      double Re = Random.generateDouble()*2.0 - 1.0;
+      double Im = Random.generateDouble();
+      std::snprintf(Line, sizeof(Line), "  %+.6e%cj%.6e\n",
+                    Re, Random.bounded(2) ? '+' : '-', Im);
+      File.write(Line);
+    }
+    File.write("</dep>\n");
+  }
+  return File.error() == QFileDevice::NoError;
+}
+
+int main(int argc, char** argv)
+{
+  double MegaBytes = 50.0;
+  int Repeat = 3;
+  QString Path;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "-s") == 0 && i+1 < argc)
+      MegaBytes = std::atof(argv[++i]);
+    else if (std::strcmp(argv[i], "-r") == 0 && i+1 < argc)
+      Repeat = std::max(1, std::atoi(argv[++i]));
+    else if (argv[i][0] != '-')
+      Path = QString::fromLocal8Bit(argv[i]);
+    else {
+      std::fprintf(stderr, "usage: %s [-s MEGABYTES] [-r REPEAT] [DATASET]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  QucsSettings.DataSetCacheSize = 4096;
+
+  QTemporaryDir Dir;
+  if (Path.isEmpty()) {
+    if (!Dir.isValid()) return 1;
+    Path = Dir.filePath("ac.dat");
+    if (!writeDataSet(Path, MegaBytes)) {
+      std::fprintf(stderr, "cannot write %s\n", qPrintable(Path));
+      return 1;
+    }
+  }
+  const double Size = QFileInfo(Path).size() / 1e6;
+
+  qint64 bestScan = -1, bestParse = -1;
+  size_t Values = 0;
+  for (int r = 0; r < Repeat; r++) {
+    DataSetCache::instance().clear();
+
+    QElapsedTimer Timer;
+    Timer.start();
+    DataSetPtr ds = DataSetCache::instance().dataSet(Path);
+    qint64 Scan = Timer.nsecsElapsed();
+    if (!ds) {
+      std::fprintf(stderr, "cannot load %s\n", qPrintable(Path));
+      return 1;
+    }
+
+    Timer.restart();
+    Values = 0;
+    for (const DataSetVarInfo& Info : ds->directory()) {
+      DataSetVarPtr pv = ds->variable(Info.Name);
+      if (!pv) {
+        std::fprintf(stderr, "cannot parse %s\n", qPrintable(Info.Name));
+        return 1;
+      }
+      Values += size_t(pv->count);
+    }
+    qint64 Parse = Timer.nsecsElapsed();
+
+    if (bestScan < 0 || Scan < bestScan) bestScan = Scan;
+    if (bestParse < 0 || Parse < bestParse) bestParse = Parse;
+  }
+
+  std::printf("dataset  %.1f MB, %zu values\n", Size, Values);
+  std::printf("scan     %8.1f ms  %8.1f MB/s\n", bestScan / 1e6, Size / (bestScan / 1e9));
+  std::printf("parse    %8.1f ms  %8.1f MB/s\n", bestParse / 1e6, Size / (bestParse / 1e9));
+  std::printf("total    %8.1f ms  %8.1f MB/s\n", (bestScan + bestParse) / 1e6,
+              Size / ((bestScan + bestParse) / 1e9));
+  return 0;
+}
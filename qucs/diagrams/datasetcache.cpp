@@ -0,0 +1,542 @@
+/***************************************************************************
+                             datasetcache.cpp
+                            ------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*!
+  \class DataSetCache
+  \brief Parses Qucs dataset files once and shares the values.
+
+  Before this cache existed, every Graph read and scanned the whole dataset
+  file by itself. Now a dataset is indexed in one pass (variable name ->
+  dependencies, byte range, number of values), every variable is parsed
+  once when it is first needed and all graphs use the arrays read-only.
+*/
+
+#include "datasetcache.h"
+#include "qdbfile.h"
+#include "main.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QtEndian>
+#include <QDebug>
+
+#include <charconv>
+#include <climits>
+#include <clocale>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+const double* DataSetVar::data() const
+{
+  if (isDigital) return reinterpret_cast<const double*>(Digital.constData());
+  if (Mapped) return Mapped;
+  return Values.data();
+}
+
+size_t DataSetVar::bytes() const
+{
+  size_t Size = sizeof(DataSetVar) + Values.capacity() * sizeof(double) + Digital.size();
+  if (Mapped) Size += (isIndep ? 1 : 2) * size_t(count) * sizeof(double);
+  return Size;
+}
+
+// ---------------------------------------------------------------------
+// skip blanks, returns pointer to first non-white character
+static inline const char* skipWhite(const char* p, const char* End)
+{
+  while (p < End && *p <= ' ') p++;
+  return p;
+}
+
+// ---------------------------------------------------------------------
+// Converts one real number, e.g. "+1.5e-03", and returns the position
+// behind it or nullptr. Unlike strtod(), from_chars() does not depend on
+// the locale, but it does not accept a leading '+'.
+static inline const char* parseReal(const char* p, const char* End, double& x)
+{
+  if (p < End && *p == '+') p++;
+  auto Result = std::from_chars(p, End, x);
+  if (Result.ec == std::errc()) return Result.ptr;
+  if (Result.ec != std::errc::result_out_of_range) return nullptr;
+
+  // rare: let strtod() clamp values beyond the range of double
+  std::string Number(p, Result.ptr);
+  x = strtod(Number.c_str(), nullptr);
+  return Result.ptr;
+}
+
+// ---------------------------------------------------------------------
+static inline bool isCancelled(const std::atomic_bool* Cancel)
+{
+  return Cancel && Cancel->load(std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------------------
+// Reads the values of one variable up to the closing tag. Returns the
+// position behind the values or nullptr if the data is corrupt or
+// "Cancel" was set. The buffer is not modified, complex numbers read
+// e.g. "1.0+j2.0".
+static const char* parseValues(const char* p, const char* End, DataSetVar* pv,
+                               const std::atomic_bool* Cancel)
+{
+  if (pv->isDigital) {
+    for (p = skipWhite(p, End); p < End && *p != '<'; p = skipWhite(p, End)) {
+      if ((pv->count & 0xFFFF) == 0 && isCancelled(Cancel)) return nullptr;
+      const char* Start = p;
+      while (p < End && *p > ' ' && *p != '<') p++;
+      pv->Digital.append(Start, p - Start);
+      pv->Digital.append('\0');
+      pv->count++;
+    }
+    return p;
+  }
+
+  for (p = skipWhite(p, End); p < End && *p != '<'; p = skipWhite(p, End)) {
+    if ((pv->count & 0xFFFF) == 0 && isCancelled(Cancel)) return nullptr;
+    double x, y = 0.0;
+    p = parseReal(p, End, x);   // real part
+    if (!p) return nullptr;
+
+    if (End - p > 1 && (*p == '+' || *p == '-') && *(p + 1) == 'j') {
+      bool Negative = (*p == '-');   // imaginary part
+      p = parseReal(p + 2, End, y);
+      if (!p) return nullptr;
+      if (Negative) y = -y;
+    }
+    if (p < End && *p > ' ' && *p != '<') return nullptr;
+
+    pv->Values.push_back(x);
+    if (!pv->isIndep)       // complex number on x-axis has no sense
+      pv->Values.push_back(y);
+    pv->count++;
+  }
+  return p;
+}
+
+// ---------------------------------------------------------------------
+/*!
+   Determines the range of the finite values of "count" interleaved
+   complex numbers, i.e. their magnitude, or the real part itself for real
+   numbers. Returns false if there is no finite value. The loop has no
+   branches, so that the compiler can vectorize it.
+*/
+bool magnitudeRange(const double* ReIm, int count, double& Min, double& Max)
+{
+  double lo = INFINITY, hi = -INFINITY;
+  for (int z = 0; z < count; z++) {
+    double x = ReIm[2 * z];
+    double y = ReIm[2 * z + 1];
+    double m = (std::fabs(y) >= 1e-250) ? std::sqrt(x * x + y * y) : x;
+    bool Finite = (m - m == 0.0);   // false for inf and nan
+    lo = (Finite && m < lo) ? m : lo;
+    hi = (Finite && m > hi) ? m : hi;
+  }
+  Min = lo;
+  Max = hi;
+  return lo <= hi;
+}
+
+// ---------------------------------------------------------------------
+/*!
+   Builds the variable directory in one pass over the file. No value is
+   converted here, see DataSet::variable().
+*/
+DataSetPtr DataSet::scan(const QByteArray& Content, const std::atomic_bool* Cancel)
+{
+  auto ds = std::make_shared<DataSet>();
+  const char* Begin = Content.constData();
+  const char* End = Begin + Content.size();
+  const char* p = Begin;
+
+  // a truncated file is not used at all
+  if (Content.isEmpty()) return ds;
+  if (*(End - 1) > ' ' && *(End - 1) != '>') return ds;
+  ds->Content = Content;
+
+  while ((p = static_cast<const char*>(memchr(p, '<', End - p)))) {
+    if (isCancelled(Cancel)) return nullptr;
+    const char* TagEnd = static_cast<const char*>(memchr(p, '>', End - p));
+    if (!TagEnd) break;   // file corrupt
+
+    bool isIndep = (strncmp(p, "<indep ", 7) == 0);
+    if (!isIndep && strncmp(p, "<dep ", 5) != 0) {   // header or closing tag
+      p = TagEnd + 1;
+      continue;
+    }
+
+    QStringList Header =
+      QString::fromLatin1(p + 1, TagEnd - p - 1).split(' ', Qt::SkipEmptyParts);
+    p = TagEnd + 1;
+    if (Header.size() < 2) continue;
+
+    DataSetVarInfo Info;
+    Info.Name = Header.at(1);
+    Info.isIndep = isIndep;
+    if (isIndep) {
+      bool ok = false;
+      Info.count = (Header.size() > 2) ? Header.at(2).toInt(&ok) : 0;
+      if (!ok || Info.count < 0) Info.count = 0;
+    } else {
+      Info.Deps = Header.mid(2);
+      Info.count = 1;
+      for (const QString& Dep : Info.Deps) {
+        const DataSetVarInfo* pDep = ds->info(Dep);
+        if (!pDep || !pDep->isIndep) {
+          Info.count = -1;
+          break;
+        }
+        Info.count *= pDep->count;
+      }
+    }
+
+    // the values reach up to the closing tag
+    Info.Begin = p - Begin;
+    p = static_cast<const char*>(memchr(p, '<', End - p));
+    if (!p) p = End;
+    Info.End = p - Begin;
+
+    ds->Index.insert(Info.Name, ds->Directory.size());
+    ds->Directory.append(Info);
+  }
+
+  return ds;
+}
+
+// ---------------------------------------------------------------------
+/*!
+   Converts the values of one variable of a text dataset. Returns nullptr
+   if the values are corrupt, so the graphs using them show no data.
+*/
+DataSetVarPtr DataSet::parseVariable(const DataSetVarInfo& Info,
+                                     const std::atomic_bool* Cancel) const
+{
+  /* WORK-AROUND: A bug in SCIM (libscim) which Qt is linked to causes
+     to change the locale to the default. Only needed for the strtod()
+     fallback of parseReal(). */
+  setlocale(LC_NUMERIC, "C");
+
+  auto pv = std::make_shared<DataSetVar>();
+  pv->Name = Info.Name;
+  pv->isIndep = Info.isIndep;
+  pv->isDigital = Info.Name.endsWith(".X");
+  pv->Deps = Info.Deps;
+  if (Info.count > 0 && !pv->isDigital)
+    pv->Values.reserve(Info.isIndep ? Info.count : 2 * size_t(Info.count));
+
+  const char* Begin = Content.constData();
+  if (!parseValues(Begin + Info.Begin, Begin + Info.End, pv.get(), Cancel)) {
+    if (isCancelled(Cancel)) return nullptr;
+    qDebug() << "DataSet: corrupt data of" << Info.Name;
+    return nullptr;
+  }
+
+  if (Info.isIndep) {
+    if (pv->count < Info.count) {
+      qDebug() << "DataSet: missing values of" << Info.Name;
+      return nullptr;
+    }
+    pv->count = Info.count;   // surplus values are ignored
+    pv->Values.resize(Info.count);
+  }
+  pv->Values.shrink_to_fit();
+
+  // second pass while the values are still in the cache
+  if (!pv->isIndep && !pv->isDigital)
+    pv->hasRange = magnitudeRange(pv->Values.data(), pv->count, pv->Min, pv->Max);
+  return pv;
+}
+
+/*!
+   Returns the values of variable "Name". They are parsed on first use and
+   shared afterwards.
+*/
+DataSetVarPtr DataSet::variable(const QString& Name, const std::atomic_bool* Cancel) const
+{
+  {
+    QMutexLocker Locker(&Mutex);
+    auto it = Vars.constFind(Name);
+    if (it != Vars.constEnd()) return it.value();
+  }
+
+  const DataSetVarInfo* Info = info(Name);
+  if (!Info || Content.isEmpty()) return nullptr;
+
+  // Parse without lock, so that other variables can be parsed concurrently.
+  DataSetVarPtr pv = parseVariable(*Info, Cancel);
+  if (!pv && isCancelled(Cancel)) return nullptr;   // not corrupt, parse again
+
+  QMutexLocker Locker(&Mutex);
+  auto it = Vars.constFind(Name);
+  if (it != Vars.constEnd()) return it.value();   // parsed meanwhile
+  Vars.insert(Name, pv);   // also remember corrupt variables
+  if (pv) Size += pv->bytes();
+  return pv;
+}
+
+const DataSetVarInfo* DataSet::info(const QString& Name) const
+{
+  auto it = Index.constFind(Name);
+  if (it == Index.constEnd()) return nullptr;
+  return &Directory.at(it.value());
+}
+
+size_t DataSet::bytes() const
+{
+  QMutexLocker Locker(&Mutex);
+  return sizeof(DataSet) + Content.size() + Size;
+}
+
+// ---------------------------------------------------------------------
+namespace {
+
+// A read-only .qdb file in memory. On Windows a mapped file could not be
+// replaced by the next simulation, so it is read into memory there.
+class MappedFile {
+public:
+  explicit MappedFile(const QString& fileName) : File(fileName) {
+    if (!File.open(QIODevice::ReadOnly)) return;
+    Size = File.size();
+#ifdef Q_OS_WIN
+    Buffer.resize((Size + 7) / sizeof(double));
+    if (File.read(reinterpret_cast<char*>(Buffer.data()), Size) == Size)
+      Base = reinterpret_cast<const uchar*>(Buffer.data());
+    File.close();
+#else
+    Base = File.map(0, Size);
+#endif
+  }
+
+  const uchar* Base = nullptr;
+  qint64 Size = 0;
+
+private:
+  QFile File;    // unmaps on destruction
+  std::vector<double> Buffer;
+};
+
+// Bounds-checked reading of the .qdb directory.
+struct Reader {
+  const uchar* p;
+  const uchar* End;
+  bool ok = true;
+
+  quint32 u32() {
+    if (End - p < 4) { ok = false; return 0; }
+    quint32 v = qFromLittleEndian<quint32>(p);
+    p += 4;
+    return v;
+  }
+  quint64 u64() {
+    if (End - p < 8) { ok = false; return 0; }
+    quint64 v = qFromLittleEndian<quint64>(p);
+    p += 8;
+    return v;
+  }
+  QString string() {
+    quint32 n = u32();
+    if (!ok || quint64(End - p) < n) { ok = false; return QString(); }
+    QString s = QString::fromUtf8(reinterpret_cast<const char*>(p), n);
+    p += n;
+    return s;
+  }
+};
+
+} // namespace
+
+/*!
+   Uses the values of a binary dataset (.qdb) in place, nothing is parsed
+   or copied. Returns nullptr if the file is not a valid .qdb file.
+*/
+DataSetPtr DataSet::map(const QString& qdbFile)
+{
+  if (!qdb::isSupported()) return nullptr;
+
+  auto Mapping = std::make_shared<MappedFile>(qdbFile);
+  if (!Mapping->Base || Mapping->Size < qint64(sizeof(qdb::Magic)) + 8)
+    return nullptr;
+  if (memcmp(Mapping->Base, qdb::Magic, sizeof(qdb::Magic)) != 0)
+    return nullptr;
+
+  Reader r{Mapping->Base + sizeof(qdb::Magic), Mapping->Base + Mapping->Size};
+  if (r.u32() != qdb::Version) return nullptr;
+  quint32 NumVars = r.u32();
+
+  auto ds = std::make_shared<DataSet>();
+  quint64 FileSize = Mapping->Size;
+  for (quint32 i = 0; i < NumVars && r.ok; i++) {
+    auto pv = std::make_shared<DataSetVar>();
+    quint32 Flags = r.u32();
+    quint64 Count = r.u64();
+    quint64 Offset = r.u64();
+    pv->Name = r.string();
+    quint32 NumDeps = r.u32();
+    for (quint32 k = 0; k < NumDeps && r.ok; k++)
+      pv->Deps.append(r.string());
+    if (!r.ok) return nullptr;
+
+    pv->isIndep = (Flags & qdb::Indep);
+    quint64 Doubles = pv->isIndep ? Count : 2 * Count;
+    if ((Offset % sizeof(double)) != 0 || Offset > FileSize ||
+        Count > quint64(INT_MAX) || Doubles > (FileSize - Offset) / sizeof(double))
+      return nullptr;   // file corrupt
+
+    pv->count = int(Count);
+    pv->Mapped = reinterpret_cast<const double*>(Mapping->Base + Offset);
+    pv->Mapping = Mapping;
+    ds->Size += pv->bytes();
+    ds->Vars.insert(pv->Name, pv);
+
+    DataSetVarInfo Info;
+    Info.Name = pv->Name;
+    Info.isIndep = pv->isIndep;
+    Info.Deps = pv->Deps;
+    Info.Begin = Offset;
+    Info.End = Offset + Doubles * sizeof(double);
+    Info.count = pv->count;
+    ds->Index.insert(Info.Name, ds->Directory.size());
+    ds->Directory.append(Info);
+  }
+  if (!r.ok) return nullptr;
+
+  return ds;
+}
+
+// ---------------------------------------------------------------------
+DataSetCache& DataSetCache::instance()
+{
+  static DataSetCache Cache;
+  return Cache;
+}
+
+/*!
+   Returns the parsed dataset of "fileName". The file is only read if it
+   is not cached yet or if it was modified since it was parsed.
+*/
+DataSetPtr DataSetCache::dataSet(const QString& fileName, const std::atomic_bool* Cancel)
+{
+  QFileInfo Info(fileName);
+  if (!Info.exists()) return nullptr;
+
+  // prefer the binary sidecar, if it was written with this dataset
+  bool isBinary = false;
+  if (qdb::isSupported()) {
+    QFileInfo Sidecar(qdb::sidecarName(fileName));
+    if (Sidecar.exists() && Sidecar.lastModified() >= Info.lastModified()) {
+      Info = Sidecar;
+      isBinary = true;
+    }
+  }
+
+  QString Path = Info.canonicalFilePath();
+  qint64 Modified = Info.lastModified().toMSecsSinceEpoch();
+  qint64 FileSize = Info.size();
+
+  const QString LoadPath = Path;
+  {
+    QMutexLocker Locker(&Mutex);
+    for (;;) {
+      for (auto it = Entries.begin(); it != Entries.end(); ++it) {
+        if (it->Path != Path) continue;
+        if (it->lastModified == Modified && it->fileSize == FileSize) {
+          Entries.splice(Entries.begin(), Entries, it);   // most recently used
+          return it->Data;
+        }
+        Entries.erase(it);   // stale
+        break;
+      }
+      // graphs loaded concurrently wait for the first one to parse the file
+      if (!Loading.contains(LoadPath)) break;
+      Loaded.wait(&Mutex);
+    }
+    Loading.insert(LoadPath);
+  }
+
+  // Parse outside of the lock, so that other datasets remain accessible.
+  DataSetPtr ds;
+  if (isBinary) {
+    ds = DataSet::map(Path);
+    if (!ds) {   // corrupt sidecar, use the text dataset
+      qDebug() << "DataSetCache: invalid" << Path;
+      Info.setFile(fileName);
+      Path = Info.canonicalFilePath();
+      Modified = Info.lastModified().toMSecsSinceEpoch();
+      FileSize = Info.size();
+    }
+  }
+  if (!ds) {
+    QFile file(Path);
+    if (file.open(QIODevice::ReadOnly)) {
+      ds = DataSet::scan(file.readAll(), Cancel);
+      file.close();
+    }
+  }
+
+  QMutexLocker Locker(&Mutex);
+  Loading.remove(LoadPath);
+  Loaded.wakeAll();
+  if (!ds) return nullptr;
+
+  qDebug() << "DataSetCache: loaded" << Path << ds->bytes() << "bytes";
+  for (auto it = Entries.begin(); it != Entries.end(); ++it) {
+    if (it->Path == Path) {   // loaded concurrently meanwhile
+      Entries.erase(it);
+      break;
+    }
+  }
+  Entries.push_front(Entry{Path, Modified, FileSize, ds});
+  evict();
+  return ds;
+}
+
+// ---------------------------------------------------------------------
+void DataSetCache::remove(const QString& fileName)
+{
+  QStringList Paths;
+  Paths << QFileInfo(fileName).canonicalFilePath()
+        << QFileInfo(qdb::sidecarName(fileName)).canonicalFilePath();
+  QMutexLocker Locker(&Mutex);
+  for (auto it = Entries.begin(); it != Entries.end();) {
+    if (Paths.contains(it->Path)) {
+      it = Entries.erase(it);
+    }
+    else ++it;
+  }
+}
+
+// ---------------------------------------------------------------------
+void DataSetCache::clear()
+{
+  QMutexLocker Locker(&Mutex);
+  Entries.clear();
+}
+
+// ---------------------------------------------------------------------
+// Drops the least recently used datasets until the budget is met. The
+// most recent dataset is always kept. Must be called with "Mutex" locked.
+// The sizes are summed up each time, as variables are parsed on demand.
+void DataSetCache::evict()
+{
+  size_t Budget = size_t(QucsSettings.DataSetCacheSize) * 1024 * 1024;
+  size_t Size = 0;
+  for (const Entry& e : Entries)
+    Size += e.Data->bytes();
+  while (Size > Budget && Entries.size() > 1) {
+    Size -= Entries.back().Data->bytes();
+    Entries.pop_back();
+  }
+}
@@ -0,0 +1,148 @@
+/***************************************************************************
+                              datasetcache.h
+                             ----------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef DATASETCACHE_H
+#define DATASETCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <vector>
+
+/*!
+ * One variable of a parsed Qucs dataset. Instances are immutable once they
+ * have been published by DataSetCache and are shared read-only between all
+ * graphs that plot them.
+ */
+struct DataSetVar {
+  QString Name;
+  bool isIndep = false;
+  bool isDigital = false;   // e.g. "stdl[8:0].X", values are bit vectors
+  QStringList Deps;         // independent variables (empty for "indep")
+  int count = 0;            // number of values
+
+  // "indep": count real values, "dep": 2*count interleaved real/imag values
+  std::vector<double> Values;
+  // the same, but located in a mapped .qdb file (then "Values" is empty)
+  const double* Mapped = nullptr;
+  std::shared_ptr<const void> Mapping;
+  // digital "dep": count zero-terminated bit vectors
+  QByteArray Digital;
+  // magnitude range of a parsed "dep" (see magnitudeRange())
+  bool hasRange = false;
+  double Min = 0.0, Max = 0.0;
+
+  const double* data() const;
+  size_t bytes() const;
+};
+
+typedef std::shared_ptr<const DataSetVar> DataSetVarPtr;
+
+bool magnitudeRange(const double* ReIm, int count, double& Min, double& Max);
+
+/*!
+ * Directory entry of one dataset variable. The directory is built in a
+ * single pass over the file without converting any values.
+ */
+struct DataSetVarInfo {
+  QString Name;
+  bool isIndep = false;
+  QStringList Deps;          // independent variables (empty for "indep")
+  qint64 Begin = 0;          // byte range of the values in the file
+  qint64 End = 0;
+  int count = -1;            // number of values, -1 if unknown
+};
+
+/*!
+ * All variables of one dataset file (one file version). Text datasets are
+ * only indexed when they are loaded, the values of a variable are parsed
+ * the first time it is asked for.
+ */
+class DataSet {
+public:
+  // "Cancel" stops parsing, nullptr is returned then and nothing kept
+  DataSetVarPtr variable(const QString& Name,
+                         const std::atomic_bool* Cancel = nullptr) const;
+  const DataSetVarInfo* info(const QString& Name) const;
+  const QVector<DataSetVarInfo>& directory() const { return Directory; }
+  size_t bytes() const;
+
+  static std::shared_ptr<const DataSet> scan(const QByteArray& Content,
+                                             const std::atomic_bool* Cancel = nullptr);
+  static std::shared_ptr<const DataSet> map(const QString& qdbFile);
+
+private:
+  DataSetVarPtr parseVariable(const DataSetVarInfo&, const std::atomic_bool* Cancel) const;
+
+  QByteArray Content;                 // text dataset, empty for .qdb files
+  QVector<DataSetVarInfo> Directory;  // in file order
+  QHash<QString, int> Index;          // name -> position in "Directory"
+
+  mutable QMutex Mutex;               // guards "Vars" and "Size"
+  mutable QHash<QString, DataSetVarPtr> Vars;   // parsed so far
+  mutable size_t Size = 0;
+};
+
+typedef std::shared_ptr<const DataSet> DataSetPtr;
+
+/*!
+ * Process-wide cache of parsed datasets, keyed by canonical file path and
+ * modification time. All diagrams of all open documents share the parsed
+ * arrays. If a binary sidecar (.qdb, see qdbfile.h) is at least as new as
+ * the text dataset, it is mapped into memory instead of parsing the text.
+ * Least recently used datasets are dropped once the memory budget
+ * (QucsSettings.DataSetCacheSize, in MB) is exceeded; graphs still holding
+ * a variable keep it alive until they reload. The cache is thread-safe,
+ * a file requested by several threads at once is parsed only once.
+ */
+class DataSetCache {
+public:
+  static DataSetCache& instance();
+
+  // "Cancel" stops reading, nullptr is returned then and nothing cached
+  DataSetPtr dataSet(const QString& fileName, const std::atomic_bool* Cancel = nullptr);
+  void remove(const QString& fileName);
+  void clear();
+
+private:
+  DataSetCache() = default;
+  DataSetCache(const DataSetCache&) = delete;
+  DataSetCache& operator=(const DataSetCache&) = delete;
+
+  struct Entry {
+    QString Path;
+    qint64 lastModified;
+    qint64 fileSize;
+    DataSetPtr Data;
+  };
+
+  void evict();
+
+  QMutex Mutex;
+  std::list<Entry> Entries;   // most recently used first
+  QSet<QString> Loading;      // files being parsed right now
+  QWaitCondition Loaded;      // signalled when "Loading" shrinks
+};
+
+#endif
@@ -0,0 +1,172 @@
+/***************************************************************************
+                             datasetwriter.cpp
+                            -------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "datasetwriter.h"
+
+#include <QFile>
+#include <QDebug>
+
+#include <charconv>
+#include <cmath>
+
+// the buffer is written to the file whenever it grows beyond this size
+static constexpr int BufferSize = 1 << 20;
+
+DataSetWriter::DataSetWriter(const QString& fileName)
+  : File(fileName)
+{
+}
+
+/*!
+   Opens the dataset and writes its header. The file on disk is only
+   replaced by commit(), until then readers see the previous dataset.
+*/
+bool DataSetWriter::open(const char* Version)
+{
+  if (!File.open(QIODevice::WriteOnly)) return false;
+  Buffer.reserve(BufferSize + 256);
+  Buffer.append("<Qucs Dataset ");
+  Buffer.append(Version);
+  Buffer.append(">\n");
+  return true;
+}
+
+void DataSetWriter::beginIndep(const QString& Name_, qint64 count)
+{
+  isIndep = true;
+  isComplex = false;
+  Count = count;
+  Name = Name_;
+  Deps.clear();
+  Values.clear();
+  Values.reserve(count);
+  Buffer.append(QStringLiteral("<indep %1 %2>\n").arg(Name_).arg(count).toUtf8());
+}
+
+/*!
+   Starts a dependent variable. "Deps" are the names of its independent
+   variables, separated by spaces.
+*/
+void DataSetWriter::beginDep(const QString& Name_, const QString& Deps_)
+{
+  isIndep = false;
+  isComplex = false;
+  Count = 0;
+  // "Name_" may carry further dependencies, e.g. of XSPICE digital nodes
+  Deps = QStringLiteral("%1 %2").arg(Name_, Deps_).split(' ', Qt::SkipEmptyParts);
+  Name = Deps.isEmpty() ? Name_ : Deps.takeFirst();
+  Values.clear();
+  Buffer.append(QStringLiteral("<dep %1 %2>\n").arg(Name_, Deps_).toUtf8());
+}
+
+/*!
+   Formats the shortest text that reads back to exactly "Value", so the
+   text dataset and the .qdb sidecar hold the same numbers.
+*/
+void DataSetWriter::appendNumber(double Value)
+{
+  char Text[32];
+  auto Result = std::to_chars(Text, Text + sizeof(Text), Value,
+                              std::chars_format::scientific);
+  Buffer.append(Text, Result.ptr - Text);
+}
+
+void DataSetWriter::addReal(double Value)
+{
+  appendNumber(Value);
+  Buffer.append('\n');
+  if (!isIndep) {
+    Values.push_back(Value);
+    Values.push_back(0.0);
+  } else if (qint64(Values.size()) < Count) {
+    Values.push_back(Value);   // the header tells the number of values
+  }
+  flushIfFull();
+}
+
+void DataSetWriter::addComplex(double Re, double Im)
+{
+  appendNumber(Re);
+  Buffer.append(Im < 0 ? "-j" : "+j");
+  appendNumber(std::fabs(Im));
+  Buffer.append('\n');
+  if (!isIndep) {
+    isComplex = true;
+    Values.push_back(Re);
+    Values.push_back(Im);
+  } else if (qint64(Values.size()) < Count) {
+    Values.push_back(Re);   // no imaginary part for x-axis
+  }
+  flushIfFull();
+}
+
+void DataSetWriter::addText(const QString& Value)
+{
+  Buffer.append(Value.toUtf8());
+  Buffer.append('\n');
+  if (isIndep) {
+    if (qint64(Values.size()) < Count) Values.push_back(Value.toDouble());
+  } else {
+    Values.push_back(Value.toDouble());
+    Values.push_back(0.0);
+  }
+  flushIfFull();
+}
+
+/*!
+   Closes the current variable and hands its values to the .qdb writer,
+   which spools them to disk.
+*/
+void DataSetWriter::end()
+{
+  if (isIndep) {
+    Buffer.append("</indep>\n");
+    Binary.addIndep(Name, Values);
+  } else {
+    Buffer.append("</dep>\n");
+    Binary.addDep(Name, Deps, Values, isComplex);
+  }
+  Values.clear();
+  Values.shrink_to_fit();
+  flushIfFull();
+}
+
+void DataSetWriter::flushIfFull()
+{
+  if (Buffer.size() < BufferSize) return;
+  File.write(Buffer);
+  Buffer.clear();
+}
+
+/*!
+   Writes the rest of the text and replaces the dataset on disk, then
+   writes the .qdb sidecar. An outdated sidecar must never be used with
+   the new dataset, so it is removed first.
+*/
+bool DataSetWriter::commit()
+{
+  File.write(Buffer);
+  Buffer.clear();
+
+  QString qdbFile = qdb::sidecarName(File.fileName());
+  QFile::remove(qdbFile);
+  if (!File.commit()) {
+    qDebug() << "DataSetWriter: cannot write" << File.fileName();
+    return false;
+  }
+  Binary.write(qdbFile);   // written last, so it is newer than the text
+  Binary.clear();
+  return true;
+}
@@ -0,0 +1,75 @@
+/***************************************************************************
+                              datasetwriter.h
+                             -----------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef DATASETWRITER_H
+#define DATASETWRITER_H
+
+#include "qdbfile.h"
+
+#include <QByteArray>
+#include <QSaveFile>
+#include <QString>
+
+#include <vector>
+
+/*!
+ * Writes a Qucs dataset while it is being produced, one variable after the
+ * other. The text is formatted into a buffer that goes to the file in large
+ * blocks, so the memory needed is bounded by the largest variable instead
+ * of the whole dataset. The .qdb sidecar (see qdbfile.h) is written along.
+ *
+ * \code
+ *   DataSetWriter w("amp.dat");
+ *   w.open(PACKAGE_VERSION);
+ *   w.beginIndep("frequency", 2);  w.addReal(1e3);  w.addReal(1e6);  w.end();
+ *   w.beginDep("ac.v(out)", "frequency");  w.addComplex(1.0, -0.5);  ...
+ *   w.end();
+ *   w.commit();
+ * \endcode
+ */
+class DataSetWriter {
+public:
+  explicit DataSetWriter(const QString& fileName);
+
+  bool open(const char* Version);
+  void beginIndep(const QString& Name, qint64 count);
+  void beginDep(const QString& Name, const QString& Deps);
+  void addReal(double Value);
+  void addComplex(double Re, double Im);
+  void addText(const QString& Value);   // already formatted, e.g. sweep values
+  void end();
+  bool commit();
+
+  QString fileName() const { return File.fileName(); }
+
+private:
+  void appendNumber(double Value);
+  void flushIfFull();
+
+  QSaveFile File;
+  QByteArray Buffer;          // formatted text not yet written
+
+  // the variable being written
+  bool isIndep = false;
+  bool isComplex = false;
+  qint64 Count = 0;           // declared number of values of an "indep"
+  QString Name;
+  QStringList Deps;
+  std::vector<double> Values; // for the .qdb sidecar
+
+  qdb::Writer Binary;
+};
+
+#endif
@@ -30,6 +30,7 @@
 
 #endif
 
+#include <algorithm>
 #include <cstdlib>
 #include <cmath>
 #include <cfloat>
@@ -46,6 +47,7 @@
 #include "schematic.h"
 
 #include "rect3ddiagram.h"
+#include "datasetcache.h"
 #include "misc.h"
 
 #include <QTextStream>
@@ -55,6 +57,7 @@
 #include <QPainter>
 #include <QDebug>
 #include <QtAlgorithms>
+#include <QtConcurrent>
 
 Diagram::Diagram(int _cx, int _cy) {
     cx = _cx;
@@ -87,6 +90,7 @@ Diagram::Diagram(int _cx, int _cy) {
     hideLines = true;  // hide invisible lines
 
     engineeringNotation = true;
+    isLoading = false;
 
     Type = isDiagram;
     isSelected = false;
@@ -106,6 +110,20 @@ Diagram::~Diagram() {
 void Diagram::paint(QPainter *p) {
     paintDiagram(p);
     paintMarkers(p);
+    paintLoadingState(p);
+}
+
+/*!
+   Shows that the data of the graphs is still being loaded. The graphs
+   show the previous data meanwhile.
+*/
+void Diagram::paintLoadingState(QPainter *painter) const {
+    if (!isLoading) return;
+    painter->save();
+    painter->setPen(Qt::darkGray);
+    painter->drawText(QRect(cx, cy - y2, x2, y2), Qt::AlignCenter,
+                      QObject::tr("loading..."));
+    painter->restore();
 }
 
 void Diagram::paintDiagram(QPainter *painter) {
@@ -516,14 +534,26 @@ void Diagram::clip(Graph::iterator &p) const {
 // g->Points must already be empty!!!
 // is this a Graph Member?
 void Diagram::calcData(Graph *g) {
-    double *px;
-    double *pz = g->cPointsY;
+    const double *px;
+    const double *pz = g->cPointsY;
     if (!pz) return;
     if (g->numAxes() < 1) return;
 
     int i, z, Counter = 2;
     int Size = ((2 * (g->count(0)) + 1) * g->countY) + 10;
 
+    // Long curves are decimated: per pixel column only the first, the
+    // last, the smallest and the largest sample are drawn. This gives the
+    // same picture, but the buffer depends on the diagram width only.
+    bool Decimate = false;
+    if (g->Style == GRAPHSTYLE_SOLID || g->Style == GRAPHSTYLE_DASH ||
+        g->Style == GRAPHSTYLE_DOT || g->Style == GRAPHSTYLE_LONGDASH)
+        if (decimateData() && int(g->count(0)) > 4 * (x2 + 2))
+            if (g->minMaxPyramid(0)) {
+                Decimate = true;
+                Size = ((2 * 4 * (x2 + 2) + 1) * g->countY) + 10;
+            }
+
     if (xAxis.autoScale)
         if (yAxis.autoScale)
             if (zAxis.autoScale)
@@ -552,18 +582,60 @@ void Diagram::calcData(Graph *g) {
 
             for (i = g->countY; i > 0; i--) {  // every branch of curves
                 px = g->axis(0)->Points;
-                calcCoordinateP(px, pz, py, p, pa);
-                ++px;
-                pz += 2;
-                ++p;
-                for (z = g->axis(0)->count - 1; z > 0; z--) {  // every point
-                    FIT_MEMORY_SIZE;  // need to enlarge memory block ?
+                if (Decimate) {
+                    const MinMaxPyramid *pm = g->minMaxPyramid(g->countY - i);
+                    int Count = g->axis(0)->count;
+                    auto column = [&](int k) {  // pixel column of sample k
+                        float fx, fy;
+                        calcCoordinate(px + k, pz + 2 * k, py, &fx, &fy, pa);
+                        if (!(fx >= 0.0f)) return -1;   // also NaN, e.g. log axis <= 0
+                        if (fx >= float(x2)) return x2;
+                        return int(fx);
+                    };
+                    auto addPoint = [&](int k) {
+                        FIT_MEMORY_SIZE;  // need to enlarge memory block ?
+                        calcCoordinateP(px + k, pz + 2 * k, py, p, pa);
+                        ++p;
+                        if (k > 0 && Counter >= 2)   // clipping only if an axis is manual
+                            clip(p);
+                    };
+
+                    for (int Begin = 0; Begin < Count;) {
+                        // x values ascend, so search the last sample of this column
+                        int Col = column(Begin);
+                        int Last = Begin, hi = Count - 1;
+                        while (Last < hi) {
+                            int mid = Last + (hi - Last + 1) / 2;
+                            if (column(mid) == Col) Last = mid;
+                            else hi = mid - 1;
+                        }
+
+                        MinMaxPyramid::Extrema e;
+                        if (pm && pm->extrema(Begin, Last + 1, pa->log, e)) {
+                            int k[4] = {Begin, std::min(e.Min, e.Max),
+                                        std::max(e.Min, e.Max), Last};
+                            for (z = 0; z < 4; z++)
+                                if (z == 0 || k[z] != k[z - 1]) addPoint(k[z]);
+                        } else {   // values not finite, draw them all
+                            for (z = Begin; z <= Last; z++) addPoint(z);
+                        }
+                        Begin = Last + 1;
+                    }
+                    pz += 2 * Count;
+                } else {
                     calcCoordinateP(px, pz, py, p, pa);
                     ++px;
                     pz += 2;
                     ++p;
-                    if (Counter >= 2)   // clipping only if an axis is manual
-                        clip(p);
+                    for (z = g->axis(0)->count - 1; z > 0; z--) {  // every point
+                        FIT_MEMORY_SIZE;  // need to enlarge memory block ?
+                        calcCoordinateP(px, pz, py, p, pa);
+                        ++px;
+                        pz += 2;
+                        ++p;
+                        if (Counter >= 2)   // clipping only if an axis is manual
+                            clip(p);
+                    }
                 }
                 if ((p - 3)->isStrokeEnd() && !(p - 3)->isBranchEnd())
                     p -= 3;  // no single point after "no stroke"
@@ -646,22 +718,25 @@ bool Diagram::resizeTouched(float fX, float fY, float len) {
 }
 
 // --------------------------------------------------------------------------
-void Diagram::getAxisLimits(Graph *pg) {
+/*!
+   Determines the value range of one graph. Only reads the graph, so that
+   the graphs of a diagram can be handled concurrently.
+*/
+Diagram::GraphLimits Diagram::graphLimits(const Graph *pg) const {
     // FIXME: Graph should know the limits. but it doesn't yet.
     //        we should only copy here. better: just wrap, dont use {x,y,z}Axis
+    GraphLimits l;
     int z;
-    double x, y, *p;
+    double x, y;
+    const double *p;
     DataX const *pD = pg->axis(0);
-    if (pD == 0) return;
+    if (pD == 0) return l;
 
     if (Name[0] != 'C') {   // not for location curves
         p = pD->Points;
         for (z = pD->count; z > 0; z--) { // check x coordinates (1. dimension)
             x = *(p++);
-            if (std::isfinite(x)) {
-                if (x > xAxis.max) xAxis.max = x;
-                if (x < xAxis.min) xAxis.min = x;
-            }
+            if (std::isfinite(x)) l.add(0, x);
         }
     }
 
@@ -671,74 +746,82 @@ void Diagram::getAxisLimits(Graph *pg) {
             p = pDy->Points;
             for (z = pDy->count; z > 0; z--) { // check y coordinates (2. dimension)
                 y = *(p++);
-                if (std::isfinite(y)) {
-                    if (y > yAxis.max) yAxis.max = y;
-                    if (y < yAxis.min) yAxis.min = y;
-                }
+                if (std::isfinite(y)) l.add(1, y);
             }
         }
     }
 
-    Axis *pa;
-    if (pg->yAxisNo == 0) pa = &yAxis;
-    else pa = &zAxis;
-    (pa->numGraphs)++;    // count graphs
+    int a = (pg->yAxisNo == 0) ? 1 : 2;
     p = pg->cPointsY;
-    if (p == 0) return;    // if no data => invalid
-    for (z = pg->countY * pD->count; z > 0; z--) {  // check every y coordinate
+    if (p == 0) return l;    // if no data => invalid
+    if (Name[0] != 'C') {
+        double Min, Max;
+        if (magnitudeRange(p, pg->countY * pD->count, Min, Max)) {
+            l.add(a, Min);
+            l.add(a, Max);
+        }
+        return l;
+    }
+
+    for (z = pg->countY * pD->count; z > 0; z--) {  // location curve needs different treatment
         x = *(p++);
         y = *(p++);
+        if (std::isfinite(x)) l.add(0, x);
+        if (std::isfinite(y)) l.add(a, y);
+    }
+    return l;
+}
 
-        if (Name[0] != 'C') {
-            if (fabs(y) >= 1e-250) x = sqrt(x * x + y * y);
-            if (std::isfinite(x)) {
-                if (x > pa->max) pa->max = x;
-                if (x < pa->min) pa->min = x;
-            }
-        } else {   // location curve needs different treatment
-            if (std::isfinite(x)) {
-                if (x > xAxis.max) xAxis.max = x;
-                if (x < xAxis.min) xAxis.min = x;
-            }
-            if (std::isfinite(y)) {
-                if (y > pa->max) pa->max = y;
-                if (y < pa->min) pa->min = y;
-            }
+// --------------------------------------------------------------------------
+/*!
+   Determines the limits of all graphs. The graphs are scanned
+   concurrently, the results are merged afterwards.
+*/
+void Diagram::getAxisLimits() {
+    QList<GraphLimits> Limits = QtConcurrent::blockingMapped(
+        Graphs, [this](const Graph *pg) { return graphLimits(pg); });
+
+    Axis *Axes[3] = {&xAxis, &yAxis, &zAxis};
+    for (int n = 0; n < Graphs.size(); n++) {
+        Graph *pg = Graphs.at(n);
+        if (pg->axis(0) == 0) continue;
+        if (pg->yAxisNo == 0) yAxis.numGraphs++;   // count graphs
+        else zAxis.numGraphs++;
+
+        const GraphLimits &l = Limits.at(n);
+        for (int i = 0; i < 3; i++) {
+            if (l.Max[i] > Axes[i]->max) Axes[i]->max = l.Max[i];
+            if (l.Min[i] < Axes[i]->min) Axes[i]->min = l.Min[i];
         }
     }
 }
 
 // --------------------------------------------------------------------------
+/*!
+   Loads the data of all graphs. The graphs are loaded concurrently, the
+   datasets are parsed only once (see DataSetCache).
+*/
 void Diagram::loadGraphData(const QString &defaultDataSet) {
-    int yNum = yAxis.numGraphs;
-    int zNum = zAxis.numGraphs;
-    yAxis.numGraphs = zAxis.numGraphs = 0;
+    QList<int> Loaded = QtConcurrent::blockingMapped(
+        Graphs, [&defaultDataSet](Graph *pg) {
+            qDebug() << "load GraphData load" << defaultDataSet << pg->Var;
+            return pg->loadDatFile(defaultDataSet);   // load data
+        });
 
-    double xmin = xAxis.min, ymin = yAxis.min, zmin = zAxis.min;
-    double xmax = xAxis.max, ymax = yAxis.max, zmax = zAxis.max;
-    yAxis.min = zAxis.min = xAxis.min = DBL_MAX;
-    yAxis.max = zAxis.max = xAxis.max = -DBL_MAX;
+    loadedGraphData(Loaded.count(1) < Loaded.size());
+}
 
-    int No = 0;
-    for (Graph *pg: Graphs) {
-        qDebug() << "load GraphData load" << defaultDataSet << pg->Var;
-        if (pg->loadDatFile(defaultDataSet) != 1)   // load data, determine max/min values
-            No++;
-        getAxisLimits(pg);
-    }
+/*!
+   Recalculates the diagram after its graphs have been loaded. "Changed"
+   is false if all dataset files were unchanged.
+*/
+void Diagram::loadedGraphData(bool Changed) {
+    if (!Changed) return;    // -> no update necessary
 
-    if (No <= 0) {   // All dataset files unchanged ?
-        yAxis.numGraphs = yNum;  // rebuild scrollbar position
-        zAxis.numGraphs = zNum;
-
-        xAxis.min = xmin;
-        yAxis.min = ymin;
-        zAxis.min = zmin;
-        xAxis.max = xmax;
-        yAxis.max = ymax;
-        zAxis.max = zmax;
-        return;    // -> no update necessary
-    }
+    yAxis.numGraphs = zAxis.numGraphs = 0;
+    yAxis.min = zAxis.min = xAxis.min = DBL_MAX;
+    yAxis.max = zAxis.max = xAxis.max = -DBL_MAX;
+    getAxisLimits();    // determine max/min values
 
     if (xAxis.min > xAxis.max)
         xAxis.min = xAxis.max = 0.0;
@@ -763,8 +846,7 @@ void Diagram::recalcGraphData() {
     yAxis.numGraphs = zAxis.numGraphs = 0;
 
     // get maximum and minimum values
-    for (Graph *pg: Graphs)
-        getAxisLimits(pg);
+    getAxisLimits();
 
     if (xAxis.min > xAxis.max) {
         xAxis.min = 0.0;
@@ -790,15 +872,18 @@ void Diagram::recalcGraphData() {
 void Diagram::updateGraphData() {
     int valid = calcDiagram();   // do not calculate graph data if invalid
 
-    for (Graph *pg: Graphs) {
+    // every graph only writes its own screen coordinates
+    auto calcGraph = [this, valid](Graph *pg) {
         pg->clear();
         if ((valid & (pg->yAxisNo + 1)) != 0)
             calcData(pg);   // calculate screen coordinates
-        else if (pg->cPointsY) {
-            delete[] pg->cPointsY;
-            pg->cPointsY = 0;
-        }
-    }
+        else
+            pg->releaseValues();
+    };
+    if (parallelCalcData())
+        QtConcurrent::blockingMap(Graphs, calcGraph);
+    else
+        for (Graph *pg: Graphs) calcGraph(pg);
 
     createAxisLabels();  // virtual function
 
@@ -814,12 +899,17 @@ void Diagram::updateGraphData() {
  * does not (yet) load a dat file. only part of it.
  * this way, it would belong to graph.cpp. but it's too obsolete, lets see..
  *
+ * The dataset is parsed only once by DataSetCache, the graph shares the
+ * values with all other graphs using the same dataset.
+ *
  * FIXME: must invalidate markers.
  */
-int Graph::loadDatFile(const QString &fileName) {
-    Graph *g = this;
-    QFile file;
-    QString Variable;
+/*!
+   Determines the dataset file and the variable name of this graph.
+   "fileName" is the default dataset of the document.
+*/
+void Graph::dataSource(const QString &fileName, QString &DataFile, QString &Variable) const {
+    const Graph *g = this;
     QFileInfo Info(fileName);
 
     int pos1 = g->Var.indexOf('/');
@@ -827,10 +917,6 @@ int Graph::loadDatFile(const QString &fileName) {
 //    if(pos > g->Var.indexOf('['))
 //      pos = -1;
 
-    /* WORK-AROUND: A bug in SCIM (libscim) which Qt is linked to causes
-       to change the locale to the default. */
-    setlocale(LC_NUMERIC, "C");
-
     QString tail = "";
     QString svar = g->Var;
     if (pos1 > 0) {  // remove simulator signature
@@ -840,16 +926,23 @@ int Graph::loadDatFile(const QString &fileName) {
 
     int pos = svar.indexOf(':');
     if (pos <= 0) {
-        file.setFileName(fileName + tail);
+        DataFile = fileName + tail;
         Variable = svar;
     } else {
-        QString ss3 = Info.path() + QDir::separator() + svar.left(pos) + ".dat" + tail;
-        qDebug() << ss3;
-        file.setFileName(ss3);
+        DataFile = Info.path() + QDir::separator() + svar.left(pos) + ".dat" + tail;
+        qDebug() << DataFile;
         Variable = svar.mid(pos + 1);
     }
+}
+
+// ------------------------------------------------------------------------
+int Graph::loadDatFile(const QString &fileName) {
+    Graph *g = this;
+    QString Variable;
+    QString DataFile;
+    dataSource(fileName, DataFile, Variable);
 
-    Info.setFile(file);
+    QFileInfo Info(DataFile);
     if (g->lastLoaded.isValid())
         if (g->lastLoaded.toMSecsSinceEpoch() >=
             Info.lastModified().toMSecsSinceEpoch()) //Millisecond resulution is needed for tuning
@@ -859,10 +952,7 @@ int Graph::loadDatFile(const QString &fileName) {
     qDeleteAll(g->mutable_axes());
     g->mutable_axes().clear();
     g->countY = 0;
-    if (g->cPointsY != nullptr) {
-        delete[] g->cPointsY;
-        g->cPointsY = nullptr;
-    }
+    g->releaseValues();
     if (Variable.isEmpty()) return 0;
 
 #if 0 // FIXME encapsulation. implement digital waves later.
@@ -880,296 +970,112 @@ int Graph::loadDatFile(const QString &fileName) {
         Variable = Variable.section("@", 0, 0);
     }
 
-
-    if (!file.open(QIODevice::ReadOnly)) return 0;
+    DataSetPtr ds = DataSetCache::instance().dataSet(DataFile);
+    if (!ds) return 0;
 
     // *****************************************************************
-    // To strongly speed up the file read operation the whole file is
-    // read into the memory in one piece.
-    QByteArray FileContent;
-    FileContent = file.readAll();
-    file.close();
-    char *FileString = FileContent.data();
-    if (!FileString) return 0;
-    char *pPos = FileString + FileContent.size() - 1;
-    if (*pPos > ' ') if (*pPos != '>') return 0;
-    *pPos = 0;
-
-
-    // *****************************************************************
-    // look for variable name in data file  ****************************
-    bool isIndep = false;
-    Variable = "dep " + Variable + " ";
-    // "pFile" is used through-out the whole function and must NOT used
-    // for other purposes!
-    char *pFile = strstr(FileString, Variable.toLatin1());
-    while (pFile) {
-        if (*(pFile - 1) == '<')     // is dependent variable ?
-            break;
-        else if (strncmp(pFile - 3, "<in", 3) == 0) {  // is independent variable ?
-            isIndep = true;
-            break;
-        }
-        pFile = strstr(pFile + 4, Variable.toLatin1());
-    }
-
-    if (!pFile) return 0;   // data not found
-
-    QString Line, tmp;
-    pFile += Variable.length();
-    pPos = strchr(pFile, '>');
-    if (!pPos) return 0;   // file corrupt
-    *pPos = 0;
-    Line = QString(pFile);
-    *pPos = '>';
-    pFile = pPos + 1;
-    if (!isIndep) {
-        pos = 0;
-        tmp = Line.section(' ', pos, pos);
-        while (!tmp.isEmpty()) {
-            if (hasExplIndep)g->mutable_axes().push_back(new DataX(ExplIndep));
-            else g->mutable_axes().push_back(new DataX(tmp));  // name of independent variable
-            pos++;
-            tmp = Line.section(' ', pos, pos);
-        }
-    }
+    // look for variable name in data set ******************************
+    DataSetVarPtr pv = ds->variable(Variable);
+    if (!pv) return 0;   // data not found
 
     // *****************************************************************
     // get independent variable ****************************************
-    bool ok = true;
-    double *p;
     int counting = 0;
-    if (isIndep) {    // create independent variable by myself ?
-        counting = Line.toInt(&ok);  // get number of values
-        g->mutable_axes().push_back(new DataX("number", 0, counting));
-        if (!ok) return 0;
-
-        p = new double[counting];  // memory of new independent variable
+    if (pv->isIndep) {    // create independent variable by myself ?
+        counting = pv->count;
+        auto Numbers = std::make_shared<std::vector<double>>(counting);
+        for (int z = 0; z < counting; z++) (*Numbers)[z] = double(z + 1);
+        DataX *pD = new DataX("number", Numbers->data(), counting);
+        pD->Storage = Numbers;
+        pD->min(1.);
+        pD->max(double(counting));
+        g->mutable_axes().push_back(pD);
         g->countY = 1;
-        g->mutable_axes().back()->Points = p;
-        for (int z = 1; z <= counting; z++) *(p++) = double(z);
-        auto Axis = g->mutable_axes().back();
-        Axis->min(1.);
-        Axis->max(double(counting));
     } else {  // ...................................
-        // get independent variables from data file
-        g->countY = 1;
-#if 0 // FIXME: we do not have a Name.
-        DataX *bLast = 0;
-        if(Name == "Rect3D")  bLast = g->axis(1);  // y axis for Rect3D
-#endif
+        for (const QString &Dep : pv->Deps) {
+            if (hasExplIndep) g->mutable_axes().push_back(new DataX(ExplIndep));
+            else g->mutable_axes().push_back(new DataX(Dep));  // name of independent variable
+        }
 
-#if 0 // FIXME: this is about diagram. do after load.
-        double min_tmp = xAxis.min, max_tmp = xAxis.max;
-#endif
+        // get independent variables from data set
+        g->countY = 1;
         DataX const *pD;
         for (int ii = g->numAxes(); (pD = g->axis(--ii));) {
-#if 0 // FIXME: this is about diagram. do after load.
-            pa = &xAxis;
-            if(pD == g->axis(0)) {
-              xAxis.min = min_tmp;    // only count first independent variable
-              xAxis.max = max_tmp;
-            }
-            else if(pD == bLast)  pa = &yAxis;   // y axis for Rect3D
-#endif
-            counting = loadIndepVarData(pD->Var, FileString, mutable_axis(ii));
+            counting = loadIndepVarData(pD->Var, *ds, mutable_axis(ii));
             if (counting <= 0) return 0;
 
             g->countY *= counting;
         }
+        if (counting <= 0) return 0;
         g->countY /= counting;
     }
 
-
     // *****************************************************************
     // get dependent variables *****************************************
     counting *= g->countY;
-    p = new double[2 * counting]; // memory for dependent variables
-    g->cPointsY = p;
-#if 0 // FIXME: what does this do?!
-    if(g->yAxisNo == 0)  pa = &yAxis;   // for which axis
-    else  pa = &zAxis;
-    (pa->numGraphs)++;    // count graphs
-#endif
-
-    char *pEnd;
-    double x, y;
-    pPos = pFile;
-
-    if (Variable.right(3) != ".X ") { // not "digital"
-
-        for (int z = counting; z > 0; z--) {
-            pEnd = 0;
-            while ((*pPos) && (*pPos <= ' ')) pPos++; // find start of next number
-            x = strtod(pPos, &pEnd);  // real part
-            pPos = pEnd + 1;
-            if (*pEnd < ' ')   // is there an imaginary part ?
-                y = 0.0;
-            else {
-                if (((*pEnd != '+') && (*pEnd != '-')) || (*pPos != 'j')) {
-                    delete[] g->cPointsY;
-                    g->cPointsY = 0;
-                    return 0;
-                }
-                *pPos = *pEnd;  // overwrite 'j' with sign
-                pEnd = 0;
-                y = strtod(pPos, &pEnd); // imaginary part
-                *pPos = 'j';   // write back old character
-                pPos = pEnd;
-            }
-            *(p++) = x;
-            *(p++) = y;
-#if 0 // FIXME there is no Name here.
-            if(Name[0] != 'C')
-#endif
-            {
-                if (fabs(y) >= 1e-250) x = sqrt(x * x + y * y);
-                if (std::isfinite(x)) {
-                    auto Axis = g->mutable_axes().back();
-                    Axis->min(x);
-                    Axis->max(x);
-                }
-            }
+    if (pv->count < counting) return 0;   // file corrupt
+
+    if (pv->isDigital) {
+        g->setValues(pv->data(), pv);
+    } else if (pv->isIndep) {   // real values only -> make them complex
+        auto Values = std::make_shared<std::vector<double>>(2 * counting, 0.0);
+        for (int z = 0; z < counting; z++) (*Values)[2 * z] = pv->data()[z];
+        g->setValues(Values->data(), Values);
+    } else {
+        g->setValues(pv->data(), pv);
+    }
 
-#if 0 // this is not location curve code.
-            else {   // location curve needs different treatment
-              if(std::isfinite(x)) {
-                if(x > xAxis.max) xAxis.max = x;
-                if(x < xAxis.min) xAxis.min = x;
-              }
-              if(std::isfinite(y)) {
-                if(y > pa->max) pa->max = y;
-                if(y < pa->min) pa->min = y;
-              }
-            }
-#endif
+    if (!pv->isDigital) {
+        // the range of a parsed variable is known from the data set
+        double Min, Max;
+        bool Finite;
+        if (pv->hasRange && pv->count == counting) {
+            Min = pv->Min;
+            Max = pv->Max;
+            Finite = true;
+        } else {
+            Finite = magnitudeRange(g->cPointsY, counting, Min, Max);
         }
-
-    } else {  // of "if not digital"
-
-        char *pc = (char *) p;
-        pEnd = pc + 2 * (counting - 1) * sizeof(double);
-        // for digital variables (e.g. 100ZX0):
-        for (int z = counting; z > 0; z--) {
-
-            while ((*pPos) && (*pPos <= ' ')) pPos++; // find start of next bit vector
-            if (*pPos == 0) {
-                delete[] g->cPointsY;
-                g->cPointsY = 0;
-                return 0;
-            }
-
-            while (*pPos > ' ') {    // copy bit vector
-                *(pc++) = *(pPos++);
-                if (pEnd <= pc) {
-                    counting = pc - (char *) g->cPointsY;
-                    pc = (char *) realloc(g->cPointsY, counting + 1024);
-                    pEnd = pc;
-                    g->cPointsY = (double *) pEnd;
-                    pc += counting;
-                    pEnd += counting + 1020;
-                }
-            }
-            *(pc++) = 0;   // terminate each vector with NULL
+        if (Finite) {
+            auto Axis = g->mutable_axes().back();
+            Axis->min(Min);
+            Axis->max(Max);
         }
-
-    }  // of "if not digital"
+    }
 
     lastLoaded = QDateTime::currentDateTime();
     return 2;
 }
 
 /*!
-   Reads the data of an independent variable. Returns the number of points.
+   Takes the data of an independent variable from the data set. Returns
+   the number of points.
 */
 int Graph::loadIndepVarData(const QString &Variable,
-                            char *FileString, DataX *pD) {
-    bool isIndep = false;
-    QString Line, tmp;
-
-    /* WORK-AROUND: A bug in SCIM (libscim) which Qt is linked to causes
-       to change the locale to the default. */
-    setlocale(LC_NUMERIC, "C");
-
-    Line = "dep " + Variable + " ";
-    // "pFile" is used through-out the whole function and must NOT used
-    // for other purposes!
-    char *pFile = strstr(FileString, Line.toLatin1());
-    while (pFile) {
-        if (*(pFile - 1) == '<')     // is dependent variable ?
-            break;
-        else if (strncmp(pFile - 3, "<in", 3) == 0) {  // is independent variable ?
-            isIndep = true;
-            break;
-        }
-        pFile = strstr(pFile + 4, Line.toLatin1());
-    }
-
-    if (!pFile) return -1;   // data not found
-
-    pFile += Line.length();
-    char *pPos = strchr(pFile, '>');
-    if (!pPos) return -1;   // file corrupt
-    *pPos = 0;
-    Line = QString(pFile);
-    *pPos = '>';
-    pFile = pPos + 1;
-    char *pEnd;
-    if (!isIndep) {           // dependent variable can also be used...
-        if (Line.indexOf(' ') >= 0) return -1; // ...if only one dependency
-        Line = "<indep " + Line + " ";
-        pPos = strstr(FileString, Line.toLatin1());
-        if (!pPos) return -1;
-        pPos += Line.length();
-        pEnd = strchr(pPos, '>');
-        if (!pEnd) return -1;   // file corrupt
-        *pEnd = 0;
-        Line = QString(pPos);
-        *pEnd = '>';
+                            const DataSet &ds, DataX *pD) {
+    DataSetVarPtr pv = ds.variable(Variable);
+    if (!pv) return -1;   // data not found
+    if (pv->isDigital) return -1;
+
+    int n = pv->count;
+    if (pv->isIndep) {
+        pD->Points = pv->data();
+        pD->Storage = pv;
+    } else {        // dependent variable can also be used...
+        if (pv->Deps.size() != 1) return -1; // ...if only one dependency
+        const DataSetVarInfo *pIndep = ds.info(pv->Deps.first());
+        if (!pIndep || !pIndep->isIndep) return -1;
+        n = pIndep->count;
+        if (pv->count < n) return -1;
+
+        // Complex number on X-axis has no sense, so use the real part only.
+        auto Points = std::make_shared<std::vector<double>>(n);
+        for (int z = 0; z < n; z++) (*Points)[z] = pv->data()[2 * z];
+        pD->Points = Points->data();
+        pD->Storage = Points;
     }
-
-
-    bool ok;
-    int n = Line.toInt(&ok);  // number of values
-    if (!ok) return -1;
-
-    double *p = new double[n];     // memory for new independent variable
-//  DataX *pD = pg->mutable_axes().back();
-    pD->Points = p;
     pD->count = n;
 
-
-    double x;
-    pPos = pFile;
-    // find first position containing no whitespace
-    while ((*pPos) && (*pPos <= ' ')) pPos++;
-
-    for (int z = 0; z < n; z++) {
-        pEnd = 0;
-        x = strtod(pPos, &pEnd);  // real part
-
-        if (*pEnd > ' ')  // drop imaginary part because
-            while (*pEnd > ' ') pEnd++; // Complex number on X-axis has no sense
-
-        if (pPos == pEnd) {
-            delete[] pD->Points;
-            pD->Points = 0;
-            return -1;
-        }
-
-        *(p++) = x;
-#if 0 // this is not location curve code
-        if(Name[0] != 'C')   // not for location curves
-          if(std::isfinite(x)) {
-            if(x > pa->max) pa->max = x;
-            if(x < pa->min) pa->min = x;
-          }
-#endif
-
-        pPos = pEnd;
-        while ((*pPos) && (*pPos <= ' ')) pPos++;  // find start of next number
-    }
-
     return n;   // return number of independent data
 }
 
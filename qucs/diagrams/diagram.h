@@ -24,6 +24,8 @@
 #include <QTextStream>
 #include <QList>
 
+#include <cfloat>
+
 #define MIN_SCROLLBAR_SIZE 8
 
 #define INVALID_STR QObject::tr(" <invalid>")
@@ -123,6 +125,7 @@ public:
   virtual void paint(QPainter* p);
   virtual void paintDiagram(QPainter* painter);
   void paintMarkers(QPainter* p, bool paintAll = true);
+  void paintLoadingState(QPainter* p) const;
   void    paintScheme(Schematic*) override;
   void    Bounding(int&, int&, int&, int&);
   QRect boundingRect() const noexcept override;
@@ -131,9 +134,10 @@ public:
   QString save();
   bool    load(const QString&, QTextStream*);
 
-  void getAxisLimits(Graph*);
+  void getAxisLimits();
   void updateGraphData();
   void loadGraphData(const QString&);
+  void loadedGraphData(bool Changed);
   void recalcGraphData();
   bool sameDependencies(Graph const*, Graph const*) const;
   int  checkColumnWidth(const QString&, const QFontMetrics&, int, int, int);
@@ -154,6 +158,7 @@ public:
   Axis  xAxis, yAxis, zAxis;   // axes (x, y left, y right)
   int State;  // to remember which resize area was touched
   bool engineeringNotation;
+  bool isLoading;       // data is being loaded in the background (GraphLoader)
 
   bool hideLines;       // for "Rect3D": hide invisible lines ?
   int rotX, rotY, rotZ; // for "Rect3D": rotation around x, y and z axis
@@ -174,11 +179,28 @@ protected:
   void rectClip(Graph::iterator &) const;
 
   virtual void calcData(Graph*);
+  // true if the x coordinate only depends on the x value, so that long
+  // curves may be drawn with a few points per pixel column
+  virtual bool decimateData() const { return false; }
+  // false if calcData() uses members of the diagram, i.e. the graphs
+  // cannot be calculated concurrently
+  virtual bool parallelCalcData() const { return true; }
 
   QTransform pointTransform; // Transform between Qucs-S logical coordinates and diagram (logical) point coordinates.
   QTransform valueTransform; // Transform between diagram point coordinates and diagram values.
 
 private:
+  // value range of one graph, see graphLimits()
+  struct GraphLimits {
+    double Min[3] = {DBL_MAX, DBL_MAX, DBL_MAX};     // x, y and z axis
+    double Max[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+    void add(int i, double v) {
+      if (v > Max[i]) Max[i] = v;
+      if (v < Min[i]) Min[i] = v;
+    }
+  };
+  GraphLimits graphLimits(const Graph*) const;
+
   int Bounding_x1, Bounding_x2, Bounding_y1, Bounding_y2;
 };
 
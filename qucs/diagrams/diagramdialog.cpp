@@ -23,6 +23,7 @@
 #include "qucs.h"
 #include "schematic.h"
 #include "rect3ddiagram.h"
+#include "datasetcache.h"
 #include "main.h"
 #include "misc.h"
 #include "settings.h"
@@ -880,17 +881,14 @@ void DiagramDialog::slotReadVars(int)
       DocName += ".spopus";
   }
 
-  QFile file(Info.absolutePath() + QDir::separator() + DocName);
-  if(!file.open(QIODevice::ReadOnly)) {
+  // the variable directory of the dataset is shared with the graphs
+  DataSetPtr ds = DataSetCache::instance().dataSet(
+                    Info.absolutePath() + QDir::separator() + DocName);
+  if(!ds) {
     return;
   }
 
-  QString Line, tmp, Var;
   int varNumber = 0;
-  // reading the file as a whole improves speed very much, also using
-  // a QByteArray rather than a QString
-  QByteArray FileString = file.readAll();
-  file.close();
 
   // make sure sorting is disabled before inserting items
   ChooseVars->setSortingEnabled(false);
@@ -898,56 +896,27 @@ void DiagramDialog::slotReadVars(int)
   ChooseXVar->clear();
   ChooseXVar->addItem("default");
 
-  int i=0, j=0;
-  i = FileString.indexOf('<')+1;
-  if(i > 0)
-  do {
-    j = FileString.indexOf('>', i);
-    Line.resize(j-i);
-    for(int k=0;k<j-i;k++) Line[k]=(FileString[k+i]);
-    Line.truncate(j-i);
-    i = FileString.indexOf('<', j)+1;
-
-    Var = Line.section(' ', 1, 1).remove('>');
-    if(Var.length()>0)
-      if(Var.at(0) == '_')  continue;
-
-    if(Line.left(3) == "dep") {
-      tmp = Line.section(' ', 2);
-      //new Q3ListViewItem(ChooseVars, Var, "dep", tmp.remove('>'));
-      qDebug() << varNumber << Var << tmp.remove('>');
-      ChooseVars->setRowCount(varNumber+1);
-      QTableWidgetItem *cell = new QTableWidgetItem(Var);
-      ChooseXVar->addItem(Var);
-      cell->setFlags(cell->flags() ^ Qt::ItemIsEditable);
-      ChooseVars->setItem(varNumber, 0, cell);
-      cell = new QTableWidgetItem("dep");
-      cell->setFlags(cell->flags() ^ Qt::ItemIsEditable);
-      ChooseVars->setItem(varNumber, 1, cell);
-      cell = new QTableWidgetItem(tmp.remove('>'));
-      cell->setFlags(cell->flags() ^ Qt::ItemIsEditable);
-      ChooseVars->setItem(varNumber, 2, cell);
-      varNumber++;
-    }
-    else if(Line.left(5) == "indep") {
-      tmp = Line.section(' ', 2, 2);
-      //new Q3ListViewItem(ChooseVars, Var, "indep", tmp.remove('>'));
-      qDebug() << varNumber << Var << tmp.remove('>');
-      ChooseVars->setRowCount(varNumber+1);
-      QTableWidgetItem *cell = new QTableWidgetItem(Var);
-      ChooseXVar->addItem(Var);
-      cell->setFlags(cell->flags() ^ Qt::ItemIsEditable);
-      ChooseVars->setItem(varNumber, 0, cell);
-      cell = new QTableWidgetItem("indep");
-      cell->setFlags(cell->flags() ^ Qt::ItemIsEditable);
-      ChooseVars->setItem(varNumber, 1, cell);
-      cell = new QTableWidgetItem(tmp.remove('>'));
-      cell->setFlags(cell->flags() ^ Qt::ItemIsEditable);
-      ChooseVars->setItem(varNumber, 2, cell);
-      varNumber++;
-
-    }
-  } while(i > 0);
+  for(const DataSetVarInfo& Var : ds->directory()) {
+    if(Var.Name.startsWith('_'))  continue;
+
+    QString tmp;
+    if(Var.isIndep) tmp = QString::number(Var.count);
+    else tmp = Var.Deps.join(' ');
+    qDebug() << varNumber << Var.Name << tmp;
+
+    ChooseVars->setRowCount(varNumber+1);
+    QTableWidgetItem *cell = new QTableWidgetItem(Var.Name);
+    ChooseXVar->addItem(Var.Name);
+    cell->setFlags(cell->flags() ^ Qt::ItemIsEditable);
+    ChooseVars->setItem(varNumber, 0, cell);
+    cell = new QTableWidgetItem(Var.isIndep ? "indep" : "dep");
+    cell->setFlags(cell->flags() ^ Qt::ItemIsEditable);
+    ChooseVars->setItem(varNumber, 1, cell);
+    cell = new QTableWidgetItem(tmp);
+    cell->setFlags(cell->flags() ^ Qt::ItemIsEditable);
+    ChooseVars->setItem(varNumber, 2, cell);
+    varNumber++;
+  }
   // sorting should be enabled only after adding items
   ChooseVars->setSortingEnabled(true);
 }
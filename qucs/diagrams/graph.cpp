@@ -48,14 +48,34 @@ Graph::Graph(Diagram const* d, const QString& _Line) :
 
 Graph::~Graph()
 {
-  if (cPointsY != nullptr) {
-    delete[] cPointsY;
-    cPointsY = nullptr;
-  }
   qDeleteAll(cPointsX);
   qDeleteAll(Markers);
 }
 
+// ---------------------------------------------------------------------
+/*!
+   Returns the extreme values of branch "Branch" for drawing a decimated
+   curve. They are computed once per data load. Returns nullptr if the
+   x values are not finite and ascending.
+*/
+const MinMaxPyramid* Graph::minMaxPyramid(int Branch)
+{
+  if (!Pyramids) {
+    Pyramids = std::make_unique<std::vector<MinMaxPyramid>>();
+    DataX const *pD = axis(0);
+    if (!cPointsY || !pD) return nullptr;
+    for (int z = 0; z < pD->count; z++) {
+      if (!std::isfinite(pD->Points[z])) return nullptr;
+      if (z > 0 && pD->Points[z] < pD->Points[z-1]) return nullptr;
+    }
+    Pyramids->reserve(countY);
+    for (int i = 0; i < countY; i++)
+      Pyramids->emplace_back(cPointsY + 2 * size_t(i) * pD->count, pD->count);
+  }
+  if (Branch < 0 || Branch >= int(Pyramids->size())) return nullptr;
+  return &(*Pyramids)[Branch];
+}
+
 // ---------------------------------------------------------------------
 void Graph::createMarkerText() const
 {
@@ -282,7 +302,7 @@ std::pair<double,double> Graph::findSample(std::vector<double>& VarPos) const
   unsigned m=1;
 
   for(unsigned ii=0; (pD=axis(ii)); ++ii) {
-    double* pp = pD->Points;
+    const double* pp = pD->Points;
     double v = VarPos[nVarPos];
     for(unsigned i=pD->count; i>1; i--) {  // find appropriate marker position
       if(fabs(v-(*pp)) < fabs(v-(*(pp+1)))) break;
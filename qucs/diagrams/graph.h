@@ -21,8 +21,11 @@
 
 #include "marker.h"
 #include "element.h"
+#include "minmaxpyramid.h"
 
 #include <cmath>
+#include <memory>
+#include <vector>
 #include <QColor>
 #include <QDateTime>
 
@@ -50,15 +53,16 @@ inline graphstyle_t toGraphStyle(int x){
 }
 
 class Diagram;
+class DataSet;
 
 
 struct DataX {
-  DataX(const QString& Var_, double *Points_=0, int count_=0)
+  DataX(const QString& Var_, const double *Points_=0, int count_=0)
        : Var(Var_), Points(Points_), count(count_), Min(INFINITY), Max(-INFINITY) {};
- ~DataX() { if(Points) delete[] Points; };
   QString Var;
-  double *Points;
+  const double *Points;
   int     count;
+  std::shared_ptr<const void> Storage;  // keeps "Points" alive
 
 public:
   const double& min()const {return Min;}
@@ -125,8 +129,9 @@ public:
   typedef container::iterator iterator;
   typedef container::const_iterator const_iterator;
 
+  void dataSource(const QString& filename, QString& DataFile, QString& Variable) const;
   int loadDatFile(const QString& filename);
-  int loadIndepVarData(const QString&, char* datfilecontent, DataX* where);
+  int loadIndepVarData(const QString&, const DataSet&, DataX* where);
 
   void    paint(QPainter* painter);
   void    paintLines(QPainter* painter);
@@ -146,6 +151,10 @@ public:
   QVector<DataX*>& mutable_axes(){return cPointsX;} // HACK
 
   void clear(){ScrPoints.resize(0);}
+  void setValues(const double* p, std::shared_ptr<const void> s){cPointsY = p; Values = std::move(s); Pyramids.reset();}
+  void releaseValues(){cPointsY = nullptr; Values.reset(); Pyramids.reset();}
+  const MinMaxPyramid* minMaxPyramid(int Branch);
+  std::shared_ptr<const void> valueStorage() const {return Values;}
   void resizeScrPoints(size_t s){assert(s>=ScrPoints.size()); ScrPoints.resize(s);}
   iterator begin(){return ScrPoints.begin();}
   iterator end(){return ScrPoints.end();}
@@ -154,7 +163,7 @@ public:
 
   QDateTime lastLoaded;  // when it was loaded into memory
   int     yAxisNo;       // which y axis is used
-  double *cPointsY;
+  const double *cPointsY;  // shared with other graphs, never write to it
   int     countY;    // number of curves
   QString Var;
   QColor  Color;
@@ -177,6 +186,8 @@ public: // marker related
   Diagram const* parentDiagram() const{return diagram;}
 private:
   QVector<DataX*>  cPointsX;
+  std::shared_ptr<const void> Values; // keeps "cPointsY" alive
+  std::unique_ptr<std::vector<MinMaxPyramid>> Pyramids; // per branch, see minMaxPyramid()
   std::vector<ScrPt> ScrPoints; // data in screen coordinates
   Diagram const* diagram;
 };
@@ -0,0 +1,108 @@
+/***************************************************************************
+                             graphloader.cpp
+                            -----------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "graphloader.h"
+#include "datasetcache.h"
+#include "diagram.h"
+
+#include <QtConcurrent>
+
+GraphLoader::GraphLoader(QObject *parent) : QObject(parent)
+{
+}
+
+GraphLoader::~GraphLoader()
+{
+  cancel();
+  for (QFuture<void>& Worker : Workers)   // they post their results to "this"
+    Worker.waitForFinished();
+}
+
+// ---------------------------------------------------------------------
+/*!
+   Starts loading the data of "Diagrams_". "DataSet_" is the default
+   dataset of the document. A load still running is cancelled.
+*/
+void GraphLoader::load(const QList<Diagram*>& Diagrams_, const QString& DataSet_)
+{
+  cancel();
+  Diagrams = Diagrams_;
+  DataSet = DataSet_;
+  Remaining = Diagrams.size();
+
+  Jobs Work;
+  for (Diagram *pd : Diagrams) {
+    QList<Source> Sources;
+    for (Graph *pg : pd->Graphs) {
+      Source s;
+      pg->dataSource(DataSet, s.DataFile, s.Variable);
+      if (s.Variable.contains('@')) {   // PlotVs() emulation
+        Sources.append(Source{s.DataFile, s.Variable.section('@', 1, 1)});
+        s.Variable = s.Variable.section('@', 0, 0);
+      }
+      Sources.append(s);
+    }
+    Work.append(Sources);
+  }
+
+  Cancelled = std::make_shared<std::atomic_bool>(false);
+  quint64 Current = ++Generation;
+  auto Token = Cancelled;
+  Workers.removeIf([](const QFuture<void>& Worker) { return Worker.isFinished(); });
+  Workers.append(QtConcurrent::run([this, Work, Current, Token] {
+    run(Work, Current, Token);
+  }));
+}
+
+/*!
+   Stops the running load. Diagrams that are not ready yet are not
+   reported anymore.
+*/
+void GraphLoader::cancel()
+{
+  if (Cancelled) *Cancelled = true;
+  Generation++;
+  Remaining = 0;
+}
+
+// ---------------------------------------------------------------------
+// Runs in the worker thread. Parses all variables of one diagram into
+// the cache, then reports the diagram to the GUI thread.
+void GraphLoader::run(const Jobs& Work, quint64 Current,
+                      std::shared_ptr<std::atomic_bool> Token)
+{
+  for (int i = 0; i < Work.size(); i++) {
+    for (const Source& s : Work.at(i)) {
+      if (*Token) return;
+      DataSetPtr ds = DataSetCache::instance().dataSet(s.DataFile, Token.get());
+      if (!ds) continue;
+      DataSetVarPtr pv = ds->variable(s.Variable, Token.get());
+      if (!pv) continue;
+      for (const QString& Dep : pv->Deps)   // independent variables
+        ds->variable(Dep, Token.get());
+    }
+    if (*Token) return;
+    QMetaObject::invokeMethod(this, [this, Current, i] { ready(Current, i); },
+                              Qt::QueuedConnection);
+  }
+}
+
+// Runs in the GUI thread.
+void GraphLoader::ready(quint64 Current, int Index)
+{
+  if (Current != Generation) return;   // result of a cancelled load
+  Remaining--;
+  emit diagramReady(Diagrams.at(Index), DataSet);
+}
@@ -0,0 +1,69 @@
+/***************************************************************************
+                              graphloader.h
+                             ---------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef GRAPHLOADER_H
+#define GRAPHLOADER_H
+
+#include <QFuture>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+
+class Diagram;
+
+/*!
+ * Loads the datasets of the diagrams of one document in a worker thread.
+ *
+ * Only file and variable names are passed to the worker, it never touches
+ * diagrams or graphs. As soon as all variables of a diagram are parsed
+ * into the DataSetCache, diagramReady() is emitted in the GUI thread and
+ * the diagram takes its data from the cache. Starting a new load cancels
+ * the one still running, also within the parsing of a file, so that a new
+ * load of the same file does not wait for it.
+ */
+class GraphLoader : public QObject {
+Q_OBJECT
+public:
+  explicit GraphLoader(QObject *parent = nullptr);
+ ~GraphLoader();
+
+  void load(const QList<Diagram*>&, const QString& DataSet);
+  void cancel();
+  bool isLoading() const { return Remaining > 0; }
+
+signals:
+  void diagramReady(Diagram*, const QString& DataSet);
+
+private:
+  struct Source {
+    QString DataFile, Variable;
+  };
+  typedef QList<QList<Source>> Jobs;   // per diagram
+
+  void run(const Jobs&, quint64 Current, std::shared_ptr<std::atomic_bool> Token);
+  void ready(quint64 Current, int Index);
+
+  quint64 Generation = 0;     // of the current load
+  std::shared_ptr<std::atomic_bool> Cancelled;
+  QList<QFuture<void>> Workers;   // not finished yet, cancelled ones too
+  QList<Diagram*> Diagrams;   // of the current load, in job order
+  QString DataSet;
+  int Remaining = 0;          // diagrams not ready yet
+};
+
+#endif
@@ -100,7 +100,7 @@ void Marker::initText(int n)
   if(pGraph->yAxisNo == 0)  pa = &(diag()->yAxis);
   else  pa = &(diag()->zAxis);
   double Dummy = 0.0;   // needed for 2D graph in 3D diagram
-  double *px, *py=&Dummy, *pz;
+  const double *px, *py=&Dummy, *pz;
   Text = "";
 
   bool isCross = false;
@@ -193,7 +193,7 @@ void Marker::createText()
 
   // independent variables
   Text = "";
-  double *pp;
+  const double *pp;
   nVarPos = pGraph->numAxes();
   DataX const *pD;
 
@@ -294,7 +294,7 @@ void Marker::getTextSize()
 bool Marker::moveLeftRight(bool left)
 {
   int n;
-  double *px;
+  const double *px;
 
   DataX const *pD = pGraph->axis(0);
   px = pD->Points;
@@ -323,7 +323,7 @@ bool Marker::moveLeftRight(bool left)
 bool Marker::moveUpDown(bool up)
 {
   int n, i=0;
-  double *px;
+  const double *px;
 
   DataX const *pD = pGraph->axis(0);
   if(!pD) return false;
@@ -0,0 +1,137 @@
+/***************************************************************************
+                            minmaxpyramid.cpp
+                           -------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "minmaxpyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// running extreme values of a range of samples
+struct Extremes {
+  int Min = -1, Max = -1, AbsMin = -1, AbsMax = -1;
+  double vMin = 0.0, vMax = 0.0, aMin = 0.0, aMax = 0.0;
+  bool Finite = true;
+
+  void add(int i, double v) {
+    if (!std::isfinite(v)) {
+      Finite = false;
+      return;
+    }
+    double a = std::fabs(v);
+    if (Min < 0) {
+      Min = Max = AbsMin = AbsMax = i;
+      vMin = vMax = v;
+      aMin = aMax = a;
+      return;
+    }
+    if (v < vMin) { vMin = v; Min = i; }
+    if (v > vMax) { vMax = v; Max = i; }
+    if (a < aMin) { aMin = a; AbsMin = i; }
+    if (a > aMax) { aMax = a; AbsMax = i; }
+  }
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------
+MinMaxPyramid::MinMaxPyramid(const double* ReIm, int count)
+  : Values(ReIm), Count(count)
+{
+  std::vector<Node> Level;
+  for (int b = 0; b < Count; b += BlockSize) {
+    Extremes e;
+    int End = std::min(b + BlockSize, Count);
+    for (int i = b; i < End; i++)
+      e.add(i, value(i));
+    if (e.Finite) Level.push_back(Node{e.Min, e.Max, e.AbsMin, e.AbsMax});
+    else Level.push_back(Node{-1, -1, -1, -1});
+  }
+
+  // every further level merges "Fanout" nodes until one node is left
+  while (Level.size() > 1) {
+    Levels.push_back(std::move(Level));
+    const std::vector<Node>& Below = Levels.back();
+    Level = std::vector<Node>();
+    for (size_t b = 0; b < Below.size(); b += Fanout) {
+      Node n = Below[b];
+      for (size_t k = b + 1; k < std::min(b + Fanout, Below.size()); k++)
+        merge(n, Below[k]);
+      Level.push_back(n);
+    }
+  }
+  Levels.push_back(std::move(Level));
+}
+
+// ---------------------------------------------------------------------
+// same value as plotted by RectDiagram::calcCoordinate()
+double MinMaxPyramid::value(int i) const
+{
+  double x = Values[2 * i];
+  double y = Values[2 * i + 1];
+  if (std::fabs(y) > 1e-250) return std::sqrt(x * x + y * y);
+  return x;
+}
+
+void MinMaxPyramid::merge(Node& n, const Node& Other) const
+{
+  if (n.Min < 0) return;
+  if (Other.Min < 0) {
+    n.Min = -1;
+    return;
+  }
+  if (value(Other.Min) < value(n.Min)) n.Min = Other.Min;
+  if (value(Other.Max) > value(n.Max)) n.Max = Other.Max;
+  if (std::fabs(value(Other.AbsMin)) < std::fabs(value(n.AbsMin))) n.AbsMin = Other.AbsMin;
+  if (std::fabs(value(Other.AbsMax)) > std::fabs(value(n.AbsMax))) n.AbsMax = Other.AbsMax;
+}
+
+// ---------------------------------------------------------------------
+bool MinMaxPyramid::extrema(int Begin, int End, bool Absolute, Extrema& r) const
+{
+  Extremes e;
+  for (int i = Begin; i < End && e.Finite;) {
+    // take the largest node that lies completely inside of the range
+    int L = -1;
+    long long Size = BlockSize;
+    if (i % BlockSize == 0 && i + Size <= End) {
+      L = 0;
+      while (L + 1 < int(Levels.size()) &&
+             i % (Size * Fanout) == 0 && i + Size * Fanout <= End) {
+        Size *= Fanout;
+        L++;
+      }
+    }
+
+    if (L < 0) {
+      e.add(i, value(i));
+      i++;
+      continue;
+    }
+    const Node& n = Levels[L][i / Size];
+    if (n.Min < 0) return false;
+    e.add(n.Min, value(n.Min));
+    e.add(n.Max, value(n.Max));
+    e.add(n.AbsMin, value(n.AbsMin));
+    e.add(n.AbsMax, value(n.AbsMax));
+    i += Size;
+  }
+  if (!e.Finite || e.Min < 0) return false;
+
+  r.Min = Absolute ? e.AbsMin : e.Min;
+  r.Max = Absolute ? e.AbsMax : e.Max;
+  return true;
+}
@@ -0,0 +1,58 @@
+/***************************************************************************
+                             minmaxpyramid.h
+                            -----------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+#include <vector>
+
+/*!
+ * Extreme values of one branch of a graph, precomputed in blocks of
+ * samples. It answers "which samples of a range have the smallest and the
+ * largest value" without visiting all of them, so that a diagram can draw
+ * a long curve with a few points per pixel column (see Diagram::calcData).
+ *
+ * The value of a sample is the one that RectDiagram::calcCoordinate()
+ * plots, i.e. the magnitude of complex numbers and the real part
+ * otherwise. For logarithmic axes the absolute value is used.
+ */
+class MinMaxPyramid {
+public:
+  MinMaxPyramid(const double* ReIm, int count);
+
+  struct Extrema {
+    int Min, Max;   // sample indices
+  };
+  // Samples [Begin, End). Returns false if the range contains a value
+  // that is not finite, then all samples must be drawn.
+  bool extrema(int Begin, int End, bool Absolute, Extrema& e) const;
+
+private:
+  struct Node {
+    int Min, Max, AbsMin, AbsMax;   // Min < 0: not finite values inside
+  };
+
+  static constexpr int BlockSize = 64;   // samples per node of level 0
+  static constexpr int Fanout = 4;       // nodes merged per next level
+
+  double value(int i) const;
+  void merge(Node& n, const Node& Other) const;
+
+  const double* Values;   // interleaved real/imag, owned by the graph
+  int Count;
+  std::vector<std::vector<Node>> Levels;
+};
+
+#endif
@@ -0,0 +1,175 @@
+/***************************************************************************
+                               qdbfile.cpp
+                              -------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qdbfile.h"
+
+#include <QByteArray>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <QTemporaryFile>
+#include <QtEndian>
+#include <QDebug>
+
+#include <cstring>
+
+namespace qdb {
+
+/*!
+   Returns the name of the .qdb file belonging to a dataset, e.g.
+   "amp.dat" -> "amp.qdb" and "amp.dat.ngspice" -> "amp.qdb.ngspice".
+*/
+QString sidecarName(const QString& datFile)
+{
+  QFileInfo Info(datFile);
+  QString Name = Info.fileName();
+  int pos = Name.lastIndexOf(".dat");
+  if (pos < 0) Name += ".qdb";
+  else Name.replace(pos, 4, ".qdb");
+  return Info.dir().filePath(Name);
+}
+
+/*!
+   The values are stored in the byte order of little-endian hosts and are
+   used directly from the mapped file. Other hosts use the text dataset.
+*/
+bool isSupported()
+{
+  return QSysInfo::ByteOrder == QSysInfo::LittleEndian;
+}
+
+// ---------------------------------------------------------------------
+Writer::Writer() = default;
+Writer::~Writer() = default;
+
+void Writer::addIndep(const QString& Name, const std::vector<double>& Values)
+{
+  if (spool(Values))
+    Vars.push_back(Var{Name, QStringList(), Indep, Values.size()});
+}
+
+void Writer::addDep(const QString& Name, const QStringList& Deps,
+                    const std::vector<double>& ReIm, bool isComplex)
+{
+  if (spool(ReIm))
+    Vars.push_back(Var{Name, Deps, quint32(isComplex ? Complex : 0), ReIm.size() / 2});
+}
+
+void Writer::clear()
+{
+  Vars.clear();
+  Spool.reset();
+  Failed = false;
+}
+
+/*!
+   Appends the values to the spool file. After an error no .qdb file is
+   written at all, the text dataset is used then.
+*/
+bool Writer::spool(const std::vector<double>& Values)
+{
+  if (Failed || !isSupported()) return false;
+  if (!Spool) {
+    Spool = std::make_unique<QTemporaryFile>();
+    if (!Spool->open()) {
+      Failed = true;
+      return false;
+    }
+  }
+  qint64 Bytes = Values.size() * sizeof(double);
+  if (Spool->write(reinterpret_cast<const char*>(Values.data()), Bytes) != Bytes) {
+    Failed = true;
+    return false;
+  }
+  return true;
+}
+
+// ---------------------------------------------------------------------
+static void appendU32(QByteArray& Buffer, quint32 Value)
+{
+  Value = qToLittleEndian(Value);
+  Buffer.append(reinterpret_cast<const char*>(&Value), sizeof(Value));
+}
+
+static void appendU64(QByteArray& Buffer, quint64 Value)
+{
+  Value = qToLittleEndian(Value);
+  Buffer.append(reinterpret_cast<const char*>(&Value), sizeof(Value));
+}
+
+static void appendString(QByteArray& Buffer, const QString& Text)
+{
+  QByteArray Utf8 = Text.toUtf8();
+  appendU32(Buffer, Utf8.size());
+  Buffer.append(Utf8);
+}
+
+static inline quint64 align8(quint64 Offset)
+{
+  return (Offset + 7) & ~quint64(7);
+}
+
+/*!
+   Writes all collected variables. The file is replaced atomically, so a
+   reader never sees a partly written .qdb file.
+*/
+bool Writer::write(const QString& fileName)
+{
+  if (Failed || !Spool) return false;
+
+  // The directory is built with placeholder offsets first, because its
+  // size determines where the values start.
+  QByteArray Header(Magic, sizeof(Magic));
+  appendU32(Header, Version);
+  appendU32(Header, Vars.size());
+
+  std::vector<int> OffsetPos;
+  for (const Var& v : Vars) {
+    appendU32(Header, v.Flags);
+    appendU64(Header, v.Count);
+    OffsetPos.push_back(Header.size());
+    appendU64(Header, 0);
+    appendString(Header, v.Name);
+    appendU32(Header, v.Deps.size());
+    for (const QString& Dep : v.Deps)
+      appendString(Header, Dep);
+  }
+  Header.append(QByteArray(align8(Header.size()) - Header.size(), '\0'));
+
+  quint64 Offset = Header.size();
+  for (size_t i = 0; i < Vars.size(); i++) {
+    quint64 le = qToLittleEndian(Offset);
+    memcpy(Header.data() + OffsetPos[i], &le, sizeof(le));
+    bool isIndep = (Vars[i].Flags & Indep);
+    Offset += (isIndep ? Vars[i].Count : 2 * Vars[i].Count) * sizeof(double);
+  }
+
+  // the values follow the directory in the order they were spooled
+  QSaveFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly)) return false;
+  file.write(Header);
+  Spool->seek(0);
+  QByteArray Block;
+  while (!(Block = Spool->read(1 << 20)).isEmpty())
+    file.write(Block);
+  if (!file.commit()) {
+    qDebug() << "qdb::Writer: cannot write" << fileName;
+    return false;
+  }
+  return true;
+}
+
+} // namespace qdb
@@ -0,0 +1,95 @@
+/***************************************************************************
+                                qdbfile.h
+                               -----------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QDBFILE_H
+#define QDBFILE_H
+
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <vector>
+
+class QTemporaryFile;
+
+/*!
+ * \file qdbfile.h
+ * \brief Binary columnar sidecar of a Qucs dataset (.qdb).
+ *
+ * The text dataset (.dat) remains the interchange format. The simulator
+ * kernels additionally write a .qdb file next to it, which the dataset
+ * cache maps into memory instead of parsing the text.
+ *
+ * Layout, all integers and doubles little-endian:
+ * \code
+ *   char    magic[8]         "QUCSQDB" + '\0'
+ *   quint32 version          qdb::Version
+ *   quint32 number of variables
+ *   directory, one entry per variable:
+ *     quint32 flags          qdb::Indep, qdb::Complex
+ *     quint64 count          number of values
+ *     quint64 offset         of the values from file start, 8-byte aligned
+ *     quint32 length, name   UTF-8
+ *     quint32 number of dependencies
+ *       quint32 length, name UTF-8
+ *   padding to 8 bytes
+ *   values: "count" doubles for independent variables, 2*"count"
+ *           interleaved real/imag doubles for dependent variables (the
+ *           imaginary parts are zero unless the "Complex" flag is set)
+ * \endcode
+ */
+namespace qdb {
+
+constexpr char Magic[8] = {'Q', 'U', 'C', 'S', 'Q', 'D', 'B', '\0'};
+constexpr quint32 Version = 1;
+
+enum Flags { Indep = 1, Complex = 2 };
+
+QString sidecarName(const QString& datFile);
+bool isSupported();
+
+/*!
+ * Collects the variables of one dataset and writes them as .qdb file. The
+ * values are spooled to a temporary file as they are added, so only the
+ * directory is kept in memory.
+ */
+class Writer {
+public:
+  Writer();
+  ~Writer();
+
+  void addIndep(const QString& Name, const std::vector<double>& Values);
+  void addDep(const QString& Name, const QStringList& Deps,
+              const std::vector<double>& ReIm, bool isComplex);
+  bool write(const QString& fileName);
+  void clear();
+
+private:
+  bool spool(const std::vector<double>& Values);
+
+  struct Var {
+    QString Name;
+    QStringList Deps;
+    quint32 Flags;
+    quint64 Count;
+  };
+  std::vector<Var> Vars;
+  std::unique_ptr<QTemporaryFile> Spool;   // values of "Vars" in order
+  bool Failed = false;
+};
+
+} // namespace qdb
+
+#endif
@@ -385,7 +385,7 @@ int Rect3DDiagram::comparePointZ(const void *Point1, const void *Point2)
 void Rect3DDiagram::removeHiddenLines(char *zBuffer, tBound *Bounds)
 {
   double Dummy = 0.0;  // number for 1-dimensional data in 3D cartesian
-  double *px, *py, *pz;
+  const double *px, *py, *pz;
 
   tPoint3D *p;
   int i, j, z, dx, dy, Size=0;
@@ -792,8 +792,7 @@ void Rect3DDiagram::createAxis(Axis *Axis, bool Right,
       if(Axis != &zAxis) {
         if(!pg->cPointsY)  continue;
         if(valid < 0) {
-          delete[] pg->cPointsY;
-          pg->cPointsY = 0;
+          pg->releaseValues();
           continue;
         }
         pD = pg->axis(Index);
@@ -58,6 +58,7 @@ public:
 
 protected:
   void calcData(Graph*);
+  bool parallelCalcData() const override { return false; }   // uses "Mem"
 
 private:
   int  calcAxis(Axis*, int, int, double, double);
@@ -39,6 +39,7 @@ public:
 
 protected:
   void clip(Graph::iterator &) const;
+  bool decimateData() const override { return true; }
 };
 
 #endif
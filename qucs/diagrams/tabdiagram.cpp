@@ -48,6 +48,7 @@ TabDiagram::~TabDiagram()
 
 void TabDiagram::paint(QPainter* painter) {
     paintDiagram(painter);
+    paintLoadingState(painter);
 }
 
 void TabDiagram::paintDiagram(QPainter *painter) {
@@ -176,7 +177,7 @@ int TabDiagram::calcDiagram()
   int NumAll=0;   // how many numbers per column
   int NumLeft=0;  // how many numbers could not be written
 
-  double *py, *px;
+  const double *py, *px;
   int counting, invisibleCount=0;
   int startWriting, lastCount = 1;
 
@@ -47,6 +47,7 @@ TimingDiagram::~TimingDiagram()
 
 void TimingDiagram::paint(QPainter *painter) {
     paintDiagram(painter);
+    paintLoadingState(painter);
 }
 
 void TimingDiagram::paintDiagram(QPainter *painter) {
@@ -170,7 +171,7 @@ int TimingDiagram::calcDiagram()
   }
 
 
-  double *px;
+  const double *px;
   // any graph with data ?
   while(g->isEmpty()) {
     if (!ig.hasNext()) break; // no more graphs, exit loop
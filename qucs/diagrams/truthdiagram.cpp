@@ -169,7 +169,7 @@ int TruthDiagram::calcDiagram()
       if(sameDependencies(g, firstGraph)) {
 
         if(g->Var.right(2) != ".X") {  // not a digital variable ?
-          double *pdy = g->cPointsY - 2;
+          const double *pdy = g->cPointsY - 2;
           for(z = NumAll; z>0; z--) {
             pdy += 2;
             if(startWriting-- > 0) continue; // reached visible area ?
@@ -155,6 +155,12 @@ QucsSettingsDialog::QucsSettingsDialog(QucsApp *parent)
     allowLayingWiresAnew = new QCheckBox(appSettingsTab);
     appSettingsGrid->addWidget(allowLayingWiresAnew, 8, 1);
 
+    appSettingsGrid->addWidget(new QLabel(tr("Dataset cache size (MB):"), appSettingsTab), 9, 0);
+    dataSetCacheEdit = new QLineEdit(appSettingsTab);
+    dataSetCacheEdit->setValidator(new QIntValidator(16, 65536, this));
+    dataSetCacheEdit->setToolTip(tr("Memory used to keep parsed simulation results for all diagrams."));
+    appSettingsGrid->addWidget(dataSetCacheEdit, 9, 1);
+
     t->addTab(appSettingsTab, tr("Settings"));
 
     // ...........................................................
@@ -516,6 +522,7 @@ QucsSettingsDialog::QucsSettingsDialog(QucsApp *parent)
     GridColorButton->setPalette(p);
 
     undoNumEdit->setText(QString::number(QucsSettings.maxUndo));
+    dataSetCacheEdit->setText(QString::number(QucsSettings.DataSetCacheSize));
     editorEdit->setText(QucsSettings.Editor);
     checkWiring->setChecked(QucsSettings.NodeWiring);
     allowFlexibleWires->setChecked(_settings::Get().item<bool>("AllowFlexibleWires"));
@@ -730,6 +737,11 @@ void QucsSettingsDialog::slotApply()
         QucsSettings.maxUndo = undoNumEdit->text().toInt(&ok);
         changed = true;
     }
+    if(QucsSettings.DataSetCacheSize != dataSetCacheEdit->text().toUInt(&ok))
+    {
+        QucsSettings.DataSetCacheSize = dataSetCacheEdit->text().toUInt(&ok);
+        changed = true;
+    }
     if(QucsSettings.Editor != editorEdit->text())
     {
         QucsSettings.Editor = editorEdit->text();
@@ -937,6 +949,7 @@ void QucsSettingsDialog::slotDefaultValues()
     ColorTask->setPalette(p);
 
     undoNumEdit->setText("20");
+    dataSetCacheEdit->setText("512");
     editorEdit->setText(QucsSettings.BinDir + "qucs");
     checkWiring->setChecked(false);
     allowFlexibleWires->setChecked(_settings::Get().itemDefault<bool>("AllowFlexibleWires"));
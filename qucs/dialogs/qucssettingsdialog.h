@@ -92,7 +92,7 @@ public:
     QComboBox *LanguageCombo,
               *StyleCombo;
     QPushButton *FontButton, *AppFontButton, *TextFontButton, *BGColorButton, *GridColorButton;
-    QLineEdit *LargeFontSizeEdit, *undoNumEdit, *editorEdit, *Input_Suffix,
+    QLineEdit *LargeFontSizeEdit, *undoNumEdit, *dataSetCacheEdit, *editorEdit, *Input_Suffix,
               *Input_Program, *homeEdit, *admsXmlEdit, *ascoEdit, *octaveEdit,
               *OpenVAFEdit, *RFLayoutEdit, *graphLineWidthEdit;
     QTableWidget *fileTypesTableWidget, *pathsTableWidget;
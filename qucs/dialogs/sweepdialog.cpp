@@ -32,7 +32,7 @@
 #include <QPushButton>
 
 // SpinBoxes are used to show the calculated bias points at the given set of sweep points
-mySpinBox::mySpinBox(int Min, int Max, int Step, double *Val, QWidget *Parent)
+mySpinBox::mySpinBox(int Min, int Max, int Step, const double *Val, QWidget *Parent)
           : QSpinBox(Parent)
 {
   setMinimum(Min);
@@ -130,10 +130,6 @@ SweepDialog::SweepDialog(Schematic *Doc_,QHash<QString,double> *NodeVals)
 SweepDialog::~SweepDialog()
 {
   delete pGraph;
-
-  while(!ValueList.isEmpty()) {
-    delete ValueList.takeFirst();
-  }
 }
 
 // ---------------------------------------------------------------
@@ -150,7 +146,7 @@ void SweepDialog::slotNewValue(int)
   Index *= 2;  // because of complex values
 
   QList<Node *>::iterator node_it;
-  QList<double *>::const_iterator value_it = ValueList.begin();
+  QList<const double *>::const_iterator value_it = ValueList.begin();
   for(node_it = NodeList.begin(); node_it != NodeList.end(); node_it++) {
     qDebug() << "SweepDialog::slotNewValue:(*node_it)->Name:" << (*node_it)->Name;
     (*node_it)->Name = misc::num2str(*((*value_it)+Index));
@@ -181,6 +177,7 @@ Graph* SweepDialog::setBiasPoints(QHash<QString,double> *NodeVals)
 
   NodeList.clear();
   ValueList.clear();
+  ValueStorage.clear();
 
   // create DC voltage for all nodes
   for(Node* pn : *Doc->a_Nodes) {
@@ -219,7 +216,7 @@ Graph* SweepDialog::setBiasPoints(QHash<QString,double> *NodeVals)
           pn->Name = misc::num2str(*(pg->cPointsY)) + "V";
           NodeList.append(pn);             // remember node ...
           ValueList.append(pg->cPointsY);  // ... and all of its values
-          pg->cPointsY = 0;   // do not delete it next time !
+          ValueStorage.append(pg->valueStorage());
         }
         else
           pn->Name = "0V";
@@ -255,7 +252,7 @@ Graph* SweepDialog::setBiasPoints(QHash<QString,double> *NodeVals)
             pn->Name = misc::num2str(*(pg->cPointsY)) + "A";
             NodeList.append(pn);             // remember node ...
             ValueList.append(pg->cPointsY);  // ... and all of its values
-            pg->cPointsY = 0;   // do not delete it next time !
+            ValueStorage.append(pg->valueStorage());
           }
           else
             pn->Name = "0A";
@@ -27,6 +27,8 @@
 
 #include "node.h"
 
+#include <memory>
+
 class Graph;
 class Schematic;
 class QGridLayout;
@@ -34,14 +36,14 @@ class QGridLayout;
 class mySpinBox : public QSpinBox {
    Q_OBJECT
 public:
-  mySpinBox(int, int, int, double*, QWidget*);
+  mySpinBox(int, int, int, const double*, QWidget*);
 
 protected:
   QString textFromValue(int) const;
   QValidator::State validate ( QString & text, int & pos ) const;
 
 private:
-  double *Values = NULL;
+  const double *Values = NULL;
   int ValueSize;
 };
 
@@ -63,7 +65,8 @@ private:
   Graph *pGraph;
   Schematic *Doc;
   QList<Node *> NodeList;
-  QList<double *> ValueList;
+  QList<const double *> ValueList;
+  QList<std::shared_ptr<const void>> ValueStorage;  // keeps "ValueList" alive
   bool isSpice;
 };
 
@@ -19,8 +19,12 @@
 #include "main.h"
 #include "schematic.h"
 #include "extsimkernels/spicecompat.h"
+#include "extsimkernels/externsimdialog.h"
+#include "extsimkernels/ngspicesession.h"
 
 #include <QCloseEvent>
+#include <QDir>
+#include <QFileInfo>
 
 bool isPropertyTunable(Component* propertyOwner, Property* property) {
   // Simulation parameters
@@ -312,6 +316,7 @@ void tunerElement::updateProperty()
   } else {
     prop->Value = new_value + suffix;
   }
+  c->markChanged();
 }
 
 
@@ -659,7 +664,7 @@ tunerElement::~tunerElement()
 
 //Main window. It contains zero or more tunerElement objects
 TunerDialog::TunerDialog(QWidget *_w, QWidget *parent) :
- QDialog(parent), w(_w)
+ QDialog(parent), w(_w), session(nullptr)
 {
     setAttribute(Qt::WA_DeleteOnClose);//This attribute forces the widget to be destroyed after closing
     qDebug() << "Tuner::TunerDialog";
@@ -806,6 +811,9 @@ void TunerDialog::slotElementValueUpdated()
         QucsMain->slotSimulate(w);
         break;
     case spicecompat::simNgspice:
+        if (simulateInSession()) break;
+        QucsMain->slotSimulateWithSpice();
+        break;
     case spicecompat::simXyce:
     case spicecompat::simSpiceOpus:
         QucsMain->slotSimulateWithSpice();
@@ -814,6 +822,49 @@ void TunerDialog::slotElementValueUpdated()
     }
 }
 
+/*
+Simulates in the Ngspice process that is kept between the simulations, so
+only the changed values are passed to Ngspice. Returns false if the schematic
+has to be simulated the usual way, e.g. to show the DC bias.
+*/
+bool TunerDialog::simulateInSession()
+{
+    Schematic *sch = dynamic_cast<Schematic*>(w);
+    if (sch == nullptr || sch->getDocName().isEmpty() || sch->getShowBias() == 0)
+        return false;
+
+    if (session == nullptr) {
+        session = new NgspiceSession(sch, this);
+        connect(session, SIGNAL(finished()), this, SLOT(slotSessionFinished()));
+        connect(session, SIGNAL(progress(int)), this, SLOT(slotUpdateProgressBar(int)));
+    }
+    QList<Component*> tuned;
+    for (tunerElement *element : currentElements)
+        tuned.append(element->c);
+    if (session->simulate(tuned)) return true;
+
+    delete session; // the usual simulation reports the problems
+    session = nullptr;
+    return false;
+}
+
+void TunerDialog::slotSessionFinished()
+{
+    Schematic *sch = dynamic_cast<Schematic*>(w);
+    if (ExternSimDialog::logContainsError(session->getOutput())) {
+        session->deleteLater(); // the usual simulation shows the log
+        session = nullptr;
+        QucsMain->slotSimulateWithSpice();
+        return;
+    }
+    QFileInfo inf(sch->getDocName());
+    session->convertToQucsData(inf.canonicalPath()+QDir::separator()+inf.completeBaseName()+".dat.ngspice");
+
+    // the data display may be open instead of the schematic
+    Schematic *shown = dynamic_cast<Schematic*>(QucsMain->DocumentTab->currentWidget());
+    QucsMain->showSpiceResults(shown != nullptr ? shown : sch, true);
+}
+
 void TunerDialog::SimulationEnded()
 {
     qDebug() << "Tuner::SimulationEnded()";
@@ -866,6 +917,8 @@ void TunerDialog::slotResetTunerDialog()
     // Document closed. Reset tuner
     qDebug() << "Tuner::slotResetTunerDialog()";
     infoMsg("Document closed");
+    delete session;
+    session = nullptr;
     for (int i = 0; i < currentElements.count(); i++)
     {
        qDebug() << "Tuner::slotResetTunerDialog()::delete";
@@ -45,6 +45,8 @@
 
 extern QucsApp *QucsMain;  // the Qucs application itself
 
+class NgspiceSession;
+
 float getScale(int);
 QString SeparateMagnitudeFromSuffix(QString num, int &);
 bool isPropertyTunable(Component* propertyOwner, Property* property);
@@ -135,8 +137,10 @@ private:
     bool valuesUpdated;
     QProgressBar *progressBar;
     QPushButton *updateValues, *resetValues;//They're private in order to make enable or disable them
+    NgspiceSession *session; // Ngspice kept running between the simulations
 
     void blockInput(bool enabled);
+    bool simulateInSession();
     void closeEvent(QCloseEvent *event);
     void infoMsg(const QString msg);
 
@@ -147,6 +151,7 @@ private slots:
     void slotResetValues();
     bool checkChanges();
     void slotUpdateProgressBar(int);
+    void slotSessionFinished();
 };
 
 #endif // TUNER_H
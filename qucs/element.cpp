@@ -118,11 +118,24 @@ bool Element::moveCenterTo(const QPoint& p) noexcept
 
 bool Element::moveCenter(int dx, int dy) noexcept
 {
+  markChanged();
   cx += dx;
   cy += dy;
   return dx != 0 || dy != 0;
 }
 
+// The log is kept short. A document that has not read it for a long
+// time finds its position dropped. It rebuilds its indices instead and
+// compares all of its elements for the next undo step.
+void Element::markChanged() noexcept
+{
+  if (ChangeLog.size() >= 262144) {
+    ChangeLogBegin += ChangeLog.size();
+    ChangeLog.clear();
+  }
+  ChangeLog.push_back(this);
+}
+
 bool Element::rotate(int rcx, int rcy) noexcept
 {
   int ncx = cx;
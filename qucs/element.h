@@ -38,6 +38,7 @@
 #define ELEMENT_H
 
 #include <QPen>
+#include <span>
 #include <vector>
 
 class Node;
@@ -258,6 +259,25 @@ public:
   int y1 = 0;
   int x2 = 0;
   int y2 = 0;
+
+  /** Records that the element changed: its area, its properties or anything
+      else it saves. Every document reads the records from its last position
+      on, to update its spatial indices in place (see
+      Schematic::ensureWireIndex()) and to save only the changed elements
+      for undo (see Schematic::pushUndoState()). */
+  void markChanged() noexcept;
+
+  /** Position after the last record */
+  static quint64 changeLogEnd() noexcept { return ChangeLogBegin + ChangeLog.size(); }
+  /** Position of the oldest record kept, the older ones were dropped */
+  static quint64 changeLogBegin() noexcept { return ChangeLogBegin; }
+  /** Elements recorded from position "pos" on, which must still be kept */
+  static std::span<Element* const> changeLogSince(quint64 pos) noexcept
+  { return std::span<Element* const>(ChangeLog).subspan(pos - ChangeLogBegin); }
+
+private:
+  static inline std::vector<Element*> ChangeLog;
+  static inline quint64 ChangeLogBegin = 0;
 };
 
 #endif
@@ -28,10 +28,17 @@
 #include "../paintings/id_text.h"
 #include "dialogs/sweepdialog.h"
 #include "components/subcircuit.h"
+#include "diagrams/datasetwriter.h"
+#include "extsimkernels/externsimdialog.h"
+#include "extsimkernels/simresultcache.h"
 #include "wire.h"
 
 
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QPlainTextEdit>
+#include <QStandardPaths>
+#include <QtEndian>
 #include <algorithm>
 
 /*!
@@ -39,6 +46,22 @@
   \brief Implementation of the AbstractSpiceKernel class
 */
 
+/*!
+ * \brief mapOutputFile Maps a simulator output file into memory, so that its
+ *        binary section is read in place. Falls back to reading the file.
+ *        The returned data is valid as long as \a file is open.
+ */
+static QByteArray mapOutputFile(QFile &file)
+{
+    if (!file.open(QFile::ReadOnly)) return QByteArray();
+    qint64 size = file.size();
+    if (size > 0) {
+        uchar *data = file.map(0, size);
+        if (data) return QByteArray::fromRawData(reinterpret_cast<const char*>(data), size);
+    }
+    return file.readAll();
+}
+
 
 /*!
  * \brief AbstractSpiceKernel::AbstractSpiceKernel class constructor
@@ -61,7 +84,10 @@ AbstractSpiceKernel::AbstractSpiceKernel(Schematic *schematic, QObject *parent)
     a_needsPrefix(false),
     a_schematic(schematic),
     a_parseFourTHD(false),
-    a_parsePZzeros(false)
+    a_parsePZzeros(false),
+    a_useResultCache(true),
+    a_cachedResult(false),
+    a_resultKey()
 {
     if (!checkDCSimulation()) { // Run Show bias mode automatically
         a_DC_OP_only = true;      // If schematic contains DC simulation only
@@ -91,11 +117,77 @@ AbstractSpiceKernel::~AbstractSpiceKernel()
 
 void AbstractSpiceKernel::killThemAll()
 {
+    a_resultKey.clear(); // the output is incomplete
     if (a_simProcess->state()!=QProcess::NotRunning) {
         a_simProcess->kill();
     }
 }
 
+/*!
+ * \brief AbstractSpiceKernel::resultCacheKey Compute the key of a simulation
+ *        result. It covers the netlist, the content of all included library
+ *        files and the simulator. The path, size and date of the simulator
+ *        executable stand for its version, which saves starting it once more.
+ * \param netlist Netlist and other simulator input
+ */
+QString AbstractSpiceKernel::resultCacheKey(const QByteArray &netlist)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(netlist);
+    for (const QString &lib : collectSpiceLibraryFiles(a_schematic)) {
+        hash.addData(lib.toUtf8());
+        QFile file(lib);
+        if (file.open(QIODevice::ReadOnly)) hash.addData(&file);
+    }
+
+    QString exe = QFileInfo(a_simulator_cmd).isAbsolute() ? a_simulator_cmd
+                    : QStandardPaths::findExecutable(a_simulator_cmd);
+    QFileInfo inf(exe);
+    QString sim = QStringLiteral("%1|%2|%3|%4|%5|%6")
+                      .arg(PACKAGE_VERSION)
+                      .arg(QucsSettings.DefaultSimulator)
+                      .arg(inf.absoluteFilePath())
+                      .arg(inf.size())
+                      .arg(inf.lastModified().toMSecsSinceEpoch())
+                      .arg(a_simulator_parameters);
+    hash.addData(sim.toUtf8());
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+/*!
+ * \brief AbstractSpiceKernel::lookupResultCache Look up the result of the
+ *        simulation in the result cache. On a hit the cached log is shown
+ *        and finished() is emitted as soon as the event loop runs, the
+ *        simulator is not started. convertToQucsData() then restores the
+ *        cached dataset. A simulation that is actually run is stored in
+ *        the cache by convertToQucsData().
+ * \param netlist Netlist and other simulator input
+ * \return True if the cached result is used.
+ */
+bool AbstractSpiceKernel::lookupResultCache(const QByteArray &netlist)
+{
+    a_cachedResult = false;
+    a_resultKey.clear();
+    if (a_DC_OP_only || SimResultCache::maxSize() == 0) return false;
+    a_resultKey = resultCacheKey(netlist);
+    if (!a_useResultCache || !SimResultCache::contains(a_resultKey)) return false;
+
+    a_cachedResult = true;
+    a_output = SimResultCache::log(a_resultKey);
+    emit started();
+    if (a_console != nullptr) {
+        a_console->insertPlainText(tr("Result of an identical simulation is taken from the cache\n"));
+        a_console->insertPlainText(a_output);
+        a_console->moveCursor(QTextCursor::End);
+    }
+    // finished() must not arrive before the caller has returned
+    QMetaObject::invokeMethod(this, [this]() {
+        emit finished();
+        emit progress(100);
+    }, Qt::QueuedConnection);
+    return true;
+}
+
 /*!
  * \brief AbstractSpiceKernel::prepareSpiceNetlist Fill components nodes
  *        with approate node numbers
@@ -336,27 +428,23 @@ void AbstractSpiceKernel::slotSimulate()
  *        output. Extracts a simulation points array and variables names and types (Real
  *        or Complex) from output.
  * \param ngspice_file Spice output file name
- * \param sim_points 2D array in which simulation points should be extracted
+ * \param sim_points Columns into which the simulation points are extracted. The
+ *        "Binary:" section is split into the columns in place, without copying the file.
  * \param var_list This list is filled by simulation variables. There is a list of dependent
  *        and independent variables. An independent variable is the first in list.
  * \param isComplex Type of variables. True if complex. False if real.
  */
-void AbstractSpiceKernel::parseNgSpiceSimOutput(QString ngspice_file, QList< QList<double> > &sim_points,
+void AbstractSpiceKernel::parseNgSpiceSimOutput(QString ngspice_file, SimPointColumns &sim_points,
                                                 QStringList &var_list, bool &isComplex,
                                                 QStringList &digital_vars, QList<int> &dig_vars_dims)
 {
     isComplex = false;
     bool isBinary = false;
     int NumPoints = 0;
-    int bin_offset = 0;
-    QByteArray content;
+    qint64 bin_offset = 0;
 
     QFile ofile(ngspice_file);
-    if (ofile.open(QFile::ReadOnly)) {
-        //QTextStream ts(&ofile);
-        content = ofile.readAll();
-        ofile.close();
-    }
+    QByteArray content = mapOutputFile(ofile);
 
     QTextStream ngsp_data(&content);
     sim_points.clear();
@@ -405,10 +493,8 @@ void AbstractSpiceKernel::parseNgSpiceSimOutput(QString ngspice_file, QList< QLi
         }
 
         if (isBinary) {
-            QDataStream dbl(content);
-            dbl.setByteOrder(QDataStream::LittleEndian);
-            dbl.device()->seek(bin_offset);
-            extractBinSamples(dbl, sim_points, NumPoints, NumVars, isComplex);
+            sim_points.appendBinary(content.constData() + bin_offset, content.size() - bin_offset,
+                                    NumPoints, NumVars, isComplex);
             break;
         }
 
@@ -752,26 +838,22 @@ void AbstractSpiceKernel::parseDC_OPoutputXY(QString xyce_file)
  *        Extracts a simulation points array and variables names and types (Real
  *        or Complex) from output.
  * \param ngspice_file Spice output file name
- * \param sim_points 2D array in which simulation points should be extracted. All simulation
- *        points from all sweep variable steps are extracted in a single array
+ * \param sim_points Columns into which the simulation points are extracted. All simulation
+ *        points from all sweep variable steps are extracted in the same columns
  * \param var_list This list is filled by simulation variables. There is a list of dependent
  *        and independent variables. An independent variable is the first in list.
  * \param isComplex Type of variables. True if complex. False if real.
  */
 void AbstractSpiceKernel::parseSTEPOutput(QString ngspice_file,
-                     QList< QList<double> > &sim_points,
+                     SimPointColumns &sim_points,
                      QStringList &var_list, bool &isComplex)
 {
     isComplex = false;
     bool isBinary = false;
-    int bin_offset = 0;
-    QByteArray content;
+    qint64 bin_offset = 0;
 
     QFile ofile(ngspice_file);
-    if (ofile.open(QFile::ReadOnly)) {
-        content = ofile.readAll();
-        ofile.close();
-    }
+    QByteArray content = mapOutputFile(ofile);
 
     QTextStream ngsp_data(&content);
     sim_points.clear();
@@ -825,12 +907,10 @@ void AbstractSpiceKernel::parseSTEPOutput(QString ngspice_file,
         }
 
         if (isBinary) {
-            QDataStream dbl(content);
-            dbl.setByteOrder(QDataStream::LittleEndian);
-            dbl.device()->seek(bin_offset);
-            extractBinSamples(dbl,sim_points,NumPoints,NumVars,isComplex);
-            int pos = dbl.device()->pos();
-            ngsp_data.seek(pos);
+            qint64 bytes = sim_points.appendBinary(content.constData() + bin_offset,
+                                                content.size() - bin_offset,
+                                                NumPoints, NumVars, isComplex);
+            ngsp_data.seek(bin_offset + bytes);
             isBinary = false;
             continue;
         }
@@ -886,34 +966,75 @@ void AbstractSpiceKernel::parsePrnOutput(const QString &ngspice_file,
     }
 }
 
-void AbstractSpiceKernel::extractBinSamples(QDataStream &dbl, QList<QList<double> > &sim_points,
-                                            int NumPoints, int NumVars, bool isComplex)
+// ---------------------------------------------------------------------
+// Adds columns up to "NumColumns", padded to the current number of points.
+void SimPointColumns::resizeColumns(int NumColumns)
 {
-    int cnt = NumPoints;
-    while (cnt>0) {
-        QList<double> sim_point;
-        double re,im;
-        dbl>>re; // Indep. variable
-        sim_point.append(re);
-        if (isComplex) dbl>>im; // drop Im part of indep.var
-        for (int i=1;i<NumVars;i++) { // first variable is independent
-            if (isComplex) {
-                dbl>>re; // Re
-                dbl>>im; // Im
-                sim_point.append(re);
-                sim_point.append(im);
-            } else {
-                dbl>>re;
-                sim_point.append(re); // Re
-            }
+    size_t NumPoints = count();
+    while (int(a_columns.size()) < NumColumns)
+        a_columns.emplace_back(NumPoints, 0.0);
+}
+
+void SimPointColumns::appendRow(const QList<double> &row)
+{
+    resizeColumns(row.size());
+    for (size_t i = 0; i < a_columns.size(); i++)
+        a_columns[i].push_back(int(i) < row.size() ? row.at(i) : 0.0);
+}
+
+void SimPointColumns::appendRows(const QList< QList<double> > &rows)
+{
+    for (const auto &row : rows)
+        appendRow(row);
+}
+
+void SimPointColumns::appendPoint(const double *values, int NumColumns)
+{
+    resizeColumns(NumColumns);
+    for (size_t i = 0; i < a_columns.size(); i++)
+        a_columns[i].push_back(int(i) < NumColumns ? values[i] : 0.0);
+}
+
+/*!
+ * \brief SimPointColumns::appendBinary Appends the "Binary:" section of a spice
+ *        raw file. The points are stored one after another there, every value as
+ *        little-endian double. The section is split into the columns in a single
+ *        pass, each column is allocated once.
+ * \param data Start of the binary section
+ * \param size Number of bytes up to the end of the file
+ * \return Number of bytes read
+ */
+qint64 SimPointColumns::appendBinary(const char *data, qint64 size, int NumPoints,
+                                     int NumVars, bool isComplex)
+{
+    if (NumVars <= 0 || NumPoints <= 0) return 0;
+    const int stride = isComplex ? 2*NumVars : NumVars; // doubles per point
+    const qint64 point_bytes = stride*qint64(sizeof(double));
+    NumPoints = std::min<qint64>(NumPoints, size/point_bytes); // truncated output
+
+    const int NumColumns = isComplex ? 2*NumVars-1 : NumVars; // no Im part of indep.var
+    resizeColumns(NumColumns);
+    for (auto &col : a_columns)
+        col.reserve(col.size() + NumPoints);
+
+    for (int p = 0; p < NumPoints; p++) {
+        const char *point = data + p*point_bytes;
+        a_columns[0].push_back(qFromLittleEndian<double>(point)); // Indep. variable
+        if (isComplex) {
+            for (int col = 1; col < NumColumns; col++) // Re, Im, Re, Im, ...
+                a_columns[col].push_back(qFromLittleEndian<double>(point + (col+1)*sizeof(double)));
+        } else {
+            for (int col = 1; col < NumColumns; col++)
+                a_columns[col].push_back(qFromLittleEndian<double>(point + col*sizeof(double)));
         }
-        sim_points.append(sim_point);
-        cnt--;
     }
+    for (size_t col = NumColumns; col < a_columns.size(); col++)
+        a_columns[col].resize(count(), 0.0); // keep all columns of equal length
+    return NumPoints*point_bytes;
 }
 
 bool AbstractSpiceKernel::extractASCIISamples(QString &lin, QTextStream &ngsp_data,
-                                              QList<QList<double> > &sim_points, int NumVars, bool isComplex)
+                                              SimPointColumns &sim_points, int NumVars, bool isComplex)
 {
     QRegularExpression sep("[ \t,]");
     QList<double> sim_point;
@@ -938,7 +1059,7 @@ bool AbstractSpiceKernel::extractASCIISamples(QString &lin, QTextStream &ngsp_da
             sim_point.append(dep_val);
         }
     }
-    sim_points.append(sim_point);
+    sim_points.appendRow(sim_point);
     return true;
 }
 
@@ -1160,17 +1281,36 @@ void AbstractSpiceKernel::convertToQucsData(const QString &qucs_dataset)
         return;
     }
 
-    // Merge all outputs in a single Qucs dataset otherwise
-    QString ds_str;
-    QTextStream ds_stream(&ds_str);
+    if (a_cachedResult) {
+        if (!SimResultCache::restore(a_resultKey, qucs_dataset)) {
+            QFileInfo inf(qucs_dataset);
+            QMessageBox::warning(nullptr, tr("Simulate"),
+                                 tr("Failed to create dataset file ") + qucs_dataset + "\n"
+                                 + tr("Check write permission of the directory ") + inf.path());
+        }
+        return;
+    }
 
-    ds_stream<<"<Qucs Dataset " PACKAGE_VERSION ">\n";
+    // Merge all outputs in a single Qucs dataset otherwise. Every output is
+    // written as soon as it is parsed, only one of them is held in memory.
+    DataSetWriter ds_writer(qucs_dataset);
+    if (!ds_writer.open(PACKAGE_VERSION)) {
+        QFileInfo inf(qucs_dataset);
+        QMessageBox::warning(nullptr, tr("Simulate"),
+                             tr("Failed to create dataset file ") + qucs_dataset + "\n"
+                             + tr("Check write permission of the directory ") + inf.path());
+#ifdef NDEBUG
+        removeAllSimulatorOutputs();
+#endif
+        return;
+    }
 
     QString sim,indep;
     QStringList indep_vars;
 
     for (const QString& ngspice_output_filename : a_output_files) { // For every simulation convert results to Qucs dataset
-        QList< QList<double> > sim_points;
+        SimPointColumns sim_points;
+        QList< QList<double> > sim_rows; // outputs of the other parsers, converted below
         QStringList var_list, digital_vars;
         QString swp_var,swp_var2;
         QStringList swp_var_val,swp_var2_val;
@@ -1193,7 +1333,7 @@ void AbstractSpiceKernel::convertToQucsData(const QString &qucs_dataset)
         if (ngspice_output_filename.endsWith("HB.FD.prn")) {
             //parseHBOutput(full_outfile,sim_points,var_list,hasParSweep);
             //isComplex = true;
-            parseXYCESTDOutput(full_outfile,sim_points,var_list,isComplex,hasParSweep);
+            parseXYCESTDOutput(full_outfile,sim_rows,var_list,isComplex,hasParSweep);
             if (hasParSweep) {
                 QString res_file = QDir::toNativeSeparators(a_workdir + QDir::separator()
                                                         + "spice4qucs.hb.cir.res");
@@ -1202,18 +1342,18 @@ void AbstractSpiceKernel::convertToQucsData(const QString &qucs_dataset)
         } else if (ngspice_output_filename.endsWith(".four") ||
                    four_rx.match(ngspice_output_filename).hasMatch()) {
             isComplex=false;
-            parseFourierOutput(full_outfile,sim_points,var_list);
+            parseFourierOutput(full_outfile,sim_rows,var_list);
         } else if (ngspice_output_filename.endsWith(".ngspice.sens.dc.prn")) {
             isComplex = false;
-            parseSENSOutput(full_outfile,sim_points,var_list);
+            parseSENSOutput(full_outfile,sim_rows,var_list);
         } else if (ngspice_output_filename.endsWith(".txt_std")) {
-            parseXYCESTDOutput(full_outfile,sim_points,var_list,isComplex,hasParSweep);
+            parseXYCESTDOutput(full_outfile,sim_rows,var_list,isComplex,hasParSweep);
         } else if (ngspice_output_filename.endsWith(".noise_log")) {
             isComplex = false;
-            parseXYCENoiseLog(full_outfile,sim_points,var_list);
+            parseXYCENoiseLog(full_outfile,sim_rows,var_list);
         } else if (ngspice_output_filename.endsWith(".noise")) {
             isComplex = false;
-            parseNoiseOutput(full_outfile,sim_points,var_list,hasParSweep);
+            parseNoiseOutput(full_outfile,sim_rows,var_list,hasParSweep);
             if (hasParSweep) {
                 QString res_file = QDir::toNativeSeparators(a_workdir + QDir::separator()
                                                         + "spice4qucs." + dataset_prefix + ".cir.res");
@@ -1221,7 +1361,7 @@ void AbstractSpiceKernel::convertToQucsData(const QString &qucs_dataset)
             }
         } else if (ngspice_output_filename.endsWith(".pz")) {
             isComplex = true;
-            parsePZOutput(full_outfile,sim_points,var_list,hasParSweep);
+            parsePZOutput(full_outfile,sim_rows,var_list,hasParSweep);
             if (hasParSweep) {
                 QString res_file = QDir::toNativeSeparators(a_workdir + QDir::separator()
                                                         + "spice4qucs." + dataset_prefix + ".cir.res");
@@ -1230,7 +1370,7 @@ void AbstractSpiceKernel::convertToQucsData(const QString &qucs_dataset)
         } else if (ngspice_output_filename.endsWith(".SENS.prn")) {
             QStringList vals;
             int type = checkRawOutupt(full_outfile,vals);
-            parseXYCESTDOutput(full_outfile,sim_points,var_list,isComplex,hasParSweep);
+            parseXYCESTDOutput(full_outfile,sim_rows,var_list,isComplex,hasParSweep);
             if (type == xyceSTDswp) {
                 hasParSweep = true;
                 QString res_file = QDir::toNativeSeparators(a_workdir + QDir::separator()
@@ -1250,7 +1390,10 @@ void AbstractSpiceKernel::convertToQucsData(const QString &qucs_dataset)
                                                     + "spice4qucs." + dataset_prefix + ".cir.res");
             parseResFile(res_file,swp_var,swp_var_val);
 
-            parseSTEPOutput(full_outfile,sim_points,var_list,isComplex);
+            if (!takeStreamedOutput(ngspice_output_filename,sim_points,var_list,isComplex))
+                parseSTEPOutput(full_outfile,sim_points,var_list,isComplex);
+        } else if (takeStreamedOutput(ngspice_output_filename,sim_points,var_list,isComplex)) {
+            // already in memory, there is no output file
         } else {
             int OutType = checkRawOutupt(full_outfile,swp_var_val);
             bool hasSwp = false;
@@ -1264,20 +1407,21 @@ void AbstractSpiceKernel::convertToQucsData(const QString &qucs_dataset)
                 parseNgSpiceSimOutput(full_outfile, sim_points, var_list, isComplex, digital_vars, dig_vars_dims);
                 break;
             case xyceSTD:
-                parseXYCESTDOutput(full_outfile,sim_points,var_list,isComplex,hasSwp);
+                parseXYCESTDOutput(full_outfile,sim_rows,var_list,isComplex,hasSwp);
                 break;
             case xyceSTDswp:
                 hasParSweep = true;
                 swp_var = "Number";
-                parseXYCESTDOutput(full_outfile,sim_points,var_list,isComplex,hasSwp);
+                parseXYCESTDOutput(full_outfile,sim_rows,var_list,isComplex,hasSwp);
                 break;
             case spicePrn:
                 isComplex = true;
-                parsePrnOutput(full_outfile, sim_points, var_list, isComplex);
+                parsePrnOutput(full_outfile, sim_rows, var_list, isComplex);
                 break;
             default: break;
             }
         }
+        sim_points.appendRows(sim_rows);
         if (var_list.isEmpty()) continue; // nothing to convert
         normalizeVarsNames(var_list, dataset_prefix, isCustomPrefix);
         digital_vars.prepend(var_list.first());
@@ -1294,42 +1438,41 @@ void AbstractSpiceKernel::convertToQucsData(const QString &qucs_dataset)
             if (hasDblParSweep) indep_cnt =  sim_points.count()/(swp_var_val.count()*swp_var2_val.count());
             else indep_cnt = sim_points.count()/swp_var_val.count();
             if (!indep.isEmpty()) {
-                ds_stream<<QStringLiteral("<indep %1 %2>\n").arg(indep).arg(indep_cnt); // output indep var: TODO: parameter sweep
+                ds_writer.beginIndep(indep, indep_cnt); // output indep var: TODO: parameter sweep
                 for (int i=0;i<indep_cnt;i++) {
-                    ds_stream<<QString::number(sim_points.at(i).at(0),'e',12)<<"\n";
+                    ds_writer.addReal(sim_points.at(i,0));
                 }
-                ds_stream<<"</indep>\n";
+                ds_writer.end();
             }
 
-            ds_stream<<QStringLiteral("<indep %1 %2>\n").arg(swp_var).arg(swp_var_val.count());
+            ds_writer.beginIndep(swp_var, swp_var_val.count());
             for (const QString& val : swp_var_val) {
-                ds_stream<<val<<"\n";
+                ds_writer.addText(val);
             }
-            ds_stream<<"</indep>\n";
+            ds_writer.end();
             if (indep.isEmpty()) indep = swp_var;
             else indep += " " + swp_var;
             if (hasDblParSweep) {
-                ds_stream<<QStringLiteral("<indep %1 %2>\n").arg(swp_var2).arg(swp_var2_val.count());
+                ds_writer.beginIndep(swp_var2, swp_var2_val.count());
                 for (const QString& val : swp_var2_val) {
-                    ds_stream<<val<<"\n";
+                    ds_writer.addText(val);
                 }
-                ds_stream<<"</indep>\n";
+                ds_writer.end();
                 indep += " " + swp_var2;
             }
         } else if (!indep.isEmpty()) {
-            ds_stream<<QStringLiteral("<indep %1 %2>\n").arg(indep).arg(sim_points.count()); // output indep var: TODO: parameter sweep
-            for (auto& sim_point : sim_points) {
-                ds_stream<<QString::number(sim_point.at(0),'e',12)<<"\n";
+            ds_writer.beginIndep(indep, sim_points.count()); // output indep var: TODO: parameter sweep
+            for (double val : sim_points.column(0)) {
+                ds_writer.addReal(val);
             }
-            ds_stream<<"</indep>\n";
+            ds_writer.end();
         }
 
         int dig_var_idx = 0;
         for(int i=1;i<var_list.count();i++) { // output dep var
             bool is_digital_var = false;
-            bool digital_indep = false;
             if (indep.isEmpty()) {
-              ds_stream<<QStringLiteral("<indep %1 %2>\n").arg(var_list.at(i)).arg(sim_points.count());
+              ds_writer.beginIndep(var_list.at(i), sim_points.count());
             } else {
               QString var = var_list.at(i);
               is_digital_var = digital_vars.contains(var);
@@ -1343,57 +1486,63 @@ void AbstractSpiceKernel::convertToQucsData(const QString &qucs_dataset)
                   var2 += " " + swp_var;
                   if (hasDblParSweep) var += " " + swp_var2;
                 }
-                ds_stream<<QStringLiteral("<dep %1 %2>\n").arg(var).arg(var2);
+                ds_writer.beginDep(var, var2);
               } else if (is_digital_var && var.endsWith("_steps") && // indep XSPICE digital var
                          !var.contains("(") && !var.contains(")")) {
-                digital_indep = true;
-                ds_stream<<QStringLiteral("<indep %1 %2>\n").arg(var).arg(dig_vars_dims.at(dig_var_idx));
+                ds_writer.beginIndep(var, dig_vars_dims.at(dig_var_idx));
               } else {
-                ds_stream<<QStringLiteral("<dep %1 %2>\n").arg(var_list.at(i)).arg(indep);
+                ds_writer.beginDep(var_list.at(i), indep);
               }
             }
             int count = 0;
-            for (auto& sim_point : sim_points) {
+            for (int pt = 0; pt < sim_points.count(); pt++) {
                 if (is_digital_var && count > dig_vars_dims.at(dig_var_idx)) break;
                 if (isComplex) {
-                    double re=sim_point.at(2*(i-1)+1);
-                    double im = sim_point.at(2*i);
-                    QString s;
-                    s += QString::number(re,'e',12);
-                    if (im<0) s += "-j";
-                    else s += "+j";
-                    s += QString::number(fabs(im),'e',12) + "\n";
-                    ds_stream<<s;
+                    ds_writer.addComplex(sim_points.at(pt,2*(i-1)+1), sim_points.at(pt,2*i));
                 } else {
-                    ds_stream<<QString::number(sim_point.at(i),'e',12)<<"\n";
+                    ds_writer.addReal(sim_points.at(pt,i));
                 }
                 count++;
             }
-            if (indep.isEmpty() || digital_indep) {
-              ds_stream<<"</indep>\n";
-            } else {
-              ds_stream<<"</dep>\n";
-            }
+            ds_writer.end();
             if (is_digital_var) dig_var_idx++;
         }
     }
 
-    QFile dataset(qucs_dataset);
-    if (dataset.open(QFile::WriteOnly)) {
-        QTextStream ts(&dataset);
-        ts<<ds_str;
-        dataset.close();
-    } else {
+    if (!ds_writer.commit()) {
         QFileInfo inf(qucs_dataset);
         QMessageBox::warning(nullptr, tr("Simulate"),
                              tr("Failed to create dataset file ") + qucs_dataset + "\n"
                              + tr("Check write permission of the directory ") + inf.path());
+    } else if (!a_resultKey.isEmpty() && a_simProcess->exitStatus() == QProcess::NormalExit
+               && !ExternSimDialog::logContainsError(a_output)) {
+        // Xyce runs its own processes and clears the key if one of them fails
+        SimResultCache::store(a_resultKey, qucs_dataset, a_output);
     }
+    a_streamedOutputs.clear();
 #ifdef NDEBUG
     removeAllSimulatorOutputs();
 #endif
 }
 
+/*!
+ * \brief AbstractSpiceKernel::takeStreamedOutput Take the simulation output that
+ *        replaces the output file, if it is held in memory.
+ * \param output_file Name of the output file, e.g. spice4qucs.ac.plot
+ * \return False if the output has to be read from the file.
+ */
+bool AbstractSpiceKernel::takeStreamedOutput(const QString &output_file, SimPointColumns &sim_points,
+                                             QStringList &var_list, bool &isComplex)
+{
+    auto it = a_streamedOutputs.find(output_file);
+    if (it == a_streamedOutputs.end()) return false;
+    sim_points = std::move(it->points);
+    var_list = it->var_list;
+    isComplex = it->isComplex;
+    a_streamedOutputs.erase(it);
+    return true;
+}
+
 /*!
  * \brief AbstractSpiceKernel::removeAllSimulatorOutputs Clean temporary simulator
  *        datasets.
@@ -1563,9 +1712,10 @@ void AbstractSpiceKernel::SaveNetlist(QString)
 
 }
 
-bool AbstractSpiceKernel::waitEndOfSimulation()
+bool AbstractSpiceKernel::waitEndOfSimulation(int msecs)
 {
-    return a_simProcess->waitForFinished(10000);
+    if (a_cachedResult) return true;
+    return a_simProcess->waitForFinished(msecs);
 }
 
 QString AbstractSpiceKernel::collectSpiceLibs(Schematic* sch)
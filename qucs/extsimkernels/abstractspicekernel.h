@@ -20,6 +20,7 @@
 #ifndef ABSTRACTSPICEKERNEL_H
 #define ABSTRACTSPICEKERNEL_H
 
+#include <QHash>
 #include <QList>
 #include <QString>
 #include <QStringList>
@@ -30,6 +31,8 @@
 #include "schematic.h"
 #include "extsimkernels/spicecompat.h"
 
+#include <vector>
+
 class QPlainTextEdit;
 
 /*!
@@ -37,6 +40,32 @@ class QPlainTextEdit;
   \brief Implementation of the AbstractSpiceKernel class
 */
 
+/*!
+ * \brief Simulation points stored column by column. Column 0 holds the
+ *        independent variable, followed by one column per real variable or
+ *        two columns (real and imaginary part) per complex variable. Each
+ *        column is one contiguous array.
+ */
+class SimPointColumns
+{
+public:
+    int count() const { return a_columns.empty() ? 0 : int(a_columns.front().size()); }
+    int numColumns() const { return int(a_columns.size()); }
+    const std::vector<double>& column(int col) const { return a_columns[col]; }
+    double at(int point, int col) const { return a_columns[col][point]; }
+
+    void clear() { a_columns.clear(); }
+    void appendRow(const QList<double> &row);
+    void appendRows(const QList< QList<double> > &rows);
+    void appendPoint(const double *values, int NumColumns);
+    qint64 appendBinary(const char *data, qint64 size, int NumPoints, int NumVars, bool isComplex);
+
+private:
+    void resizeColumns(int NumColumns);
+
+    std::vector< std::vector<double> > a_columns;
+};
+
 /*!
  * \brief AbstractSpiceKernel class contains common methods for
  *        Ngspice and Xyce simulation kernels. Contains spice netlist builder
@@ -52,9 +81,7 @@ private:
 
     void normalizeVarsNames(QStringList &var_list, const QString &dataset_prefix, bool isCustom = false);
     int checkRawOutupt(QString ngspice_file, QStringList &values);
-    void extractBinSamples(QDataStream &dbl, QList< QList<double> > &sim_points,
-                           int NumPoints, int NumVars, bool isComplex);
-    bool extractASCIISamples(QString &lin, QTextStream &ngsp_data, QList< QList<double> > &sim_points,
+    bool extractASCIISamples(QString &lin, QTextStream &ngsp_data, SimPointColumns &sim_points,
                              int NumVars, bool isComplex);
 
 protected:
@@ -76,6 +103,28 @@ protected:
     bool a_parseFourTHD;  // Fourier output is parsed twice, first freqencies, then THD
     bool a_parsePZzeros;  // PZ output is parsed twice, first poles, then zeros
 
+    bool a_useResultCache;  // a cached result may replace the simulation
+    bool a_cachedResult;    // the result is taken from the cache, nothing is simulated
+    QString a_resultKey;    // key of the result in the cache, empty if it is not stored
+
+    /*!
+     * \brief Simulation output that is already in memory instead of in an
+     *        output file, e.g. streamed from the Ngspice shared library.
+     *        The layout is the one of a parsed raw file.
+     */
+    struct StreamedOutput {
+        QStringList var_list;   // independent variable first
+        bool isComplex = false;
+        SimPointColumns points;
+    };
+    QHash<QString, StreamedOutput> a_streamedOutputs; // key: output file name
+
+    bool takeStreamedOutput(const QString &output_file, SimPointColumns &sim_points,
+                            QStringList &var_list, bool &isComplex);
+
+    QString resultCacheKey(const QByteArray &netlist);
+    bool lookupResultCache(const QByteArray &netlist);
+
     bool prepareSpiceNetlist(QTextStream &stream, bool isSubckt = false);
     virtual void startNetlist(QTextStream& stream, spicecompat::SpiceDialect dialect = spicecompat::SPICEDefault);
     virtual void createNetlist(QTextStream& stream, int NumPorts,QStringList& simulations,
@@ -94,7 +143,7 @@ public:
     virtual void createSubNetlist(QTextStream& stream, bool lib = false);
 
     void parseNgSpiceSimOutput(QString ngspice_file,
-                               QList< QList<double> > &sim_points,
+                               SimPointColumns &sim_points,
                                QStringList &var_list, bool &isComplex,
                                QStringList &digital_vars, QList<int> &dig_vars_dims);
     void parseHBOutput(QString ngspice_file, QList< QList<double> > &sim_points,
@@ -110,7 +159,7 @@ public:
     void parseDC_OPoutput(QString ngspice_file);
     void parseDC_OPoutputXY(QString xyce_file);
     void parseSTEPOutput(QString ngspice_file,
-                         QList< QList<double> > &sim_points,
+                         SimPointColumns &sim_points,
                          QStringList &var_list, bool &isComplex);
     void parsePrnOutput(const QString &ngspice_file,
                         QList< QList<double> > &sim_points,
@@ -127,10 +176,11 @@ public:
 
     virtual void setSimulatorCmd(QString cmd);
     virtual void setSimulatorParameters(QString parameters);
-    void setWorkdir(QString path);
+    virtual void setWorkdir(QString path);
     virtual void SaveNetlist(QString filename);
-    virtual bool waitEndOfSimulation();
+    virtual bool waitEndOfSimulation(int msecs = 10000);   // -1: no time limit
     void setConsole(QPlainTextEdit *console) { a_console = console; }
+    void setUseResultCache(bool use) { a_useResultCache = use; }
     QStringList collectSpiceLibraryFiles(Schematic *sch);
     static QString collectSpiceLibs(Schematic* sch);
 
@@ -32,7 +32,7 @@ ExternSimDialog::ExternSimDialog(Schematic* sch, bool netlist2Console, bool netl
     a_editSimConsole(new QPlainTextEdit(this)),
     a_simStatusLog(new QListWidget),
     a_simProgress(new QProgressBar(this)),
-    a_ngspice(new Ngspice(sch,this)),
+    a_ngspice(NgspiceShared::isEnabled() ? new NgspiceShared(sch,this) : new Ngspice(sch,this)),
     a_xyce(new Xyce(sch,this)),
     a_wasSimulated(true),
     a_hasError(false),
@@ -271,6 +271,10 @@ void ExternSimDialog::slotStart()
 {
     a_buttonStopSim->setEnabled(true);
     a_buttonSaveNetlist->setEnabled(false);
+    // Shift forces a new simulation instead of a cached result
+    bool use_cache = !(QGuiApplication::keyboardModifiers() & Qt::ShiftModifier);
+    a_ngspice->setUseResultCache(use_cache);
+    a_xyce->setUseResultCache(use_cache);
     switch (QucsSettings.DefaultSimulator) {
     case spicecompat::simNgspice:
         a_ngspice->slotSimulate();
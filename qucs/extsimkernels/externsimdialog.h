@@ -21,6 +21,7 @@
 #include <QtGui>
 
 #include "ngspice.h"
+#include "ngspiceshared.h"
 #include "xyce.h"
 
 class Schematic;
@@ -58,11 +59,12 @@ public:
     bool wasSimulated() const { return a_wasSimulated; }
     bool hasError() const { return a_hasError; }
 
+    static bool logContainsError(const QString &out);
+    static bool logContainsWarning(const QString &out);
+
 private:
     void saveLog();
     void addLogEntry(const QString&text, const QIcon &icon);
-    bool logContainsError(const QString &out);
-    bool logContainsWarning(const QString &out);
 
 signals:
     void simulated(ExternSimDialog *);
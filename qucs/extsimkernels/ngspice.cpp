@@ -51,7 +51,13 @@
  */
 Ngspice::Ngspice(Schematic* schematic, QObject *parent) :
     AbstractSpiceKernel(schematic, parent),
-    a_spinit_name()
+    a_spinit_name(),
+    a_numShards(1),
+    a_shard(0),
+    a_shardedSweeps(),
+    a_shards(),
+    a_mainProgress(0),
+    a_mainFinished(true)
 {
     if (QFileInfo(QucsSettings.NgspiceExecutable).isRelative()) { // this check is related to MacOS
         a_simulator_cmd = QFileInfo(QucsSettings.BinDir + QucsSettings.NgspiceExecutable).absoluteFilePath();
@@ -65,6 +71,14 @@ Ngspice::Ngspice(Schematic* schematic, QObject *parent) :
     a_spinit_name = QDir::toNativeSeparators(QucsSettings.S4Qworkdir+"/.spiceinit");
 }
 
+Ngspice::~Ngspice()
+{
+    for (const Shard &shard : a_shards) {
+        shard.process->disconnect(this);
+        shard.process->kill();
+    }
+}
+
 /*!
  * \brief Ngspice::createNetlist Output Ngspice-style netlist to text stream.
  *        Netlist contains sections necessary for Ngspice.
@@ -170,6 +184,9 @@ void Ngspice::createNetlist(
         bool hasParSWP = false;
         bool hasDblSWP = false;
         QString cnt_var;
+        int swp_count = 0;      // values of the outer sweep
+        QStringList swp_values; // values of the outer sweep simulated by this netlist
+        bool sharded = false;   // outer sweep values are split between processes
 
         // Duplicate .PARAM in .control section. They may be used in euqations
         for (Component* pc1 : a_schematic->a_DocComps) {
@@ -196,14 +213,25 @@ void Ngspice::createNetlist(
                 if ( SwpSim == sim_name ) {
                     cnt_var = (reinterpret_cast<Param_Sweep *>(pc1))->getCounterVar();
                     if ( !sim_name.startsWith("dc") ) {
-                        spiceNetlist.append(getParentSWPscript(pc1, sim_name, true, hasDblSWP));
-                        spiceNetlist.append(pc1->getNgspiceBeforeSim(sim_name));
+                        // The outer loop of a double sweep is the parent sweep
+                        Param_Sweep *outer_swp = getParentSWP(pc1);
+                        hasDblSWP = (outer_swp != nullptr);
+                        if ( !hasDblSWP ) outer_swp = reinterpret_cast<Param_Sweep *>(pc1);
+                        swp_values = outer_swp->getNgspiceSweepValues();
+                        swp_count = swp_values.count();
+                        sharded = ( a_numShards > 1 && swp_count > 1 && isShardable(pc) );
+                        if ( sharded ) swp_values = shardValues(swp_values, a_shard);
+                        spiceNetlist.append(outer_swp->getNgspiceBeforeSim(sim_name, hasDblSWP ? 1 : 0, swp_values));
+                        if ( hasDblSWP ) spiceNetlist.append(pc1->getNgspiceBeforeSim(sim_name));
                         hasParSWP = true;
                     }
                 }
             }
         }
 
+        // The netlists of further shards contain only their part of split sweeps
+        if ( a_shard > 0 && (!sharded || swp_values.isEmpty()) ) continue;
+
         if ( sim_typ == ".AC" ) {
             freqSims++;
             spiceNetlist.append(pc->getSpiceNetlist());
@@ -339,6 +367,12 @@ void Ngspice::createNetlist(
                 filename.replace(' ', '_'); // Ngspice cannot understand spaces in filename
                 spiceNetlist.append(QStringLiteral("write %1 %2\n").arg(filename).arg(nods));
                 outputs.append(filename);
+                if ( sharded && a_shard == 0 ) {
+                    QString res = QStringLiteral("spice4qucs.%1.cir.res%2")
+                            .arg(sim_name, hasDblSWP ? "1" : "");
+                    a_shardedSweeps.append(ShardedSweep{filename, res, swp_count,
+                                                        qMin(a_numShards, swp_count)});
+                }
             }
         }
 
@@ -366,6 +400,7 @@ void Ngspice::createNetlist(
            << ".endc\n";
     stream << ".END\n";
 
+    if (a_shard > 0) return; // a part of the main netlist only
     a_needsPrefix = ( (dcSims | freqSims | timeSims | fourSims | pzSims) > 1 );
 
     qDebug() << '\n'
@@ -378,6 +413,26 @@ void Ngspice::createNetlist(
              << '\n';
 }
 
+/*!
+ * \brief Ngspice::getParentSWP Find the sweep that sweeps another sweep.
+ * \param pc_swp The inner sweep
+ * \return The outer sweep of a double sweep or nullptr
+ */
+Param_Sweep *Ngspice::getParentSWP(Component *pc_swp)
+{
+    QString swp = pc_swp->Name.toLower();
+    for (Component* pc : a_schematic->a_DocComps) {
+        if ( !pc->isSimulation ) continue;
+        if ( pc->isActive != COMP_IS_ACTIVE ) continue;
+        if ( pc->Model == ".SW" ) {
+            if ( pc->Props.at(0)->Value.toLower() == swp ) {
+                return reinterpret_cast<Param_Sweep *>(pc);
+            }
+        }
+    }
+    return nullptr;
+}
+
 /*!
  * \brief Ngspice::getParentSWPscript
  * \param pc_swp
@@ -387,31 +442,191 @@ void Ngspice::createNetlist(
  */
 QString Ngspice::getParentSWPscript(Component *pc_swp, QString sim, bool before, bool &hasDblSwp)
 {
-    hasDblSwp = false;
-    QString swp = pc_swp->Name.toLower();
-    for (Component* pc : a_schematic->a_DocComps) {
-        if ( !pc->isSimulation ) continue;
+    Param_Sweep *pc = getParentSWP(pc_swp);
+    hasDblSwp = (pc != nullptr);
+    if (pc == nullptr) return QString();
+    if (before) return pc->getNgspiceBeforeSim(sim, 1);
+    else return pc->getNgspiceAfterSim(sim, 1);
+}
+
+/*!
+ * \brief Ngspice::isShardable Check whether the sweep of a simulation can be
+ *        split between several Ngspice processes. This is the case if all
+ *        results of the simulation go to the sweep plot file.
+ * \param pc_sim The swept simulation
+ */
+bool Ngspice::isShardable(Component *pc_sim)
+{
+    if ( pc_sim->Model == ".AC" || pc_sim->Model == ".SP" ) return true;
+    if ( pc_sim->Model != ".TR" ) return false;
+    for (Component* pc : a_schematic->a_DocComps) { // Fourier analysis has its own outputs
         if ( pc->isActive != COMP_IS_ACTIVE ) continue;
-        if ( pc->Model == ".SW" ) {
-            if ( pc->Props.at(0)->Value.toLower() == swp ) {
-                if (before) {
-                    hasDblSwp = true;
-                    return pc->getNgspiceBeforeSim(sim, 1);
-                } else {
-                    hasDblSwp = true;
-                    return pc->getNgspiceAfterSim(sim, 1);
+        if ( pc->Model == ".FOURIER" &&
+             pc->Props.at(0)->Value.toLower() == pc_sim->Name.toLower() ) return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Ngspice::shardValues The part of the sweep values simulated by
+ *        a shard. The values are split into consecutive parts of equal size.
+ * \return The values, empty if the shard has no part of this sweep.
+ */
+QStringList Ngspice::shardValues(const QStringList &values, int shard) const
+{
+    int num = qMin(a_numShards, int(values.count()));
+    if (shard >= num) return QStringList();
+    int first = values.count()*shard/num;
+    int last = values.count()*(shard+1)/num;
+    return values.mid(first, last-first);
+}
+
+QString Ngspice::shardDir(int shard) const
+{
+    return QDir::toNativeSeparators(a_workdir + QDir::separator()
+                                    + QStringLiteral("shard%1").arg(shard));
+}
+
+int Ngspice::findShard(QObject *process) const
+{
+    for (int i = 0; i < a_shards.count(); i++) {
+        if (a_shards.at(i).process == process) return i;
+    }
+    return -1;
+}
+
+/*!
+ * \brief Ngspice::startShards Write the netlists of all shards except the
+ *        main one and start an Ngspice process for every shard.
+ * \param netfile Name of the netlist file, the same in every shard directory
+ */
+void Ngspice::startShards(const QString &netfile)
+{
+    for (const Shard &shard : a_shards) {
+        shard.process->deleteLater();
+    }
+    a_shards.clear();
+
+    int num = 1;
+    for (const ShardedSweep &swp : a_shardedSweeps) {
+        num = qMax(num, swp.shards);
+    }
+    for (int k = 1; k < num; k++) {
+        QString dir = shardDir(k);
+        QDir(dir).removeRecursively();
+        QDir().mkpath(dir);
+        if (QFile::exists(a_spinit_name)) {
+            QFile::copy(a_spinit_name, dir + QDir::separator() + ".spiceinit");
+        }
+
+        QFile spice_file(dir + QDir::separator() + netfile);
+        if (!spice_file.open(QFile::WriteOnly)) {
+            a_output.append("[Warning!] Cannot write " + spice_file.fileName() + "\n");
+            break;
+        }
+        QTextStream stream(&spice_file);
+        QStringList sims, vars, outputs;
+        a_shard = k;
+        createNetlist(stream, sims, vars, outputs);
+        a_shard = 0;
+        spice_file.close();
+
+        QProcess *process = new QProcess(this);
+        process->setProcessChannelMode(QProcess::MergedChannels);
+        process->setProcessEnvironment(a_simProcess->processEnvironment());
+        process->setWorkingDirectory(dir);
+        connect(process,SIGNAL(finished(int)),this,SLOT(slotShardFinished()));
+        connect(process,SIGNAL(readyRead()),this,SLOT(slotShardOutput()));
+        connect(process,SIGNAL(errorOccurred(QProcess::ProcessError)),this,SLOT(slotShardError(QProcess::ProcessError)));
+        a_shards.append(Shard{process, QString(), 0, true});
+
+        QString cmd = QStringLiteral("\"%1\" %2 %3").arg(a_simulator_cmd,a_simulator_parameters,netfile);
+        QStringList cmd_args = misc::parseCmdArgs(cmd);
+        QString ngsp_cmd = cmd_args.at(0);
+        cmd_args.removeAt(0);
+        process->start(ngsp_cmd,cmd_args);
+    }
+}
+
+/*!
+ * \brief Ngspice::mergeShards Append the results of all shards to the sweep
+ *        outputs of the main netlist, so that they look as if the whole sweep
+ *        was simulated by a single process.
+ */
+void Ngspice::mergeShards()
+{
+    QRegularExpression point_pattern("^\\s*([0-9]+)(\\s.*)$");
+    for (const ShardedSweep &swp : a_shardedSweeps) {
+        QFile plot(a_workdir + QDir::separator() + swp.plot);
+        QFile res(a_workdir + QDir::separator() + swp.res);
+        if (!plot.open(QIODevice::Append) || !res.open(QIODevice::Append)) continue;
+        QTextStream res_stream(&res);
+        for (int k = 1; k < swp.shards; k++) {
+            QFile shard_plot(shardDir(k) + QDir::separator() + swp.plot);
+            if (shard_plot.open(QIODevice::ReadOnly)) {
+                while (!shard_plot.atEnd()) {
+                    plot.write(shard_plot.read(1 << 20));
                 }
+                shard_plot.close();
+            }
+
+            // Every shard counts its sweep steps from zero
+            int offset = swp.count*k/swp.shards;
+            QFile shard_res(shardDir(k) + QDir::separator() + swp.res);
+            if (shard_res.open(QIODevice::ReadOnly)) {
+                QTextStream shard_stream(&shard_res);
+                while (!shard_stream.atEnd()) {
+                    QRegularExpressionMatch m = point_pattern.match(shard_stream.readLine());
+                    if (m.hasMatch()) {
+                        res_stream << m.captured(1).toInt() + offset << m.captured(2) << "\n";
+                    }
+                }
+                shard_res.close();
             }
         }
+        res_stream.flush();
     }
-    return QString();
+#ifdef NDEBUG
+    for (int k = 1; k <= a_shards.count(); k++) {
+        QDir(shardDir(k)).removeRecursively();
+    }
+#endif
+}
+
+/*!
+ * \brief Ngspice::checkAllFinished End the simulation once the main process
+ *        and all shards have finished.
+ */
+void Ngspice::checkAllFinished()
+{
+    if (!a_mainFinished) return;
+    for (const Shard &shard : a_shards) {
+        if (shard.running) return;
+    }
+    if (!a_shards.isEmpty()) mergeShards();
+    emit finished();
+    emit progress(100);
+}
+
+void Ngspice::reportProgress()
+{
+    int percent = a_mainProgress;
+    for (const Shard &shard : a_shards) {
+        percent += shard.progress;
+    }
+    emit progress(percent/(a_shards.count() + 1));
 }
 
 /*!
  * \brief Ngspice::slotSimulate Create netlist and execute Ngspice simulator. Netlist
  *        is saved at $HOME/.qucs/spice4qucs/spice4qucs.cir
  */
-void Ngspice::slotSimulate()
+/*!
+ * \brief Ngspice::checkSimulation Check the schematic before it is simulated.
+ *        The problems found are written to the output.
+ * \return False if the schematic cannot be simulated.
+ */
+bool Ngspice::checkSimulation()
 {
     a_output.clear();
 
@@ -461,11 +676,19 @@ void Ngspice::slotSimulate()
             a_console->insertPlainText(a_output);
         //emit finished();
         emit errors(QProcess::FailedToStart);
-        return;
+        return false;
     }
+    return true;
+}
+
+void Ngspice::slotSimulate()
+{
+    if (!checkSimulation()) return;
 
     QString netfile = "spice4qucs.cir";
     QString tmp_path = QDir::toNativeSeparators(a_workdir+QDir::separator()+netfile);
+    a_numShards = qMax(1, _settings::Get().item<int>("NgspiceSweepShards"));
+    a_shardedSweeps.clear();
     SaveNetlist(tmp_path, false);
 
     removeAllSimulatorOutputs();
@@ -480,7 +703,26 @@ void Ngspice::slotSimulate()
     }
     delete CMbuilder;*/
     cleanSpiceinit();
-    createSpiceinit(/*initial_spiceinit=*/collectSpiceinit(a_schematic));
+    QString initial_spiceinit = collectSpiceinit(a_schematic);
+    createSpiceinit(initial_spiceinit);
+
+    QFile netlist(tmp_path);
+    if (netlist.open(QIODevice::ReadOnly)) {
+        QByteArray input = netlist.readAll();
+        input += spiceinitContents(initial_spiceinit).toUtf8();
+        input += QByteArray::number(a_numShards);
+        netlist.close();
+        if (lookupResultCache(input)) {
+            a_numShards = 1;
+            return;
+        }
+    }
+
+    // Split sweeps are continued by further processes, see createNetlist()
+    a_mainProgress = 0;
+    a_mainFinished = false;
+    startShards(netfile);
+    a_numShards = 1; // netlists saved by the user are never split
 
     //startNgSpice(tmp_path);
     a_simProcess->setWorkingDirectory(a_workdir);
@@ -571,14 +813,92 @@ void Ngspice::slotProcessOutput()
     QString s = a_simProcess->readAllStandardOutput();
     QRegularExpression percentage_pattern("^%\\d\\d*\\.\\d\\d.*$");
     if (percentage_pattern.match(s).hasMatch()) {
-        int percent = round(s.mid(1,5).toFloat());
-        emit progress(percent);
+        a_mainProgress = round(s.mid(1,5).toFloat());
+        reportProgress();
+    }
+    a_output += s;
+    if (a_console != nullptr) {
+        a_console->insertPlainText(s);
+        a_console->moveCursor(QTextCursor::End);
+    }
+}
+
+/*!
+ * \brief Ngspice::slotFinished The main Ngspice process finished. The results
+ *        are available when all shards have finished, too.
+ */
+void Ngspice::slotFinished()
+{
+    a_output += a_simProcess->readAllStandardOutput();
+    a_mainFinished = true;
+    checkAllFinished();
+}
+
+/*!
+ * \brief Ngspice::slotShardOutput Collect the output of a shard. It is shown
+ *        when the shard has finished.
+ */
+void Ngspice::slotShardOutput()
+{
+    int idx = findShard(sender());
+    if (idx < 0) return;
+    Shard &shard = a_shards[idx];
+    QString s = shard.process->readAllStandardOutput();
+    QRegularExpression percentage_pattern("^%\\d\\d*\\.\\d\\d.*$");
+    if (percentage_pattern.match(s).hasMatch()) {
+        shard.progress = round(s.mid(1,5).toFloat());
+        reportProgress();
     }
+    shard.output += s;
+}
+
+void Ngspice::slotShardFinished()
+{
+    int idx = findShard(sender());
+    if (idx < 0) return;
+    Shard &shard = a_shards[idx];
+    shard.output += shard.process->readAllStandardOutput();
+    shard.progress = 100;
+    shard.running = false;
+    QString s = QStringLiteral("\nShard %1:\n").arg(idx+1) + shard.output;
     a_output += s;
     if (a_console != nullptr) {
         a_console->insertPlainText(s);
         a_console->moveCursor(QTextCursor::End);
     }
+    checkAllFinished();
+}
+
+void Ngspice::slotShardError(QProcess::ProcessError err)
+{
+    int idx = findShard(sender());
+    if (idx >= 0 && err == QProcess::FailedToStart) {
+        a_shards[idx].running = false; // no finished() follows
+    }
+    emit errors(err);
+    if (idx >= 0 && err == QProcess::FailedToStart) checkAllFinished();
+}
+
+/*!
+ * \brief Ngspice::killThemAll Stop the main process and all shards.
+ */
+void Ngspice::killThemAll()
+{
+    for (const Shard &shard : a_shards) {
+        if (shard.process->state() != QProcess::NotRunning) {
+            shard.process->kill();
+        }
+    }
+    AbstractSpiceKernel::killThemAll();
+}
+
+bool Ngspice::waitEndOfSimulation(int msecs)
+{
+    bool ok = AbstractSpiceKernel::waitEndOfSimulation(msecs);
+    for (const Shard &shard : a_shards) {
+        if (shard.running && !shard.process->waitForFinished(msecs)) ok = false;
+    }
+    return ok;
 }
 
 /*!
@@ -647,6 +967,16 @@ void Ngspice::setSimulatorParameters(QString parameters)
     a_simulator_parameters = parameters;
 }
 
+/*!
+ * \brief Ngspice::setWorkdir Set the working directory. Ngspice reads
+ *        .spiceinit from its working directory, so it moves along.
+ */
+void Ngspice::setWorkdir(QString path)
+{
+    AbstractSpiceKernel::setWorkdir(path);
+    a_spinit_name = QDir::toNativeSeparators(a_workdir+"/.spiceinit");
+}
+
 void Ngspice::cleanSpiceinit()
 {
     QFileInfo inf(a_spinit_name);
@@ -654,6 +984,25 @@ void Ngspice::cleanSpiceinit()
 }
 
 void Ngspice::createSpiceinit(const QString &initial_spiceinit)
+{
+  QString contents = spiceinitContents(initial_spiceinit);
+  if (contents.isEmpty()) {
+    return;
+  }
+  QFile spinit(a_spinit_name);
+  if (spinit.open(QIODevice::WriteOnly)) {
+    QTextStream stream(&spinit);
+    stream << contents;
+    spinit.close();
+  }
+}
+
+/*!
+ * \brief Ngspice::spiceinitContents The commands of the .spiceinit file: the
+ *        compatibility mode and the given initial commands.
+ * \return Empty string if no .spiceinit is needed.
+ */
+QString Ngspice::spiceinitContents(const QString &initial_spiceinit)
 {
   auto compat_mode = _settings::Get().item<int>("NgspiceCompatMode");
   QString compat_str;
@@ -671,13 +1020,7 @@ void Ngspice::createSpiceinit(const QString &initial_spiceinit)
   }
   if (initial_spiceinit.isEmpty() &&
       compat_str.isEmpty()) {
-    return;
-  }
-  QFile spinit(a_spinit_name);
-  if (spinit.open(QIODevice::WriteOnly)) {
-    QTextStream stream(&spinit);
-    stream << compat_str << '\n';
-    stream << initial_spiceinit << '\n';
-    spinit.close();
+    return QString();
   }
+  return compat_str + '\n' + initial_spiceinit + '\n';
 }
@@ -25,6 +25,8 @@
 #include "schematic.h"
 #include "abstractspicekernel.h"
 
+class Param_Sweep;
+
 /*!
   \file ngspice.h
   \brief Declaration of the Ngspice class
@@ -38,23 +40,62 @@ class Ngspice : public AbstractSpiceKernel
     Q_OBJECT
 
 private:
+    /*!
+     * \brief A parameter sweep whose outer values are split between several
+     *        Ngspice processes ("shards"). Shard 0 is the main netlist, the
+     *        other shards are simulated in subdirectories of the workdir.
+     */
+    struct ShardedSweep {
+        QString plot;   // output file of the swept simulation
+        QString res;    // file with the values of the outer sweep
+        int count;      // number of values of the outer sweep
+        int shards;     // number of parts the values are split into
+    };
+    struct Shard {
+        QProcess *process;
+        QString output;
+        int progress;   // percent
+        bool running;
+    };
+
     QString a_spinit_name;
 
+    int a_numShards;      // processes per sweep, 1 if sweeps are not split
+    int a_shard;          // shard written by createNetlist()
+    QList<ShardedSweep> a_shardedSweeps;
+    QList<Shard> a_shards;           // shards 1..n-1
+    int a_mainProgress;
+    bool a_mainFinished;
+
     bool checkNodeNames(QStringList &incompat);
-    static QString collectSpiceinit(Schematic* sch);
     bool findMathFuncInc(QString &mathf_inc);
+    Param_Sweep *getParentSWP(Component *pc_swp);
     QString getParentSWPscript(Component *pc_swp, QString sim, bool before, bool &hasDblSWP);
+    bool isShardable(Component *pc_sim);
+    QStringList shardValues(const QStringList &values, int shard) const;
+    QString shardDir(int shard) const;
+    int findShard(QObject *process) const;
+    void startShards(const QString &netfile);
+    void mergeShards();
+    void checkAllFinished();
+    void reportProgress();
     QString getParentSWPCntVar(Component *pc_swp, QString sim);
-    void cleanSpiceinit();
-    void createSpiceinit(const QString &initial_spiceinit);
 
 public:
     explicit Ngspice(Schematic* schematic, QObject *parent = 0);
+    ~Ngspice();
     void SaveNetlist(QString filename, bool netlist2Console);
     void setSimulatorCmd(QString cmd);
     void setSimulatorParameters(QString parameters);
+    void setWorkdir(QString path);
+    bool waitEndOfSimulation(int msecs = 10000);
 
 protected:
+    bool checkSimulation();
+    static QString collectSpiceinit(Schematic* sch);
+    static QString spiceinitContents(const QString &initial_spiceinit);
+    void cleanSpiceinit();
+    void createSpiceinit(const QString &initial_spiceinit);
     void createNetlist(
             QTextStream& stream,
             QStringList& simulations,
@@ -63,9 +104,14 @@ protected:
 
 public slots:
     void slotSimulate();
+    virtual void killThemAll();
 
 protected slots:
+    void slotFinished();
     void slotProcessOutput();
+    void slotShardFinished();
+    void slotShardOutput();
+    void slotShardError(QProcess::ProcessError err);
 };
 
 #endif // NGSPICE_H
@@ -0,0 +1,229 @@
+/***************************************************************************
+                            ngspicesession.cpp
+                           --------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "ngspicesession.h"
+#include "main.h"
+#include "misc.h"
+#include "settings.h"
+
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QTextStream>
+
+#include <cmath>
+
+/*!
+  \file ngspicesession.cpp
+  \brief Implementation of the NgspiceSession class
+*/
+
+// Echoed after the commands of a simulation
+static const char DoneMarker[] = "qucs-session-done";
+
+/*!
+ * Checks whether "new_line" differs from "old_line" in the value of a
+ * resistor, capacitor or inductor only, e.g. "R1 n1 n2 1K" -> "R1 n1 n2 2.2K".
+ */
+static bool alterableValue(const QString &old_line, const QString &new_line,
+                           QString &instance, QString &value)
+{
+    if (new_line.contains('\n')) return false;
+    static const QRegularExpression space_rx("\\s+");
+    QStringList o = old_line.split(space_rx, Qt::SkipEmptyParts);
+    QStringList n = new_line.split(space_rx, Qt::SkipEmptyParts);
+    if (o.size() != n.size() || n.size() < 4) return false;
+    for (int i = 0; i < n.size(); i++) {
+        if (i != 3 && o.at(i) != n.at(i)) return false;
+    }
+    QChar type = n.first().at(0).toUpper();
+    if (type != 'R' && type != 'C' && type != 'L') return false;
+    instance = n.first();
+    value = n.at(3);
+    return true;
+}
+
+/*!
+ * \brief NgspiceSession::NgspiceSession Class constructor
+ * \param schematic Schematic that is tuned.
+ * \param parent Parent object
+ */
+NgspiceSession::NgspiceSession(Schematic* schematic, QObject *parent) :
+    Ngspice(schematic, parent),
+    a_loaded(false),
+    a_busy(false),
+    a_control(),
+    a_lines(),
+    a_alters(),
+    a_pending()
+{
+    a_simulator_parameters = _settings::Get().item<QString>("NgspiceParams");
+}
+
+/*!
+ * \brief NgspiceSession::simulate Simulate the schematic in the session.
+ *        finished() is emitted when all simulations are done.
+ * \param tuned Components whose values are changed by the tuner.
+ * \return False if the schematic cannot be simulated.
+ */
+bool NgspiceSession::simulate(const QList<Component*> &tuned)
+{
+    if (a_busy) return false;
+    QStringList commands;
+    if (!a_loaded || !alterCommands(tuned, commands)) {
+        commands.clear();
+        if (!loadCircuit(tuned, commands)) return false;
+    }
+    removeAllSimulatorOutputs();
+    a_output.clear();
+
+    if (a_simProcess->state() == QProcess::NotRunning) {
+        a_simProcess->setWorkingDirectory(a_workdir);
+        QString cmd = QStringLiteral("\"%1\" %2 -p").arg(a_simulator_cmd, a_simulator_parameters);
+        QStringList cmd_args = misc::parseCmdArgs(cmd);
+        QString ngsp_cmd = cmd_args.takeFirst();
+        a_simProcess->start(ngsp_cmd, cmd_args); // the commands are sent once it runs
+    }
+    commands << QStringLiteral("echo %1").arg(DoneMarker);
+    a_busy = true;
+    a_simProcess->write((commands.join('\n') + '\n').toUtf8());
+    emit started();
+    return true;
+}
+
+/*!
+ * \brief NgspiceSession::loadCircuit Write the netlist of the schematic and
+ *        create the commands that load it. Loading the netlist runs its
+ *        .control section, which is kept to run it again after "alter".
+ */
+bool NgspiceSession::loadCircuit(const QList<Component*> &tuned, QStringList &commands)
+{
+    if (!checkSimulation()) return false;
+
+    QString netlist;
+    QTextStream stream(&netlist);
+    a_sims.clear();
+    a_vars.clear();
+    createNetlist(stream, a_sims, a_vars, a_output_files);
+    stream.flush();
+
+    // "exit" would end the session
+    QStringList lines;
+    a_control.clear();
+    bool control = false;
+    for (const QString &line : netlist.split('\n')) {
+        QString cmd = line.trimmed().toLower();
+        if (cmd == "exit" || cmd == "quit") continue;
+        if (cmd == ".control") {
+            control = true;
+        } else if (cmd == ".endc") {
+            control = false;
+        } else if (control) {
+            a_control.append(line);
+        }
+        lines.append(line);
+    }
+
+    QString netfile = "spice4qucs.cir";
+    QFile file(a_workdir + QDir::separator() + netfile);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    QTextStream out(&file);
+    out << lines.join('\n');
+    file.close();
+
+    if (a_simProcess->state() == QProcess::NotRunning) {
+        cleanSpiceinit(); // read when the process starts
+        createSpiceinit(/*initial_spiceinit=*/collectSpiceinit(a_schematic));
+    }
+
+    if (a_loaded) commands << "remcirc";
+    commands << QStringLiteral("source %1").arg(netfile);
+
+    a_lines.clear();
+    for (Component *c : tuned)
+        a_lines.insert(c, c->getSpiceNetlist().trimmed());
+    a_alters.clear();
+    a_loaded = true;
+    return true;
+}
+
+/*!
+ * \brief NgspiceSession::alterCommands Create the commands that apply the
+ *        changes of the tuned components and run the .control section again.
+ *        "reset" in the .control section reverts "alter", so the values are
+ *        altered again after every "reset".
+ * \return False if a change cannot be applied with "alter".
+ */
+bool NgspiceSession::alterCommands(const QList<Component*> &tuned, QStringList &commands)
+{
+    for (Component *c : tuned) {
+        auto it = a_lines.find(c);
+        if (it == a_lines.end()) return false; // not tuned when loaded
+        QString line = c->getSpiceNetlist().trimmed();
+        if (line == *it) continue;
+        QString instance, value;
+        if (!alterableValue(*it, line, instance, value)) return false;
+        a_alters.insert(instance, value);
+        *it = line;
+    }
+
+    QStringList alters;
+    for (auto it = a_alters.cbegin(); it != a_alters.cend(); ++it)
+        alters << QStringLiteral("alter %1 = %2").arg(it.key(), it.value());
+    commands << alters;
+    for (const QString &line : a_control) {
+        commands << line;
+        if (line.trimmed().toLower() == "reset") commands << alters;
+    }
+    return true;
+}
+
+void NgspiceSession::slotProcessOutput()
+{
+    QString s = a_simProcess->readAllStandardOutput();
+    QRegularExpression percentage_pattern("^%\\d\\d*\\.\\d\\d.*$");
+    if (percentage_pattern.match(s).hasMatch()) {
+        emit progress(round(s.mid(1,5).toFloat()));
+    }
+    a_output += s;
+
+    a_pending += s;
+    int pos;
+    while ((pos = a_pending.indexOf('\n')) >= 0) {
+        QString line = a_pending.left(pos).trimmed();
+        a_pending.remove(0, pos + 1);
+        if (a_busy && line.endsWith(DoneMarker)) { // may follow the prompt
+            a_busy = false;
+            emit finished();
+            emit progress(100);
+        }
+    }
+}
+
+/*!
+ * \brief NgspiceSession::slotFinished The Ngspice process has ended, a new
+ *        one is started by the next simulation.
+ */
+void NgspiceSession::slotFinished()
+{
+    a_output += a_simProcess->readAllStandardOutput();
+    a_loaded = false;
+    a_pending.clear();
+    if (a_busy) {
+        a_busy = false;
+        a_output += "Error: Ngspice session terminated\n";
+        emit finished();
+    }
+}
@@ -0,0 +1,63 @@
+/***************************************************************************
+                             ngspicesession.h
+                            ------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef NGSPICESESSION_H
+#define NGSPICESESSION_H
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include "ngspice.h"
+
+/*!
+  \file ngspicesession.h
+  \brief Declaration of the NgspiceSession class
+*/
+
+/*!
+ * \brief The NgspiceSession class keeps an interactive Ngspice process for
+ *        the tuner. The netlist is loaded once. Later value changes of
+ *        resistors, capacitors and inductors are applied with "alter", and
+ *        the .control section is run again in the same process. Any other
+ *        change loads a new netlist into the running process.
+ */
+class NgspiceSession : public Ngspice
+{
+    Q_OBJECT
+
+private:
+    bool a_loaded;      // a circuit is loaded in the process
+    bool a_busy;        // commands sent, the end marker not yet received
+    QStringList a_control;                  // .control section of the loaded circuit
+    QHash<Component*, QString> a_lines;     // netlist of the tuned components as loaded
+    QMap<QString, QString> a_alters;        // instance -> value, since the circuit was loaded
+    QString a_pending;                      // incomplete output line
+
+    bool loadCircuit(const QList<Component*> &tuned, QStringList &commands);
+    bool alterCommands(const QList<Component*> &tuned, QStringList &commands);
+
+public:
+    explicit NgspiceSession(Schematic* schematic, QObject *parent = 0);
+    bool simulate(const QList<Component*> &tuned);
+
+protected slots:
+    void slotFinished();
+    void slotProcessOutput();
+};
+
+#endif // NGSPICESESSION_H
@@ -0,0 +1,557 @@
+/***************************************************************************
+                             ngspiceshared.cpp
+                            -------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "ngspiceshared.h"
+#include "main.h"
+#include "settings.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QLibrary>
+#include <QMutex>
+#include <QPlainTextEdit>
+#include <QRegularExpression>
+#include <QtConcurrent>
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+/*!
+  \file ngspiceshared.cpp
+  \brief Implementation of the NgspiceShared class
+*/
+
+namespace {
+
+// The interface of the Ngspice shared library, as declared in sharedspice.h
+struct vecvalues {
+    char *name;
+    double creal;
+    double cimag;
+    bool is_scale;
+    bool is_complex;
+};
+struct vecvaluesall {
+    int veccount;
+    int vecindex;
+    vecvalues **vecsa;
+};
+struct vecinfo {
+    int number;
+    char *vecname;
+    bool is_real;
+    void *pdvec;
+    void *pdvecscale;
+};
+struct vecinfoall {
+    char *name;
+    char *title;
+    char *date;
+    char *type;
+    int veccount;
+    vecinfo **vecs;
+};
+
+typedef int (SendChar)(char*, int, void*);
+typedef int (SendStat)(char*, int, void*);
+typedef int (ControlledExit)(int, bool, bool, int, void*);
+typedef int (SendData)(vecvaluesall*, int, int, void*);
+typedef int (SendInitData)(vecinfoall*, int, void*);
+typedef int (BGThreadRunning)(bool, int, void*);
+
+typedef int (*NgSpiceInit)(SendChar*, SendStat*, ControlledExit*, SendData*,
+                           SendInitData*, BGThreadRunning*, void*);
+typedef int (*NgSpiceCirc)(char**);
+typedef int (*NgSpiceCommand)(char*);
+
+struct Library {
+    QLibrary lib;
+    NgSpiceInit init = nullptr;
+    NgSpiceCirc circ = nullptr;
+    NgSpiceCommand command = nullptr;
+    bool ready = false;     // ngSpice_Init() done
+    bool exited = false;    // Ngspice has quit, the library must be loaded again
+};
+
+Library& library()
+{
+    static Library ng;
+    return ng;
+}
+
+// Echoed in place of a "write" command whose vectors are streamed
+const char StreamMarker[] = "qucs-stream ";
+
+std::atomic_bool s_busy(false);           // a simulation runs in the library
+QMutex s_currentMutex;                     // guards "s_current"
+NgspiceShared::Run *s_current = nullptr;   // receives the callbacks while busy
+
+void setCurrent(NgspiceShared::Run *run)
+{
+    QMutexLocker lock(&s_currentMutex);
+    s_current = run;
+}
+
+// Calls "f" with the run that receives the callbacks, if there is one.
+template <typename F> void withCurrent(F f)
+{
+    QMutexLocker lock(&s_currentMutex);
+    if (s_current != nullptr) f(s_current);
+}
+
+/*!
+ * Name of a simulation vector as the library reports it, e.g. "v(out)" -> "out"
+ * and "i(v1)" -> "v1#branch".
+ */
+QString vectorKey(const QString &name)
+{
+    static const QRegularExpression fn_rx("^([vi])\\((.+)\\)$");
+    QString key = name.toLower();
+    auto m = fn_rx.match(key);
+    if (m.hasMatch()) {
+        key = m.captured(1) == "v" ? m.captured(2) : m.captured(2) + "#branch";
+    }
+    return key;
+}
+
+} // namespace
+
+/*!
+ * \brief State of one simulation, shared by the kernel and the worker thread
+ *        that runs the library. The plot being simulated and the streamed
+ *        outputs are only touched by the worker.
+ */
+struct NgspiceShared::Run {
+    QStringList init;       // .spiceinit commands
+    QStringList circuit;    // netlist lines
+
+    QMutex mutex;                       // guards "kernel"
+    NgspiceShared *kernel = nullptr;    // null once cancelled or destroyed
+    std::atomic_bool cancelled{false};
+
+    // the plot being simulated
+    QStringList vecnames;
+    QStringList keys;                   // see vectorKey()
+    std::vector<bool> real;
+    std::vector< std::vector<double> > re, im;
+    int scale = -1;
+    int percent = -1;
+
+    QHash<QString, StreamedOutput> outputs;
+
+    void execute();
+    void post(const std::function<void(NgspiceShared*)> &f);
+    void detach();
+    void output(const QString &s);
+    void status(const QString &s);
+    void initPlot(const vecinfoall *info);
+    void addPoint(const vecvaluesall *values);
+    void stream(const QString &args);
+};
+
+static int cbSendChar(char *text, int, void*)
+{
+    withCurrent([text](NgspiceShared::Run *run) { run->output(QString::fromUtf8(text)); });
+    return 0;
+}
+
+static int cbSendStat(char *text, int, void*)
+{
+    withCurrent([text](NgspiceShared::Run *run) { run->status(QString::fromUtf8(text)); });
+    return 0;
+}
+
+static int cbControlledExit(int status, bool, bool, int, void*)
+{
+    library().exited = true;
+    withCurrent([status](NgspiceShared::Run *run) {
+        run->output(QStringLiteral("Ngspice exited with status %1").arg(status));
+    });
+    return 0;
+}
+
+static int cbSendData(vecvaluesall *values, int, int, void*)
+{
+    withCurrent([values](NgspiceShared::Run *run) { run->addPoint(values); });
+    return 0;
+}
+
+static int cbSendInitData(vecinfoall *info, int, void*)
+{
+    withCurrent([info](NgspiceShared::Run *run) { run->initPlot(info); });
+    return 0;
+}
+
+static int cbBGThreadRunning(bool, int, void*)
+{
+    return 0;
+}
+
+/*!
+ * Loads and initializes the library named by the "NgspiceLibrary" setting,
+ * unless this has been done already.
+ */
+static bool loadLibrary(QString &error)
+{
+    Library &ng = library();
+    if (ng.ready && !ng.exited) return true;
+    if (ng.lib.isLoaded()) ng.lib.unload();
+    ng.ready = ng.exited = false;
+
+    QString name = _settings::Get().item<QString>("NgspiceLibrary");
+    ng.lib.setFileName(name);
+    if (!ng.lib.load()) {
+        ng.lib.setFileNameAndVersion(name, 0); // e.g. only libngspice.so.0 is installed
+        if (!ng.lib.load()) {
+            error = ng.lib.errorString();
+            return false;
+        }
+    }
+    ng.init = reinterpret_cast<NgSpiceInit>(ng.lib.resolve("ngSpice_Init"));
+    ng.circ = reinterpret_cast<NgSpiceCirc>(ng.lib.resolve("ngSpice_Circ"));
+    ng.command = reinterpret_cast<NgSpiceCommand>(ng.lib.resolve("ngSpice_Command"));
+    if (ng.init == nullptr || ng.circ == nullptr || ng.command == nullptr) {
+        error = QStringLiteral("%1 is not the Ngspice shared library").arg(ng.lib.fileName());
+        ng.lib.unload();
+        return false;
+    }
+    ng.init(cbSendChar, cbSendStat, cbControlledExit, cbSendData, cbSendInitData,
+            cbBGThreadRunning, nullptr);
+    ng.ready = true;
+    return true;
+}
+
+// Runs in the worker thread.
+void NgspiceShared::Run::execute()
+{
+    Library &ng = library();
+    for (const QString &cmd : init) {
+        QByteArray c = cmd.toUtf8();
+        ng.command(c.data());
+    }
+    QByteArrayList lines;
+    for (const QString &line : circuit)
+        lines.append(line.toUtf8());
+    std::vector<char*> circ;
+    for (QByteArray &line : lines)
+        circ.push_back(line.data());
+    circ.push_back(nullptr);
+    ng.circ(circ.data()); // loads the circuit and runs its .control section
+
+    QByteArray remove("remcirc");
+    ng.command(remove.data());
+
+    QHash<QString, StreamedOutput> result = std::move(outputs);
+    setCurrent(nullptr);
+    s_busy = false;
+    post([result](NgspiceShared *k) { k->finishRun(result); });
+}
+
+/*!
+ * Delivers "f" to the kernel in the GUI thread, unless the kernel is gone.
+ */
+void NgspiceShared::Run::post(const std::function<void(NgspiceShared*)> &f)
+{
+    QMutexLocker lock(&mutex);
+    if (kernel == nullptr) return;
+    NgspiceShared *k = kernel;
+    QMetaObject::invokeMethod(k, [k, f] { f(k); }, Qt::QueuedConnection);
+}
+
+void NgspiceShared::Run::detach()
+{
+    QMutexLocker lock(&mutex);
+    kernel = nullptr;
+    cancelled = true;
+}
+
+void NgspiceShared::Run::output(const QString &s)
+{
+    QString line = s;
+    if (line.startsWith("stdout ") || line.startsWith("stderr ")) line.remove(0, 7);
+    if (line.startsWith(StreamMarker)) {
+        if (!cancelled) stream(line.mid(int(sizeof(StreamMarker)) - 1));
+        return;
+    }
+    post([line](NgspiceShared *k) { k->appendOutput(line + '\n'); });
+}
+
+// Status texts look like "tran: 45.3%"
+void NgspiceShared::Run::status(const QString &s)
+{
+    static const QRegularExpression percent_rx("(\\d+(\\.\\d+)?)%");
+    auto m = percent_rx.match(s);
+    if (!m.hasMatch()) return;
+    int p = qBound(0, qRound(m.captured(1).toDouble()), 100);
+    if (p == percent) return;
+    percent = p;
+    post([p](NgspiceShared *k) { emit k->progress(p); });
+}
+
+// A new plot begins, i.e. an analysis is started.
+void NgspiceShared::Run::initPlot(const vecinfoall *info)
+{
+    vecnames.clear();
+    keys.clear();
+    real.clear();
+    scale = -1;
+    for (int i = 0; i < info->veccount; i++) {
+        vecnames.append(QString::fromUtf8(info->vecs[i]->vecname));
+        keys.append(vectorKey(vecnames.last()));
+        real.push_back(info->vecs[i]->is_real);
+    }
+    re.assign(keys.size(), std::vector<double>());
+    im.assign(keys.size(), std::vector<double>());
+}
+
+void NgspiceShared::Run::addPoint(const vecvaluesall *values)
+{
+    if (cancelled) return;
+    int n = qMin(values->veccount, int(re.size()));
+    for (int i = 0; i < n; i++) {
+        const vecvalues *v = values->vecsa[i];
+        re[i].push_back(v->creal);
+        if (!real[i]) im[i].push_back(v->cimag);
+        if (v->is_scale) scale = i;
+    }
+}
+
+/*!
+ * Appends the vectors of the current plot to the streamed output that replaces
+ * an output file. "args" is the file name followed by the vectors, as given to
+ * the replaced "write" command. Parameter sweeps append one plot per step.
+ */
+void NgspiceShared::Run::stream(const QString &args)
+{
+    QStringList vars = args.split(' ', Qt::SkipEmptyParts);
+    if (vars.size() < 2) return;
+    QString file = vars.takeFirst();
+
+    if (keys.isEmpty()) {
+        post([file](NgspiceShared *k) {
+            k->appendOutput(QStringLiteral("No simulation data for %1\n").arg(file));
+        });
+        return;
+    }
+    int s = qMax(scale, 0);
+    bool isComplex = !real[s];
+    std::vector<int> cols;
+    for (const QString &var : vars) {
+        int col = keys.indexOf(vectorKey(var));
+        if (col < 0) {
+            post([file, var](NgspiceShared *k) {
+                k->appendOutput(QStringLiteral("Vector %1 was not simulated, %2 is not written\n")
+                                .arg(var, file));
+            });
+            return;
+        }
+        cols.push_back(col);
+        isComplex = isComplex || !real[col];
+    }
+
+    StreamedOutput &out = outputs[file];
+    if (out.var_list.isEmpty()) {
+        out.var_list = QStringList(vecnames.at(s)) + vars;
+        out.isComplex = isComplex;
+    }
+    const int NumColumns = out.isComplex ? 1 + 2*int(cols.size()) : 1 + int(cols.size());
+    std::vector<double> point(NumColumns);
+    size_t NumPoints = re[s].size();
+    for (size_t p = 0; p < NumPoints; p++) {
+        point[0] = re[s][p];
+        int c = 1;
+        for (int col : cols) {
+            point[c++] = p < re[col].size() ? re[col][p] : 0.0;
+            if (out.isComplex)
+                point[c++] = p < im[col].size() ? im[col][p] : 0.0;
+        }
+        out.points.appendPoint(point.data(), NumColumns);
+    }
+}
+
+// ---------------------------------------------------------------------
+/*!
+ * \brief NgspiceShared::NgspiceShared Class constructor
+ * \param schematic Schematic that need to be simulated with Ngspice.
+ * \param parent Parent object
+ */
+NgspiceShared::NgspiceShared(Schematic* schematic, QObject *parent) :
+    Ngspice(schematic, parent),
+    a_run(),
+    a_worker()
+{
+}
+
+/*!
+ * \brief NgspiceShared::~NgspiceShared A running simulation is not waited for,
+ *        it finishes in the background and its results are dropped.
+ */
+NgspiceShared::~NgspiceShared()
+{
+    if (a_run) a_run->detach();
+}
+
+/*!
+ * \brief NgspiceShared::isEnabled Whether Ngspice simulations use the shared
+ *        library instead of the Ngspice executable.
+ */
+bool NgspiceShared::isEnabled()
+{
+    return QucsSettings.DefaultSimulator == spicecompat::simNgspice &&
+           _settings::Get().item<bool>("NgspiceShared");
+}
+
+/*!
+ * \brief NgspiceShared::streamOutputs Prepare the netlist for the library.
+ *        Every "write" of plain node voltages and branch currents is replaced
+ *        by a marker, upon which the vectors are taken from the streamed plot.
+ *        Files written after the plot was changed (FFT, noise) and files with
+ *        other vectors (equations, S-parameters) are written as usual.
+ *        "exit" is removed, it would unload Ngspice.
+ *        The library runs in this process, so the files are given with the
+ *        work directory instead of changing the current directory of the
+ *        process.
+ * \param netlist Lines of the netlist
+ * \return Lines passed to the library
+ */
+QStringList NgspiceShared::streamOutputs(const QStringList &netlist)
+{
+    static const QRegularExpression write_rx("^\\s*write\\s+(spice4qucs\\.\\S+\\.plot)\\s+(.+)$",
+                                             QRegularExpression::CaseInsensitiveOption);
+    static const QRegularExpression var_rx("^[vi]\\([^()]+\\)$",
+                                           QRegularExpression::CaseInsensitiveOption);
+    static const QRegularExpression derived_rx("^\\s*(setplot|linearize|fft)\\s",
+                                               QRegularExpression::CaseInsensitiveOption);
+    static const QRegularExpression exit_rx("^\\s*(exit|quit)\\s*$",
+                                            QRegularExpression::CaseInsensitiveOption);
+    static const QRegularExpression file_rx("(^|[\\s>])(spice4qucs\\.\\S+)");
+
+    // output files go into the work directory
+    const QString dir = QDir(a_workdir).absolutePath() + '/';
+    const QString file = dir.contains(' ') ? "\\1\"" + dir + "\\2\"" : "\\1" + dir + "\\2";
+
+    QStringList lines;
+    bool derived = false; // the current plot is not the one of the analysis
+    for (const QString &line : netlist) {
+        if (exit_rx.match(line).hasMatch()) continue;
+        if (derived_rx.match(line).hasMatch()) derived = true;
+        if (line.trimmed().toLower() == "reset") derived = false;
+
+        auto m = write_rx.match(line);
+        if (m.hasMatch() && !derived) {
+            QStringList vars = m.captured(2).split(' ', Qt::SkipEmptyParts);
+            bool streamed = true;
+            for (const QString &var : vars) {
+                if (!var_rx.match(var).hasMatch()) streamed = false;
+            }
+            if (streamed) {
+                lines.append(QStringLiteral("echo %1%2 %3")
+                             .arg(QString(StreamMarker), m.captured(1), vars.join(' ')));
+                continue;
+            }
+        }
+        lines.append(QString(line).replace(file_rx, file));
+    }
+    return lines;
+}
+
+void NgspiceShared::appendOutput(const QString &s)
+{
+    a_output += s;
+    if (a_console != nullptr) {
+        a_console->insertPlainText(s);
+        a_console->moveCursor(QTextCursor::End);
+    }
+}
+
+void NgspiceShared::finishRun(const QHash<QString, StreamedOutput> &outputs)
+{
+    a_streamedOutputs = outputs;
+    a_run.reset();
+    emit finished();
+    emit progress(100);
+}
+
+/*!
+ * \brief NgspiceShared::slotSimulate Simulate the schematic in the shared
+ *        library. The Ngspice executable is used instead if the library
+ *        cannot be loaded or is busy with another simulation.
+ */
+void NgspiceShared::slotSimulate()
+{
+    QString error;
+    if (s_busy) {
+        error = tr("another simulation is running");
+    } else {
+        loadLibrary(error);
+    }
+    if (!error.isEmpty()) {
+        Ngspice::slotSimulate();
+        appendOutput(tr("Ngspice shared library not used: %1\n").arg(error));
+        return;
+    }
+
+    if (!checkSimulation()) return;
+
+    QString netlist;
+    QTextStream stream(&netlist);
+    a_sims.clear();
+    a_vars.clear();
+    createNetlist(stream, a_sims, a_vars, a_output_files);
+    stream.flush();
+
+    removeAllSimulatorOutputs();
+    a_streamedOutputs.clear();
+
+    auto run = std::make_shared<Run>();
+    run->kernel = this;
+    // the library keeps its settings from previous simulations
+    run->init << "unset ngbehavior"
+              << spiceinitContents(collectSpiceinit(a_schematic)).split('\n', Qt::SkipEmptyParts);
+    run->circuit = streamOutputs(netlist.split('\n'));
+
+    a_run = run;
+    s_busy = true;
+    setCurrent(run.get());
+    a_worker = QtConcurrent::run([run] { run->execute(); });
+    if (QucsMain != nullptr)
+        emit started();
+}
+
+/*!
+ * \brief NgspiceShared::killThemAll Stop waiting for the simulation. The
+ *        library cannot be interrupted, it completes the simulation in the
+ *        background and the results are dropped.
+ */
+void NgspiceShared::killThemAll()
+{
+    if (a_run) {
+        a_run->detach();
+        a_run.reset();
+        QMetaObject::invokeMethod(this, [this] { emit finished(); }, Qt::QueuedConnection);
+    }
+    Ngspice::killThemAll();
+}
+
+// The library cannot be interrupted, so its simulation is waited for
+// without a time limit.
+bool NgspiceShared::waitEndOfSimulation(int msecs)
+{
+    if (!a_run) return Ngspice::waitEndOfSimulation(msecs);
+    a_worker.waitForFinished();
+    QCoreApplication::sendPostedEvents(this); // output and results of the worker
+    return true;
+}
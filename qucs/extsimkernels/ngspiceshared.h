@@ -0,0 +1,70 @@
+/***************************************************************************
+                              ngspiceshared.h
+                             -----------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef NGSPICESHARED_H
+#define NGSPICESHARED_H
+
+#include <QFuture>
+#include <QString>
+#include <QStringList>
+#include "ngspice.h"
+
+#include <memory>
+
+/*!
+  \file ngspiceshared.h
+  \brief Declaration of the NgspiceShared class
+*/
+
+/*!
+ * \brief The NgspiceShared class runs Ngspice in-process through the Ngspice
+ *        shared library (libngspice). The netlist is passed to the library in
+ *        memory and the simulation vectors are received by callbacks, so no
+ *        netlist file is written and no raw file is parsed. Output that is
+ *        not a plain simulation vector (equations, FFT, noise, S-parameters)
+ *        is still written to the usual spice4qucs.* files.
+ *
+ *        The library holds one circuit at a time, so only one NgspiceShared
+ *        simulation runs at once. A running simulation cannot be interrupted,
+ *        killThemAll() only drops its results.
+ */
+class NgspiceShared : public Ngspice
+{
+    Q_OBJECT
+
+public:
+    struct Run;
+
+    explicit NgspiceShared(Schematic* schematic, QObject *parent = 0);
+    ~NgspiceShared();
+    bool waitEndOfSimulation(int msecs = 10000);
+
+    static bool isEnabled();
+
+private:
+    std::shared_ptr<Run> a_run;   // the simulation started last
+    QFuture<void> a_worker;
+
+    QStringList streamOutputs(const QStringList &netlist);
+    void appendOutput(const QString &s);
+    void finishRun(const QHash<QString, StreamedOutput> &outputs);
+
+public slots:
+    void slotSimulate();
+    void killThemAll();
+};
+
+#endif // NGSPICESHARED_H
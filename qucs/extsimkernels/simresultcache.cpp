@@ -0,0 +1,134 @@
+/***************************************************************************
+                            simresultcache.cpp
+                           --------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "simresultcache.h"
+#include "main.h"
+#include "settings.h"
+#include "diagrams/qdbfile.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+/*!
+  \file simresultcache.cpp
+  \brief Implementation of the SimResultCache class
+*/
+
+QString SimResultCache::directory()
+{
+    return QucsSettings.S4Qworkdir + QDir::separator() + "cache";
+}
+
+/*!
+ * \brief SimResultCache::maxSize Size limit of the cache in bytes,
+ *        0 if results are not cached.
+ */
+qint64 SimResultCache::maxSize()
+{
+    return qint64(qMax(0, _settings::Get().item<int>("SimResultCacheSize"))) << 20;
+}
+
+bool SimResultCache::contains(const QString &key)
+{
+    return QFile::exists(QDir(directory()).filePath(key + ".dat"));
+}
+
+/*!
+ * \brief SimResultCache::log The simulator log of the cached simulation.
+ */
+QString SimResultCache::log(const QString &key)
+{
+    QFile file(QDir(directory()).filePath(key + ".log"));
+    if (!file.open(QIODevice::ReadOnly)) return QString();
+    return QString::fromUtf8(file.readAll());
+}
+
+/*!
+ * \brief SimResultCache::restore Copy the cached dataset to "qucs_dataset".
+ *        The sidecar is copied after the dataset, so it is at least as new.
+ * \return False if the entry cannot be copied.
+ */
+bool SimResultCache::restore(const QString &key, const QString &qucs_dataset)
+{
+    QString base = QDir(directory()).filePath(key);
+    QString qdb_file = qdb::sidecarName(qucs_dataset);
+    QFile::remove(qdb_file); // never pair an outdated sidecar with the dataset
+    QFile::remove(qucs_dataset);
+    if (!QFile::copy(base + ".dat", qucs_dataset)) return false;
+    if (QFile::exists(base + ".qdb")) QFile::copy(base + ".qdb", qdb_file);
+    touch(base + ".dat");
+    return true;
+}
+
+/*!
+ * \brief SimResultCache::store Add the dataset "qucs_dataset" and its sidecar
+ *        to the cache and remove old entries beyond the size limit.
+ */
+void SimResultCache::store(const QString &key, const QString &qucs_dataset, const QString &log)
+{
+    QDir dir(directory());
+    if (!dir.mkpath(".")) return;
+    QString base = dir.filePath(key);
+    QFile::remove(base + ".dat");
+    QFile::remove(base + ".qdb");
+    QFile::remove(base + ".log");
+
+    QFile log_file(base + ".log");
+    if (log_file.open(QIODevice::WriteOnly)) {
+        log_file.write(log.toUtf8());
+        log_file.close();
+    }
+    QString qdb_file = qdb::sidecarName(qucs_dataset);
+    if (QFile::exists(qdb_file)) QFile::copy(qdb_file, base + ".qdb");
+    // the dataset marks a complete entry, so it is copied last
+    if (!QFile::copy(qucs_dataset, base + ".dat")) return;
+    touch(base + ".dat");
+
+    evict(maxSize());
+}
+
+/*!
+ * \brief SimResultCache::evict Remove the least recently used entries until
+ *        the cache holds at most "max_size" bytes.
+ */
+void SimResultCache::evict(qint64 max_size)
+{
+    QDir dir(directory());
+    // the modification time of the dataset is the time of its last use
+    const QFileInfoList datasets = dir.entryInfoList(QStringList("*.dat"), QDir::Files, QDir::Time);
+    qint64 total = 0;
+    for (const QFileInfo &dat : datasets) {
+        QString base = dir.filePath(dat.completeBaseName());
+        qint64 size = dat.size() + QFileInfo(base + ".qdb").size()
+                      + QFileInfo(base + ".log").size();
+        total += size;
+        if (total <= max_size) continue;
+        QFile::remove(base + ".dat");
+        QFile::remove(base + ".qdb");
+        QFile::remove(base + ".log");
+    }
+}
+
+/*!
+ * \brief SimResultCache::touch Mark an entry as used.
+ */
+void SimResultCache::touch(const QString &filename)
+{
+    QFile file(filename);
+    if (file.open(QIODevice::ReadWrite))
+        file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+}
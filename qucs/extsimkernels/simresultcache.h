@@ -0,0 +1,51 @@
+/***************************************************************************
+                             simresultcache.h
+                            ------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef SIMRESULTCACHE_H
+#define SIMRESULTCACHE_H
+
+#include <QString>
+
+/*!
+  \file simresultcache.h
+  \brief Declaration of the SimResultCache class
+*/
+
+/*!
+ * \brief The SimResultCache class keeps the datasets of earlier SPICE
+ *        simulations in the "cache" subdirectory of the simulator workdir.
+ *        An entry is stored under the key of its simulation, see
+ *        AbstractSpiceKernel::resultCacheKey(), and consists of the dataset
+ *        (key.dat), its .qdb sidecar (key.qdb) and the simulator log
+ *        (key.log). The least recently used entries are removed once the
+ *        cache grows beyond the size set by "SimResultCacheSize" (MB).
+ */
+class SimResultCache
+{
+public:
+    static QString directory();
+    static qint64 maxSize();
+    static bool contains(const QString &key);
+    static QString log(const QString &key);
+    static bool restore(const QString &key, const QString &qucs_dataset);
+    static void store(const QString &key, const QString &qucs_dataset, const QString &log);
+    static void evict(qint64 max_size);
+
+private:
+    static void touch(const QString &filename);
+};
+
+#endif // SIMRESULTCACHE_H
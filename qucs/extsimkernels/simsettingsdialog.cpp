@@ -34,12 +34,18 @@ SimSettingsDialog::SimSettingsDialog(QWidget *parent) :
     a_lblXyceSimParam(new QLabel(tr("Xyce CLI parameters"))),
     a_lblSpopusSimParam(new QLabel(tr("SpiceOpus CLI parameters"))),
     a_lblCompatMode(new QLabel(tr("Ngspice compatibility mode"))),
+    a_lblSweepShards(new QLabel(tr("Ngspice processes per parameter sweep"))),
+    a_lblResultCache(new QLabel(tr("Simulation result cache size (MB)"))),
     a_cbxCompatMode(new QComboBox),
+    a_spbSweepShards(new QSpinBox),
+    a_spbResultCache(new QSpinBox),
+    a_cbxNgspiceShared(new QCheckBox(tr("Run Ngspice in-process using the shared library"))),
     a_edtNgspice(new QLineEdit(QucsSettings.NgspiceExecutable)),
     a_edtSpiceOpus(new QLineEdit(QucsSettings.SpiceOpusExecutable)),
     a_edtXyce(new QLineEdit(QucsSettings.XyceExecutable)),
     a_edtQucsator(new QLineEdit(QucsSettings.Qucsator)),
     a_edtNgspiceSimParam(new QLineEdit()),
+    a_edtNgspiceLibrary(new QLineEdit(_settings::Get().item<QString>("NgspiceLibrary"))),
     a_edtXyceSimParam(new QLineEdit()),
     a_edtSpopusSimParam(new QLineEdit()),
     a_btnOK(new QPushButton(tr("Apply changes"))),
@@ -70,6 +76,21 @@ SimSettingsDialog::SimSettingsDialog(QWidget *parent) :
     auto compat_mode = _settings::Get().item<int>("NgspiceCompatMode");
     a_cbxCompatMode->setCurrentIndex(compat_mode);
 
+    a_spbSweepShards->setRange(1, 256);
+    a_spbSweepShards->setValue(_settings::Get().item<int>("NgspiceSweepShards"));
+    a_spbSweepShards->setToolTip(tr("Split the values of parameter sweeps between "
+                                    "several Ngspice processes running in parallel"));
+
+    a_spbResultCache->setRange(0, 65536);
+    a_spbResultCache->setValue(_settings::Get().item<int>("SimResultCacheSize"));
+    a_spbResultCache->setToolTip(tr("Reuse the results of simulations with the same netlist, "
+                                    "0 disables the cache. Hold Shift when starting a "
+                                    "simulation to run it again anyway"));
+
+    a_cbxNgspiceShared->setChecked(_settings::Get().item<bool>("NgspiceShared"));
+    a_edtNgspiceLibrary->setToolTip(tr("Name or location of the Ngspice shared library, "
+                                       "e.g. ngspice or /usr/lib/libngspice.so"));
+
     QVBoxLayout *top = new QVBoxLayout;
 
     QGroupBox *gbp1 = new QGroupBox(this);
@@ -85,6 +106,14 @@ SimSettingsDialog::SimSettingsDialog(QWidget *parent) :
     h4->addWidget(a_lblCompatMode);
     h4->addWidget(a_cbxCompatMode);
     top2->addLayout(h4);
+    QHBoxLayout *h5 = new QHBoxLayout;
+    h5->addWidget(a_lblSweepShards);
+    h5->addWidget(a_spbSweepShards);
+    top2->addLayout(h5);
+    QHBoxLayout *h6 = new QHBoxLayout;
+    h6->addWidget(a_cbxNgspiceShared);
+    h6->addWidget(a_edtNgspiceLibrary);
+    top2->addLayout(h6);
     top2->addWidget(a_lblNgspiceSimParam);
     top2->addWidget(a_edtNgspiceSimParam);
 
@@ -103,6 +132,10 @@ SimSettingsDialog::SimSettingsDialog(QWidget *parent) :
     top2->addLayout(h7);
     top2->addWidget(a_lblSpopusSimParam);
     top2->addWidget(a_edtSpopusSimParam);
+    QHBoxLayout *h8 = new QHBoxLayout;
+    h8->addWidget(a_lblResultCache);
+    h8->addWidget(a_spbResultCache);
+    top2->addLayout(h8);
 
     gbp1->setLayout(top2);
     top->addWidget(gbp1);
@@ -140,6 +173,10 @@ void SimSettingsDialog::slotApply()
     QucsSettings.Qucsator = a_edtQucsator->text();
     settingsManager& qs = _settings::Get();
     qs.setItem<int>("NgspiceCompatMode", a_cbxCompatMode->currentIndex());
+    qs.setItem<int>("NgspiceSweepShards", a_spbSweepShards->value());
+    qs.setItem<bool>("NgspiceShared", a_cbxNgspiceShared->isChecked());
+    qs.setItem<QString>("NgspiceLibrary", a_edtNgspiceLibrary->text());
+    qs.setItem<int>("SimResultCacheSize", a_spbResultCache->value());
     qs.setItem<QString>("NgspiceParams", a_edtNgspiceSimParam->text());
     qs.setItem<QString>("XyceParams", a_edtXyceSimParam->text());
     qs.setItem<QString>("SpopusParams", a_edtSpopusSimParam->text());
@@ -35,14 +35,20 @@ private:
     QLabel *a_lblXyceSimParam;
     QLabel *a_lblSpopusSimParam;
     QLabel *a_lblCompatMode;
+    QLabel *a_lblSweepShards;
+    QLabel *a_lblResultCache;
 
     QComboBox *a_cbxCompatMode;
+    QSpinBox *a_spbSweepShards;
+    QSpinBox *a_spbResultCache;
+    QCheckBox *a_cbxNgspiceShared;
 
     QLineEdit *a_edtNgspice;
     QLineEdit *a_edtSpiceOpus;
     QLineEdit *a_edtXyce;
     QLineEdit *a_edtQucsator;
     QLineEdit *a_edtNgspiceSimParam;
+    QLineEdit *a_edtNgspiceLibrary;
     QLineEdit *a_edtXyceSimParam;
     QLineEdit *a_edtSpopusSimParam;
 
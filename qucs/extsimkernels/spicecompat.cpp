@@ -2,7 +2,12 @@
 #include "main.h"
 #include "misc.h"
 
+#include <QDateTime>
 #include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
 #include <QRegularExpression>
 
 /*!
@@ -268,70 +273,157 @@ QString spicecompat::convert_relative_filename(QString filename)
 }
 */
 
-int spicecompat::getPins(const QString &file, const QString &compname, QStringList &pin_names)
-{
-    int r = 0;
-    QString content;
-    QFile f(file);
-    if (f.open(QIODevice::ReadOnly)) {
-        QTextStream ts(&f);
-        content = ts.readAll();
-        f.close();
-    } else return 0;
+namespace {
+
+/*!
+ * \brief The .SUBCKT header of a subcircuit in a SPICE file.
+ */
+struct SubcktHeader {
+    QString name;       // as written in the file
+    QStringList pins;
+    int headerPins = 0; // pins on the .SUBCKT line itself, without "+" lines
+    QStringList params;
+    qint64 offset = 0;  // of the .SUBCKT line in the file
+};
+
+/*!
+ * \brief Index of the subcircuits of a SPICE file.
+ */
+struct SubcktIndex {
+    QDateTime modified;
+    qint64 size = -1;
+    QList<SubcktHeader> subckts;    // in file order
+    QHash<QString, int> byName;     // lower case name -> first subcircuit of that name
+};
 
-    const QRegularExpression subckt_header("^\\s*\\.(S|s)(U|u)(B|b)(C|c)(K|k)(T|t)\\s.*");
-    const QRegularExpression sep("\\s");
+QMutex subcktIndexMutex;
+QHash<QString, SubcktIndex> subcktIndexes; // key: file name
+
+/*!
+ * \brief buildSubcktIndex Collect the .SUBCKT headers of a SPICE file.
+ *        Only lines starting with a dot and the continuation lines of a
+ *        header are decoded, the rest of the file is skipped.
+ */
+void buildSubcktIndex(const QByteArray &content, SubcktIndex &index)
+{
+    static const QRegularExpression subckt_header("^\\s*\\.(S|s)(U|u)(B|b)(C|c)(K|k)(T|t)\\s.*");
+    static const QRegularExpression sep("\\s");
+    static const QRegularExpression blank("[ \\t]");
 
-    QTextStream stream(&content,QIODevice::ReadOnly);
     bool header_start = false;
-    while (!stream.atEnd()) {
-        QString lin = stream.readLine();
+    qint64 pos = 0;
+    while (pos < content.size()) {
+        qint64 start = pos;
+        qint64 end = content.indexOf('\n', start);
+        if (end < 0) end = content.size();
+        pos = end + 1;
+
+        qint64 first = start;
+        while (first < end && (content.at(first) == ' ' || content.at(first) == '\t')) first++;
+        bool dot = first < end && content.at(first) == '.';
+        if (!dot && !header_start) continue;
+
+        QString lin = QString::fromUtf8(content.constData() + start, end - start);
+        if (lin.endsWith('\r')) lin.chop(1);
         auto start_comment = lin.indexOf(';');
         if (start_comment != -1) {
-          lin = lin.left(start_comment);
+            lin = lin.left(start_comment);
         }
 
         if (header_start) {
-          // line continuation
-          if (lin.startsWith("+")) {
-            lin.remove(0,1);
-            QStringList pins = lin.split(QRegularExpression("[ \\t]"),Qt::SkipEmptyParts);
-            for(const auto &pin: pins) {
-              if (pin.toLower() == "params:") {
-                header_start = false;
-                break;
-              } else {
-                pin_names.append(pin);
-              }
+            // line continuation
+            if (lin.startsWith("+")) {
+                SubcktHeader &header = index.subckts.last();
+                lin.remove(0,1);
+                QStringList pins = lin.split(blank, Qt::SkipEmptyParts);
+                for (const auto &pin : pins) {
+                    if (!header_start) {
+                        header.params.append(pin);
+                    } else if (pin.toLower() == "params:") {
+                        header_start = false;
+                    } else {
+                        header.pins.append(pin);
+                    }
+                }
+                continue;
             }
-          } else {
-            // end of header
-            header_start = false;
-            break;
-          }
+            header_start = false; // end of header
         }
 
-        if (subckt_header.match(lin).hasMatch()) {
-            QStringList lst2 = lin.split(sep, Qt::SkipEmptyParts);
-            QString name = lin.section(sep,1,1,QString::SectionSkipEmpty).toLower();
-            QString refname = compname.toLower();
-            if (name != refname) continue;
-            header_start = true;
-            lst2.removeFirst();
-            lst2.removeFirst();
-            for (const auto &s1: lst2) {
-                QString pp = s1;
-                if (pp.toLower() == "params:") header_start = false;
-                if (!s1.contains('=') &&
-                   (pp.toLower() != "params:")) {
-                    pin_names.append(s1);
-                }
+        if (!dot || !subckt_header.match(lin).hasMatch()) continue;
+        QStringList lst2 = lin.split(sep, Qt::SkipEmptyParts);
+        if (lst2.count() < 2) continue;
+        SubcktHeader header;
+        header.name = lst2.at(1);
+        header.offset = start;
+        header_start = true;
+        for (int i = 2; i < lst2.count(); i++) {
+            const QString &s1 = lst2.at(i);
+            if (s1.toLower() == "params:") {
+                header_start = false;
+            } else if (s1.contains('=')) {
+                header.params.append(s1);
+            } else {
+                header.pins.append(s1);
             }
-            r = pin_names.count();
-            //break;
         }
+        header.headerPins = header.pins.count();
+        QString key = header.name.toLower();
+        if (!index.byName.contains(key)) index.byName.insert(key, index.subckts.count());
+        index.subckts.append(header);
     }
+}
+
+/*!
+ * \brief subcktIndex The index of a SPICE file, it is built again when the
+ *        file changed. The caller holds subcktIndexMutex.
+ * \return nullptr if the file cannot be read.
+ */
+const SubcktIndex *subcktIndex(const QString &file)
+{
+    QFileInfo inf(file);
+    auto it = subcktIndexes.find(file);
+    if (it != subcktIndexes.end() && it->modified == inf.lastModified()
+        && it->size == inf.size()) {
+        return &*it;
+    }
+
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly)) {
+        if (it != subcktIndexes.end()) subcktIndexes.erase(it);
+        return nullptr;
+    }
+    SubcktIndex index;
+    index.modified = inf.lastModified();
+    index.size = inf.size();
+    buildSubcktIndex(f.readAll(), index);
+    f.close();
+    return &*subcktIndexes.insert(file, index);
+}
+
+} // namespace
 
+/*!
+ * \brief spicecompat::getPins Append the pins of a subcircuit to "pin_names".
+ *        The headers of SPICE files are indexed once and the index is shared
+ *        by all callers, it is rebuilt when the file changes.
+ * \param file SPICE file
+ * \param compname .SUBCKT entry name, case-insensitive
+ * \param pin_names[out] pins are appended here
+ * \return Number of entries of "pin_names" up to the pins on the .SUBCKT line
+ *         itself, 0 if the subcircuit is not found.
+ */
+int spicecompat::getPins(const QString &file, const QString &compname, QStringList &pin_names)
+{
+    QMutexLocker lock(&subcktIndexMutex);
+    const SubcktIndex *index = subcktIndex(file);
+    if (index == nullptr) return 0;
+    auto it = index->byName.constFind(compname.toLower());
+    if (it == index->byName.constEnd()) return 0;
+
+    const SubcktHeader &header = index->subckts.at(*it);
+    int r = pin_names.count() + header.headerPins;
+    pin_names.append(header.pins);
     return r;
 }
 
@@ -342,22 +434,10 @@ int spicecompat::getPins(const QString &file, const QString &compname, QStringLi
  */
 QString spicecompat::getSubcktName(const QString& subfilename)
 {
-    QString s = "";
-
-    QFile sub_file(subfilename);
-    if (sub_file.open(QIODevice::ReadOnly)) {
-        const QRegularExpression subckt_header("^\\s*\\.(S|s)(U|u)(B|b)(C|c)(K|k)(T|t)\\s.*");
-        const QRegularExpression sep("\\s");
-        QStringList lst = QString(sub_file.readAll()).split("\n");
-        for (const QString& str : lst) {
-            if (subckt_header.match(str).hasMatch()) {
-                s = str.section(sep,1,1,QString::SectionSkipEmpty);
-                break;
-            }
-        }
-        sub_file.close();
-    }
-    return s;
+    QMutexLocker lock(&subcktIndexMutex);
+    const SubcktIndex *index = subcktIndex(subfilename);
+    if (index == nullptr || index->subckts.isEmpty()) return QString("");
+    return index->subckts.first().name;
 }
 
 /*!
@@ -43,13 +43,24 @@
  */
 Xyce::Xyce(Schematic* schematic, QObject *parent) :
     AbstractSpiceKernel(schematic, parent),
-    a_Noisesim(false),
+    a_MPI(false),
     a_simulationsQueue(),
-    a_netlistQueue()
+    a_netlistQueue(),
+    a_jobs(),
+    a_jobsTotal(0),
+    a_jobsDone(0)
 {
     a_simulator_cmd = QucsSettings.XyceExecutable;
 }
 
+Xyce::~Xyce()
+{
+    for (const Job &job : a_jobs) {
+        job.process->disconnect(this);
+        job.process->kill();
+    }
+}
+
 /*!
  * \brief Xyce::determineUsedSimulations Determine simulation used
  *        in schematic and add them into a_simulationsQueue list
@@ -346,6 +357,18 @@ void Xyce::slotSimulate()
     }
 
     a_output.clear();
+    QByteArray netlists;
+    for (const QString &netlist : a_netlistQueue) {
+        QFile file(netlist);
+        if (file.open(QIODevice::ReadOnly)) netlists += file.readAll();
+    }
+    if (lookupResultCache(netlists)) {
+        a_netlistQueue.clear();
+        return;
+    }
+
+    a_jobsTotal = a_netlistQueue.count();
+    a_jobsDone = 0;
     emit started();
     nextSimulation();
 
@@ -389,41 +412,84 @@ void Xyce::SaveNetlist(QString filename, bool netlist2Console)
 }
 
 /*!
- * \brief Xyce::slotFinished Simulator finished handler. End simulation or
- *        execute the next simulation from queue.
+ * \brief Xyce::slotFinished Simulator finished handler. Collect the output
+ *        of the finished process and start the next simulations from queue.
+ *        The simulation ends when all processes have finished.
  */
 void Xyce::slotFinished()
 {
-    a_output += a_simProcess->readAllStandardOutput();;
+    int idx = findJob(sender());
+    if (idx < 0) return;
+    Job job = a_jobs.takeAt(idx);
+    if (job.process->exitStatus() != QProcess::NormalExit || job.process->exitCode() != 0) {
+        a_resultKey.clear(); // crashed or failed, the results must not be cached
+    }
+    QString s = job.process->readAllStandardOutput();
+    job.output += s;
+    job.process->deleteLater();
 
-    if (a_Noisesim) {
+    bool live = (maxJobs() == 1 || a_jobsTotal == 1);
+    if (a_console != nullptr) {
+        a_console->insertPlainText(live ? s : job.output);
+        a_console->moveCursor(QTextCursor::End);
+    }
+    a_output += job.output;
+
+    if (job.netlist.endsWith(".noise.cir")) { // noise results are printed to stdout
         QFile logfile(a_workdir + QDir::separator() + "spice4qucs.noise_log");
         if (logfile.open(QIODevice::WriteOnly)) {
             QTextStream ts(&logfile);
-            ts<<a_output;
+            ts<<job.output;
             logfile.close();
         }
-        a_Noisesim = false;
         a_output_files.append("spice4qucs.noise_log");
     }
 
-    if (a_netlistQueue.isEmpty()) {
-        emit finished();
-        emit progress(100);
-        return;
-    } else {
-        nextSimulation();
+    a_jobsDone++;
+    reportProgress();
+    nextSimulation();
+}
+
+/*!
+ * \brief Xyce::slotJobError Forward the errors of simulator processes. If
+ *        Xyce cannot be started, the remaining simulations are cancelled.
+ *        A run with errors is never stored in the result cache.
+ */
+void Xyce::slotJobError(QProcess::ProcessError err)
+{
+    a_resultKey.clear(); // the output of this run is not trustworthy
+    int idx = findJob(sender());
+    if (idx >= 0 && err == QProcess::FailedToStart) {
+        a_jobs.takeAt(idx).process->deleteLater(); // no finished() follows
+        a_netlistQueue.clear();
+        killThemAll();
     }
+    emit errors(err);
 }
 
-bool Xyce::waitEndOfSimulation()
+bool Xyce::waitEndOfSimulation(int msecs)
 {
-    bool ok = false;
-    while (!a_netlistQueue.isEmpty()) {
-        ok = a_simProcess->waitForFinished(10000);
+    // Finished processes are removed and the next ones started by slotFinished()
+    while (!a_jobs.isEmpty()) {
+        QProcess *process = a_jobs.first().process;
+        if (!process->waitForFinished(msecs) &&
+            process->state() == QProcess::NotRunning &&
+            findJob(process) == 0) return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Xyce::killThemAll Cancel the queue and stop all running simulator
+ *        processes.
+ */
+void Xyce::killThemAll()
+{
+    a_netlistQueue.clear();
+    a_resultKey.clear(); // the output is incomplete
+    for (const Job &job : a_jobs) {
+        job.process->kill();
     }
-    ok = a_simProcess->waitForFinished(10000);
-    return ok;
 }
 
 /*!
@@ -431,45 +497,104 @@ bool Xyce::waitEndOfSimulation()
  */
 void Xyce::slotProcessOutput()
 {
+    int idx = findJob(sender());
+    if (idx < 0) return;
+    Job &job = a_jobs[idx];
     //***** Percent complete: 85.4987 %
-    QString s = a_simProcess->readAllStandardOutput();
+    QString s = job.process->readAllStandardOutput();
     if (s.contains("Percent complete:")) {
-        int percent = round(s.section(' ',3,3,QString::SectionSkipEmpty).toFloat());
-        emit progress(percent);
+        job.progress = round(s.section(' ',3,3,QString::SectionSkipEmpty).toFloat());
+        reportProgress();
     }
-    a_output += s;
-    if (a_console != nullptr) {
+    job.output += s;
+    // Output of concurrent processes is shown when each of them finishes
+    bool live = (maxJobs() == 1 || a_jobsTotal == 1);
+    if (live && a_console != nullptr) {
         a_console->insertPlainText(s);
         a_console->moveCursor(QTextCursor::End);
     }
 }
 
 /*!
- * \brief Xyce::nextSimulation Execute the next simulation from queue.
+ * \brief Xyce::reportProgress Emit the progress of all simulations together.
+ */
+void Xyce::reportProgress()
+{
+    if (a_jobsTotal == 0) return;
+    int percent = 100*a_jobsDone;
+    for (const Job &job : a_jobs) {
+        percent += job.progress;
+    }
+    emit progress(percent/a_jobsTotal);
+}
+
+/*!
+ * \brief Xyce::maxJobs Number of simulator processes that may run at the same
+ *        time. The netlists of the queue are independent from each other.
+ * \return NProcs processes, or a single one if Xyce runs under MPI, which
+ *         already occupies NProcs processors.
+ */
+int Xyce::maxJobs() const
+{
+    if (a_MPI) return 1;
+    return qMax(1, int(QucsSettings.NProcs));
+}
+
+int Xyce::findJob(QObject *process) const
+{
+    for (int i = 0; i < a_jobs.count(); i++) {
+        if (a_jobs.at(i).process == process) return i;
+    }
+    return -1;
+}
+
+/*!
+ * \brief Xyce::startJob Start a simulator process for a netlist from queue.
+ */
+void Xyce::startJob(const QString &netlist)
+{
+    QProcess *process = new QProcess(this);
+    process->setProcessChannelMode(QProcess::MergedChannels);
+    process->setWorkingDirectory(a_workdir);
+    connect(process,SIGNAL(finished(int)),this,SLOT(slotFinished()));
+    connect(process,SIGNAL(readyRead()),this,SLOT(slotProcessOutput()));
+    connect(process,SIGNAL(errorOccurred(QProcess::ProcessError)),this,SLOT(slotJobError(QProcess::ProcessError)));
+    a_jobs.append(Job{process, netlist, QString(), 0});
+
+    QString cmd = QStringLiteral("%1 %2 \"%3\"").arg(a_simulator_cmd,a_simulator_parameters,netlist);
+    QStringList cmd_args = misc::parseCmdArgs(cmd);
+    QString xyce_cmd = cmd_args.at(0);
+    cmd_args.removeAt(0);
+    process->start(xyce_cmd,cmd_args);
+}
+
+/*!
+ * \brief Xyce::nextSimulation Execute the next simulations from queue, as
+ *        many as may run at the same time.
  */
 void Xyce::nextSimulation()
 {
-    if (!a_netlistQueue.isEmpty()) {
-        QString file = a_netlistQueue.takeFirst();
-        if (file.endsWith(".noise.cir")) a_Noisesim = true;
-        a_simProcess->setWorkingDirectory(a_workdir);
-        QString cmd = QStringLiteral("%1 %2 \"%3\"").arg(a_simulator_cmd,a_simulator_parameters,file);
-        QStringList cmd_args = misc::parseCmdArgs(cmd);
-        QString xyce_cmd = cmd_args.at(0);
-        cmd_args.removeAt(0);
-        a_simProcess->start(xyce_cmd,cmd_args);
-    } else {
+    if (a_jobsTotal == 0) {
         a_output += "No simulation found. Please add at least one simulation!\n"
                   "Navigate to the \"simulations\" group in the components panel (left)"
                   " and drag simulation to the schematic sheet. Then define its parameters.\n"
                   "Exiting...\n";
         emit progress(100);
         emit finished(); // nothing to simulate
+        return;
+    }
+    while (!a_netlistQueue.isEmpty() && a_jobs.count() < maxJobs()) {
+        startJob(a_netlistQueue.takeFirst());
+    }
+    if (a_jobs.isEmpty()) { // all simulations done, outputs can be merged now
+        emit finished();
+        emit progress(100);
     }
 }
 
 void Xyce::setParallel(bool par)
 {
+    a_MPI = par;
     if (par) {
         QString xyce_par = QucsSettings.XyceParExecutable;
         xyce_par.replace("%p",QString::number(QucsSettings.NProcs));
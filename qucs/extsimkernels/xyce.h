@@ -37,20 +37,39 @@ class Xyce : public AbstractSpiceKernel
     Q_OBJECT
 
 private:
-    bool a_Noisesim;
+    /*!
+     * \brief One Xyce process of the simulation queue. Every analysis is
+     *        simulated by a separate process with its own output.
+     */
+    struct Job {
+        QProcess *process;
+        QString netlist;
+        QString output;   // stdout of this process only
+        int progress;     // percent
+    };
+
+    bool a_MPI;           // Xyce itself runs on NProcs processors, see setParallel()
 
     QStringList a_simulationsQueue;
     QStringList a_netlistQueue;
+    QList<Job> a_jobs;    // running processes
+    int a_jobsTotal;
+    int a_jobsDone;
 
+    int maxJobs() const;
+    int findJob(QObject *process) const;
+    void startJob(const QString &netlist);
     void nextSimulation();
+    void reportProgress();
 
 public:
     void determineUsedSimulations(QStringList *sim_lst = NULL);
     explicit Xyce(Schematic* schematic, QObject *parent = 0);
+    ~Xyce();
 
     void SaveNetlist(QString filename, bool netlist2Console);
     void setParallel(bool par);
-    bool waitEndOfSimulation();
+    bool waitEndOfSimulation(int msecs = 10000);
 
 protected:
     void createNetlist(
@@ -62,9 +81,11 @@ protected:
 protected slots:
     void slotFinished();
     void slotProcessOutput();
+    void slotJobError(QProcess::ProcessError err);
 
 public slots:
     void slotSimulate();
+    void killThemAll();
 
 };
 
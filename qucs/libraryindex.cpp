@@ -0,0 +1,169 @@
+/***************************************************************************
+                              libraryindex.cpp
+                             ------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include "libraryindex.h"
+#include "main.h"
+#include "qucslib_common.h"
+
+static constexpr quint32 IndexMagic = 0x514c4958;   // "QLIX"
+static constexpr quint32 IndexVersion = 1;
+
+static QString indexFileName()
+{
+  return QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+         + "/libtree.index";
+}
+
+static QString indexKey(const QString& libPath, bool relpath)
+{
+  return libPath + (relpath ? "|rel" : "|abs");
+}
+
+QDataStream& operator<<(QDataStream& s, const LibraryIndex::Library& l)
+{
+  return s << l.Modified << l.Size << l.Result << l.Name << l.Components;
+}
+
+QDataStream& operator>>(QDataStream& s, LibraryIndex::Library& l)
+{
+  return s >> l.Modified >> l.Size >> l.Result >> l.Name >> l.Components;
+}
+
+// ---------------------------------------------------------------------
+// Parses the library "libPath" (without extension) like the library
+// tree shows it.
+LibraryIndex::Library LibraryIndex::parse(const QString& libPath, bool relpath)
+{
+  Library lib;
+  QFileInfo Info(getLibAbsPath(libPath));
+  lib.Modified = Info.lastModified();
+  lib.Size = Info.size();
+
+  ComponentLibrary parsedlibrary;
+  lib.Result = parseComponentLibrary (libPath, parsedlibrary, QUCS_COMP_LIB_FULL, relpath);
+  lib.Name = parsedlibrary.name;
+
+  for (const ComponentLibraryItem& comp : parsedlibrary.components)
+  {
+    QStringList compNameAndDefinition;
+
+    compNameAndDefinition.append (comp.name);
+
+    QString s = "<Qucs Schematic " PACKAGE_VERSION ">\n";
+
+    s +=  "<Components>\n  " +
+          comp.modelString + "\n" +
+          "</Components>\n";
+
+    compNameAndDefinition.append (s);
+    compNameAndDefinition.append(comp.definition);
+    compNameAndDefinition.append(libPath);
+    lib.Components.append(compNameAndDefinition);
+  }
+  return lib;
+}
+
+// ---------------------------------------------------------------------
+// Returns the name of a library from its header only, the name of the
+// file for SPICE libraries.
+QString LibraryIndex::headerName(const QString& libPath)
+{
+  QString filename = getLibAbsPath(libPath);
+  QFile file(filename);
+  if(file.open(QIODevice::ReadOnly)) {
+    QString Header = QString::fromUtf8(file.read(1024));
+    int Start = Header.indexOf("<Qucs Library ");
+    int End = Header.indexOf('>', Start);
+    if(Start >= 0 && End >= 0)
+      return Header.mid(Start, End-Start).section('"', 1, 1);
+  }
+  return QFileInfo(filename).baseName();
+}
+
+// ---------------------------------------------------------------------
+// Looks up a library that did not change since it was parsed.
+bool LibraryIndex::find(const QString& libPath, bool relpath, Library& lib)
+{
+  load();
+  auto it = Libraries.constFind(indexKey(libPath, relpath));
+  if(it == Libraries.constEnd()) return false;
+  QFileInfo Info(getLibAbsPath(libPath));
+  if(Info.lastModified() != it->Modified || Info.size() != it->Size)
+    return false;
+  lib = *it;
+  return true;
+}
+
+void LibraryIndex::insert(const QString& libPath, bool relpath, const Library& lib)
+{
+  load();
+  Libraries.insert(indexKey(libPath, relpath), lib);
+  Changed = true;
+}
+
+// ---------------------------------------------------------------------
+// The index of an other Qucs-S version is not used, the schematic text
+// of the components contains the version.
+void LibraryIndex::load()
+{
+  if(Loaded) return;
+  Loaded = true;
+
+  QFile file(indexFileName());
+  if(!file.open(QIODevice::ReadOnly)) return;
+  QDataStream stream(&file);
+  quint32 Magic, Version;
+  QString Package;
+  stream >> Magic >> Version >> Package;
+  if(Magic != IndexMagic || Version != IndexVersion || Package != PACKAGE_VERSION)
+    return;
+  stream >> Libraries;
+  if(stream.status() != QDataStream::Ok)
+    Libraries.clear();
+}
+
+// ---------------------------------------------------------------------
+// Writes the index if libraries were parsed. Libraries that no longer
+// exist are dropped.
+void LibraryIndex::save()
+{
+  if(!Changed) return;
+  Changed = false;
+
+  for(auto it = Libraries.begin(); it != Libraries.end(); ) {
+    QString libPath = it.key().section('|', 0, -2);
+    if(QFileInfo::exists(getLibAbsPath(libPath))) ++it;
+    else it = Libraries.erase(it);
+  }
+
+  QDir().mkpath(QFileInfo(indexFileName()).path());
+  QSaveFile file(indexFileName());
+  if(!file.open(QIODevice::WriteOnly)) return;
+  QDataStream stream(&file);
+  stream << IndexMagic << IndexVersion << QString(PACKAGE_VERSION) << Libraries;
+  file.commit();
+}
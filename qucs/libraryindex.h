@@ -0,0 +1,60 @@
+/***************************************************************************
+                               libraryindex.h
+                              ----------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef LIBRARYINDEX_H
+#define LIBRARYINDEX_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/*!
+ * \file libraryindex.h
+ * \brief Index of the component libraries shown in the library tree.
+ *
+ * Parsing all libraries is slow, so the parsed libraries are kept in
+ * an index that is saved in the cache directory. A library is only
+ * parsed again when its file changed.
+ */
+class LibraryIndex {
+public:
+  struct Library {
+    QDateTime Modified;
+    qint64 Size = -1;
+    int Result = 0;     // LIB_PARSE_RESULT
+    QString Name;
+    // columns of the library tree items: name, schematic, definition, library
+    QList<QStringList> Components;
+  };
+
+  // can be called from any thread
+  static Library parse(const QString& libPath, bool relpath);
+  static QString headerName(const QString& libPath);
+
+  bool find(const QString& libPath, bool relpath, Library&);
+  void insert(const QString& libPath, bool relpath, const Library&);
+  void save();
+
+private:
+  void load();
+
+  QHash<QString, Library> Libraries;
+  bool Loaded = false;
+  bool Changed = false;
+};
+
+#endif
@@ -40,6 +40,8 @@
 #include <QCommandLineParser>
 #include <QTextStream>
 #include <QScopedPointer>
+#include <QJsonDocument>
+#include <QThread>
 
 #include "qucs.h"
 #include "main.h"
@@ -50,6 +52,8 @@
 #include "settings.h"
 #include "module.h"
 #include "misc.h"
+#include "batchrunner.h"
+#include "simservice.h"
 
 
 #include "extsimkernels/ngspice.h"
@@ -88,6 +92,7 @@ bool loadSettings()
     QucsSettings.textFont.fromString(_settings::Get().item<QString>("textFont"));
     QucsSettings.largeFontSize = _settings::Get().item<double>("LargeFontSize");
     QucsSettings.maxUndo = _settings::Get().item<int>("maxUndo");
+    QucsSettings.DataSetCacheSize = _settings::Get().item<int>("DataSetCacheSize");
     QucsSettings.NodeWiring = _settings::Get().item<int>("NodeWiring");
     QucsSettings.BGColor = _settings::Get().item<QString>("BGColor");
     QucsSettings.Editor = _settings::Get().item<QString>("Editor");
@@ -192,6 +197,7 @@ bool saveApplSettings()
     // store LargeFontSize as a string, so it will be also human-readable in the settings file (will be a @Variant() otherwise)
     qs.setItem<QString>("LargeFontSize", QString::number(QucsSettings.largeFontSize));
     qs.setItem<unsigned int>("maxUndo", QucsSettings.maxUndo);
+    qs.setItem<unsigned int>("DataSetCacheSize", QucsSettings.DataSetCacheSize);
     qs.setItem<unsigned int>("NodeWiring", QucsSettings.NodeWiring);
     qs.setItem<QString>("BGColor", QucsSettings.BGColor.name());
     qs.setItem<QString>("Editor", QucsSettings.Editor);
@@ -307,6 +313,38 @@ Schematic* openSchematic(const QString& schematicFileName)
     return schematic;
 }
 
+bool writeQucsatorNetlist(Schematic *schematic, QTextStream &netlistStream)
+{
+    QPlainTextEdit errText;  // dummy
+    QStringList Collect;  // clear list for NodeSets, SPICE components etc.
+    int SimPorts = schematic->prepareNetlist(netlistStream, Collect, &errText);
+
+    if (SimPorts < -5)
+    {
+        /// \todo better handling for error/warnings
+        qCritical() << errText.toPlainText();
+        return false;
+    }
+
+    // output NodeSets, SPICE simulations etc.
+    for (QStringList::Iterator it = Collect.begin(); it != Collect.end(); ++it)
+    {
+        // don't put library includes into netlist...
+        if ((*it).right(4) != ".lst" &&
+            (*it).right(5) != ".vhdl" &&
+            (*it).right(4) != ".vhd" &&
+            (*it).right(2) != ".v")
+        {
+            netlistStream << *it << '\n';
+        }
+    }
+
+    netlistStream << '\n';
+
+    schematic->createNetlist(netlistStream, SimPorts);
+    return true;
+}
+
 int doNetlist(QString schematicFileName, QString netlistFileName, bool netlist2Console)
 {
     QucsSettings.DefaultSimulator = spicecompat::simQucsator;
@@ -344,36 +382,13 @@ int doNetlist(QString schematicFileName, QString netlistFileName, bool netlist2C
         netlistStream.reset(new QTextStream(netlistString.get()));
     }
 
-    QPlainTextEdit errText;  // dummy
-    QStringList Collect;  // clear list for NodeSets, SPICE components etc.
-    int SimPorts = schematic->prepareNetlist(*netlistStream, Collect, &errText);
-
-    if (SimPorts < -5)
+    if (!writeQucsatorNetlist(schematic.get(), *netlistStream))
     {
         QByteArray ba = netlistFileName.toLatin1();
         fprintf(stderr, "Error: Could not prepare netlist %s\n", ba.data());
-        /// \todo better handling for error/warnings
-        qCritical() << errText.toPlainText();
         return 1;
     }
 
-    // output NodeSets, SPICE simulations etc.
-    for (QStringList::Iterator it = Collect.begin(); it != Collect.end(); ++it)
-    {
-        // don't put library includes into netlist...
-        if ((*it).right(4) != ".lst" &&
-            (*it).right(5) != ".vhdl" &&
-            (*it).right(4) != ".vhd" &&
-            (*it).right(2) != ".v")
-        {
-            *netlistStream << *it << '\n';
-        }
-    }
-
-    *netlistStream << '\n';
-
-    schematic->createNetlist(*netlistStream, SimPorts);
-
     if (netlist2Console)
     {
         std::cout << std::endl << netlistString->toLatin1().constData() << std::endl;
@@ -382,7 +397,7 @@ int doNetlist(QString schematicFileName, QString netlistFileName, bool netlist2C
     return 0;
 }
 
-int runNgspice(QString schematicFileName, QString dataset)
+int runNgspice(QString schematicFileName, QString dataset, bool force)
 {
     QucsSettings.DefaultSimulator = spicecompat::simNgspice;
     Module::registerModules();
@@ -394,6 +409,7 @@ int runNgspice(QString schematicFileName, QString dataset)
     }
 
     QScopedPointer<Ngspice> ngspice(new Ngspice(schematic.get()));
+    ngspice->setUseResultCache(!force);
     ngspice->slotSimulate();
     bool ok = ngspice->waitEndOfSimulation();
     if (!ok)
@@ -409,7 +425,7 @@ int runNgspice(QString schematicFileName, QString dataset)
     return 0;
 }
 
-int runXyce(QString schematicFileName, QString dataset)
+int runXyce(QString schematicFileName, QString dataset, bool force)
 {
     QucsSettings.DefaultSimulator = spicecompat::simXyce;
     Module::registerModules();
@@ -421,6 +437,7 @@ int runXyce(QString schematicFileName, QString dataset)
     }
 
     QScopedPointer<Xyce> xyce(new Xyce(schematic.get()));
+    xyce->setUseResultCache(!force);
     xyce->slotSimulate();
     bool ok = xyce->waitEndOfSimulation();
     if (!ok)
@@ -554,6 +571,52 @@ int doXyceNetlist(QString schematicFileName, QString netlistFileName, bool netli
     return 0;
 }
 
+int doBatch(QString spec, QString outputDir, bool ngspice, bool xyce, bool run,
+            bool force, int jobs, QString summaryFileName)
+{
+    QString error;
+    QStringList schematics = BatchRunner::expandInputs(spec, error);
+    if (schematics.isEmpty())
+    {
+        fprintf(stderr, "Error: %s\n", error.toLocal8Bit().constData());
+        return -1;
+    }
+
+    int simulator = spicecompat::simQucsator;
+    if (ngspice)
+    {
+        simulator = spicecompat::simNgspice;
+    }
+    else if (xyce)
+    {
+        simulator = spicecompat::simXyce;
+    }
+
+    BatchRunner runner(simulator, run);
+    runner.setOutputDir(outputDir);
+    runner.setJobs(jobs);
+    runner.setForce(force);
+    int failed = runner.run(schematics);
+
+    QByteArray summary = QJsonDocument(runner.summary()).toJson();
+    if (summaryFileName.isEmpty())
+    {
+        std::cout << summary.constData();
+    }
+    else
+    {
+        QFile file(summaryFileName);
+        if (!file.open(QIODevice::WriteOnly))
+        {
+            fprintf(stderr, "Error: Could not write summary %s\n", summaryFileName.toLocal8Bit().constData());
+            return -1;
+        }
+        file.write(summary);
+    }
+
+    return failed == 0 ? 0 : 1;
+}
+
 int doPrint(QString schematicFileName, QString printFile,
     QString page, int dpi, QString color, QString orientation)
 {
@@ -882,6 +945,7 @@ int main(int argc, char *argv[])
     //QucsSettings.font = QFont("Helvetica", 12);
     QucsSettings.largeFontSize = 16.0;
     QucsSettings.maxUndo = 20;
+    QucsSettings.DataSetCacheSize = 512;
     QucsSettings.NodeWiring = 0;
 
     // initially center the application
@@ -1065,6 +1129,12 @@ int main(int argc, char *argv[])
         {"cdl", QCoreApplication::translate("main", "create CDL netlist")},
         {"xyce", QCoreApplication::translate("main", "Xyce netlist")},
         {"run", QCoreApplication::translate("main", "execute Ngspice/Xyce immediately")},
+        {"force", QCoreApplication::translate("main", "simulate again even if a cached result exists")},
+        {"batch", QCoreApplication::translate("main", "process many schematics, given as list file or wildcard pattern; -o is the output directory"), "LIST|PATTERN"},
+        {"jobs", QCoreApplication::translate("main", "number of simulations run at once in batch mode (default: number of CPUs)"), "NUMBER"},
+        {"summary", QCoreApplication::translate("main", "write the JSON summary of the batch run to file (default: console)"), "FILENAME"},
+        {"serve", QCoreApplication::translate("main", "run as headless service, reading JSON requests line by line from stdin")},
+        {"socket", QCoreApplication::translate("main", "with --serve, read the requests from the local socket NAME instead"), "NAME"},
         {"icons", QCoreApplication::translate("main", "create component icons under ./bitmaps_generated")},
         {"doc", QCoreApplication::translate(
                 "main",
@@ -1094,9 +1164,11 @@ int main(int argc, char *argv[])
                 helpText.indexOf('\n', 0)+1,
                 QString::fromUtf8(
                     "       qucs -n -i FILENAME -o FILENAME\n"
-                    "       qucs -p -i FILENAME -o FILENAME.[pdf|png|svg|eps]\n"));
+                    "       qucs -p -i FILENAME -o FILENAME.[pdf|png|svg|eps]\n"
+                    "       qucs -n --batch LIST|PATTERN [--ngspice|--xyce [--run]] -o DIR\n"
+                    "       qucs --serve [--socket NAME]\n"));
 
-        QRegularExpression optIndent(QString::fromUtf8("--page|--dpi|--color|--orin|--ngspice|--xyce|--run|--cdl"));
+        QRegularExpression optIndent(QString::fromUtf8("--page|--dpi|--color|--orin|--ngspice|--xyce|--run|--force|--cdl|--jobs|--summary|--socket"));
         int idx;
         int from = 0;
         while ((idx = helpText.indexOf(optIndent, from)) != -1)
@@ -1121,8 +1193,10 @@ int main(int argc, char *argv[])
     const bool cdl_flag(parser.isSet("cdl"));
     const bool xyce_flag(parser.isSet("xyce"));
     const bool run_flag(parser.isSet("run"));
+    const bool force_flag(parser.isSet("force"));
     const bool netlist2Console(parser.isSet("netlist2Console"));
     const bool spiceprefix(parser.isSet("spiceprefix"));
+    const QString batch(parser.value("batch"));
 
 #if 0
     std::cout << "Current cli values:" << std::endl;
@@ -1165,6 +1239,20 @@ int main(int argc, char *argv[])
         return 0;
     }
 
+    if (parser.isSet("serve"))
+    {
+        SimService service;
+        if (!parser.isSet("socket"))
+        {
+            return service.serveStdin();
+        }
+        if (!service.listen(parser.value("socket")))
+        {
+            return -1;
+        }
+        return app.exec();
+    }
+
     // check operation and its required arguments
     if (netlist_flag and print_flag)
     {
@@ -1181,6 +1269,22 @@ int main(int argc, char *argv[])
         fprintf(stderr, "Error: --print and Ngspice/CDL/Xyce cannot be used together\n");
         return -1;
     }
+    else if (!batch.isEmpty())
+    {
+        if (!netlist_flag || cdl_flag || netlist2Console)
+        {
+            fprintf(stderr, "Error: --batch needs --netlist, without --cdl and --netlist2Console\n");
+            return -1;
+        }
+        if (run_flag && !ngspice_flag && !xyce_flag)
+        {
+            fprintf(stderr, "Error: --run needs --ngspice or --xyce\n");
+            return -1;
+        }
+        int jobs = parser.isSet("jobs") ? parser.value("jobs").toInt() : QThread::idealThreadCount();
+        return doBatch(batch, outputfile, ngspice_flag, xyce_flag, run_flag, force_flag,
+                       jobs, parser.value("summary"));
+    }
     else if (netlist_flag or print_flag)
     {
         if (inputfile.isEmpty())
@@ -1219,11 +1323,11 @@ int main(int argc, char *argv[])
             {
                 if (ngspice_flag)
                 {
-                    return runNgspice(inputfile, outputfile);
+                    return runNgspice(inputfile, outputfile, force_flag);
                 }
                 else if (xyce_flag)
                 {
-                    return runXyce(inputfile, outputfile);
+                    return runXyce(inputfile, outputfile, force_flag);
                 }
                 else
                 {
@@ -30,6 +30,8 @@
 
 class QucsApp;
 class Component;
+class Schematic;
+class QTextStream;
 class VersionTriplet;
 
 static const double pi = 3.1415926535897932384626433832795029;  /* pi   */
@@ -50,6 +52,7 @@ struct tQucsSettings {
     Attribute, Directive, Task;
 
   unsigned int maxUndo;    // size of undo stack
+  unsigned int DataSetCacheSize;  // memory budget of parsed datasets (MB)
   QString Editor;
   QString Qucsator;
   QString QucsatorDir;
@@ -121,4 +124,8 @@ bool loadSettings();
 bool saveApplSettings();
 void qucsMessageOutput(QtMsgType type, const char *msg);
 
+// command line operations, also used by the batch mode
+Schematic* openSchematic(const QString& schematicFileName);
+bool writeQucsatorNetlist(Schematic *schematic, QTextStream &netlistStream);
+
 #endif // ifndef QUCS_MAIN_H
@@ -140,7 +140,7 @@ void MouseActions::editLabel(Schematic *Doc, WireLabel *pl)
     delete Dia;
 
     if (Name.isEmpty() && Value.isEmpty()) { // if nothing entered, delete label
-        pl->pOwner->Label = 0;               // delete name of wire
+        pl->pOwner->setLabel(0);  // delete name of wire
         delete pl;
     } else {
         if (Result == 1)
@@ -847,7 +847,7 @@ void MouseActions::MPressLabel(Schematic *Doc, QMouseEvent *, float fX, float fY
         if (pe) {
             if (((Conductor *) pe)->Label)
                 delete ((Conductor *) pe)->Label; // delete old name
-            ((Conductor *) pe)->Label = 0;
+            ((Conductor *) pe)->setLabel(0);
         } else {
             if (pw)
                 pw->setName("", ""); // delete name of wire
@@ -857,7 +857,7 @@ void MouseActions::MPressLabel(Schematic *Doc, QMouseEvent *, float fX, float fY
     } else {
         if (pe) {
             delete ((Conductor *) pe)->Label; // delete old name
-            ((Conductor *) pe)->Label = nullptr;
+            ((Conductor *) pe)->setLabel(nullptr);
         }
 
         int xl = x + 30;
@@ -1695,6 +1695,7 @@ void MouseActions::MReleaseMoveText(Schematic *Doc, QMouseEvent *Event)
 
     ((Component *) focusElement)->tx = MAx1 - ((Component *) focusElement)->cx;
     ((Component *) focusElement)->ty = MAy1 - ((Component *) focusElement)->cy;
+    focusElement->markChanged();
     Doc->viewport()->update();
     Doc->setChanged(true, true);
 }
@@ -1785,6 +1786,7 @@ void MouseActions::editElement(Schematic *Doc, QMouseEvent *Event)
             Doc->a_Components->push_back(c);
         }
 
+        c->markChanged();  // whatever the dialog changed
         Doc->setChanged(true, true);
         Doc->enlargeView(c);
         break;
@@ -73,6 +73,7 @@ bool Node::getSelected(int x, int y)
 
 void Node::setName(const QString& name, const QString& value, int x, int y)
 {
+  markChanged();  // the label is part of the node's area
   if (name.isEmpty() && value.isEmpty()) {
     if (Label) {
       delete Label;
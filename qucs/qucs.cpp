@@ -43,6 +43,7 @@
 #include <QSettings>
 #include <QVariant>
 #include <QDebug>
+#include <QtConcurrent>
 
 #include "main.h"
 #include "qucs.h"
@@ -88,7 +89,8 @@
 #include "extsimkernels/CdlSettingsDialog.h"
 
 QucsApp::QucsApp(bool netlist2Console) :
-  a_netlist2Console(netlist2Console)
+  a_netlist2Console(netlist2Console),
+  a_libWorkerCancel(false)
 {
   windowTitle = misc::getWindowTitle();
   setWindowTitle(windowTitle);
@@ -263,6 +265,8 @@ QucsApp::QucsApp(bool netlist2Console) :
 
 QucsApp::~QucsApp()
 {
+  a_libWorkerCancel = true;
+  a_libWorker.waitForFinished();
   Module::unregisterModules ();
 }
 
@@ -546,6 +550,8 @@ void QucsApp::initView()
 
   connect(libTreeWidget, SIGNAL(itemPressed (QTreeWidgetItem*, int)),
            SLOT(slotSelectLibComponent (QTreeWidgetItem*)));
+  connect(libTreeWidget, SIGNAL(itemExpanded (QTreeWidgetItem*)),
+           SLOT(slotExpandLibrary (QTreeWidgetItem*)));
 
   // ----------------------------------------------------------
   // put the tab widget in the dock
@@ -605,6 +611,7 @@ void QucsApp::fillLibrariesTreeView ()
 {
     QList<QTreeWidgetItem *> topitems;
 
+    a_pendingLibs.clear();
     libTreeWidget->clear();
 
     // make the system libraries section header
@@ -638,9 +645,12 @@ void QucsApp::fillLibrariesTreeView ()
     }
 
     libTreeWidget->insertTopLevelItems(0, topitems);
+    parsePendingLibraries();
 }
 
 
+// Libraries found in the index are filled right away, the others are
+// parsed in the background or when they are expanded.
 bool QucsApp::populateLibTreeFromDir(const QString &LibDirPath, QList<QTreeWidgetItem *> &topitems, bool relpath)
 {
     QDir LibDir(LibDirPath);
@@ -655,56 +665,127 @@ bool QucsApp::populateLibTreeFromDir(const QString &LibDirPath, QList<QTreeWidge
         QString libPath(LibDir.absoluteFilePath(*it));
         libPath.chop(4); // remove extension
 
-        ComponentLibrary parsedlibrary;
-
-        int result = parseComponentLibrary (libPath , parsedlibrary, QUCS_COMP_LIB_FULL, relpath);
+        LibraryIndex::Library parsedlibrary;
+        bool indexed = a_libIndex.find(libPath, relpath, parsedlibrary);
         QStringList nameAndFileName;
-        nameAndFileName.append (parsedlibrary.name);
+        nameAndFileName.append (indexed ? parsedlibrary.Name : LibraryIndex::headerName(libPath));
         nameAndFileName.append (LibDirPath + *it);
 
         QTreeWidgetItem* newlibitem = new QTreeWidgetItem((QTreeWidget*)nullptr, nameAndFileName);
+        newlibitem->setData(0, Qt::UserRole, libPath);
+        newlibitem->setData(0, Qt::UserRole+1, relpath);
 
-        switch (result)
-        {
-            case QUCS_COMP_LIB_IO_ERROR:
-            {
-                QString filename = getLibAbsPath(libPath);
-                QMessageBox::critical(nullptr, tr ("Error"), tr("Cannot open \"%1\".").arg (filename));
-                return false;
+        if (indexed) {
+            for (const QStringList& compNameAndDefinition : parsedlibrary.Components) {
+                QTreeWidgetItem* newcompitem = new QTreeWidgetItem(newlibitem, compNameAndDefinition);
+
+                // Silence warning from the compiler about unused variable newcompitem
+                // we pass the pointer to the parent item in the constructor
+                Q_UNUSED( newcompitem )
             }
-            case QUCS_COMP_LIB_CORRUPT:
-                QMessageBox::critical(nullptr, tr("Error"), tr("Library is corrupt."));
-                return false;
-            default:
-                break;
+        } else if (libraryFailed(libPath)) {
+            // not parsed again, expanding it shows the error once
+            newlibitem->setChildIndicatorPolicy(a_failedLibs.value(libPath).Reported
+                ? QTreeWidgetItem::DontShowIndicator : QTreeWidgetItem::ShowIndicator);
+        } else {
+            newlibitem->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+            a_pendingLibs.insert(libPath, newlibitem);
         }
 
-        for (int i = 0; i < parsedlibrary.components.count (); i++)
-        {
-            QStringList compNameAndDefinition;
+        topitems.append (newlibitem);
+    }
+    return true;
+}
 
-            compNameAndDefinition.append (parsedlibrary.components[i].name);
+// Parses the libraries that are not yet in the tree in a worker thread.
+void QucsApp::parsePendingLibraries()
+{
+    a_libWorkerCancel = true;
+    a_libWorker.waitForFinished();
+    a_libWorkerCancel = false;
+    if (a_pendingLibs.isEmpty()) return;
 
-            QString s = "<Qucs Schematic " PACKAGE_VERSION ">\n";
+    QList<QPair<QString, bool>> libs;
+    for (QTreeWidgetItem* item : std::as_const(a_pendingLibs))
+        libs.append({item->data(0, Qt::UserRole).toString(), item->data(0, Qt::UserRole+1).toBool()});
 
-            s +=  "<Components>\n  " +
-                  parsedlibrary.components[i].modelString + "\n" +
-                  "</Components>\n";
+    a_libWorker = QtConcurrent::run([this, libs] {
+        for (const auto& lib : libs) {
+            if (a_libWorkerCancel) break;
+            LibraryIndex::Library parsed = LibraryIndex::parse(lib.first, lib.second);
+            QMetaObject::invokeMethod(this, [this, lib, parsed] {
+                libraryParsed(lib.first, lib.second, parsed);
+            }, Qt::QueuedConnection);
+        }
+        QMetaObject::invokeMethod(this, [this] { a_libIndex.save(); }, Qt::QueuedConnection);
+    });
+}
 
-            compNameAndDefinition.append (s);
-            compNameAndDefinition.append(parsedlibrary.components[i].definition);
-            compNameAndDefinition.append(libPath);
+// Fills a library item whose library has not been parsed yet.
+void QucsApp::populateLibrary(QTreeWidgetItem *libitem)
+{
+    QString libPath = libitem->data(0, Qt::UserRole).toString();
+    if (!a_pendingLibs.contains(libPath)) return;
 
-            QTreeWidgetItem* newcompitem = new QTreeWidgetItem(newlibitem, compNameAndDefinition);
+    bool relpath = libitem->data(0, Qt::UserRole+1).toBool();
+    libraryParsed(libPath, relpath, LibraryIndex::parse(libPath, relpath));
+}
 
-            // Silence warning from the compiler about unused variable newcompitem
-            // we pass the pointer to the parent item in the constructor
-            Q_UNUSED( newcompitem )
-        }
+// Returns true if the library could not be parsed and has not been
+// modified since.
+bool QucsApp::libraryFailed(const QString &libPath)
+{
+    auto it = a_failedLibs.find(libPath);
+    if (it == a_failedLibs.end()) return false;
+    QFileInfo Info(getLibAbsPath(libPath));
+    if (Info.lastModified() == it->Parsed.Modified && Info.size() == it->Parsed.Size)
+        return true;
+    a_failedLibs.erase(it);
+    return false;
+}
 
-        topitems.append (newlibitem);
+void QucsApp::libraryParsed(const QString &libPath, bool relpath, const LibraryIndex::Library &lib)
+{
+    if (lib.Result == QUCS_COMP_LIB_IO_ERROR || lib.Result == QUCS_COMP_LIB_CORRUPT) {
+        // reported when the library is expanded, results of a parse
+        // started before do not report it again
+        if (a_pendingLibs.remove(libPath))
+            a_failedLibs.insert(libPath, FailedLibrary{lib});
+        return;
     }
-    return true;
+    a_libIndex.insert(libPath, relpath, lib);
+
+    QTreeWidgetItem* libitem = a_pendingLibs.take(libPath);
+    if (libitem == nullptr) return;
+    libitem->setText(0, lib.Name);
+    libitem->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicatorWhenChildless);
+    for (const QStringList& compNameAndDefinition : lib.Components)
+        new QTreeWidgetItem(libitem, compNameAndDefinition);
+}
+
+void QucsApp::slotExpandLibrary(QTreeWidgetItem *item)
+{
+    if (item->parent() != nullptr) return;
+
+    QString libPath = item->data(0, Qt::UserRole).toString();
+    if (a_pendingLibs.contains(libPath)) {
+        populateLibrary(item);
+        a_libIndex.save();
+    }
+
+    // a library that failed to parse is reported only once
+    auto failed = a_failedLibs.find(libPath);
+    if (failed == a_failedLibs.end() || failed->Reported) return;
+    failed->Reported = true;
+    const int Result = failed->Parsed.Result;
+    item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicator);
+
+    if (Result == QUCS_COMP_LIB_IO_ERROR) {
+        QString filename = getLibAbsPath(libPath);
+        QMessageBox::critical(nullptr, tr ("Error"), tr("Cannot open \"%1\".").arg (filename));
+    }
+    else
+        QMessageBox::critical(nullptr, tr("Error"), tr("Library is corrupt."));
 }
 
 // ---------------------------------------------------------------
@@ -2540,6 +2621,7 @@ void QucsApp::slotSimulate(QWidget *w)
   bool isDigital = false;
   if (!isTextDocument(w)) {
       Schematic* schematicPtr = (Schematic*)w;
+      schematicPtr->cancelGraphLoading();   // its data is outdated now
       isDigital = schematicPtr->isDigitalCircuit();
 
       if (isDigital && schematicPtr->getShowBias() == 0) {
@@ -2682,7 +2764,7 @@ void QucsApp::slotAfterSimulation(int Status, SimMessage *sim)
                 CompChoose->setCurrentIndex(idx);   // switch to diagrams
                 slotSetCompView (idx);
                 // load recent simulation data (if document is still open)
-                ((Schematic*)sim->DocWidget)->reloadGraphs();
+                ((Schematic*)sim->DocWidget)->reloadGraphsInBackground();
             }
         }
     }
@@ -2765,7 +2847,7 @@ void QucsApp::slotChangePage(const QString& DocName, const QString& DataDisplay)
 
   if(DocumentTab->currentWidget() == w)      // if page not ...
     if(!isTextDocument (w))
-      ((Schematic*)w)->reloadGraphs();  // ... changes, reload here !
+      ((Schematic*)w)->reloadGraphsInBackground();  // ... changes, reload here !
 
   TabView->setCurrentIndex(2);   // switch to "Component"-Tab
   if (Name.right(4) == ".dpl") {
@@ -3269,7 +3351,7 @@ void QucsApp::slot2PortMatching()
     return;
   }
 
-  double *Value = Data->Points;
+  const double *Value = Data->Points;
   // search for values for chosen frequency
   for(z=0; z<Data->count; z++)
     if(*(Value++) == Freq) break;
@@ -3540,6 +3622,7 @@ void QucsApp::slotSimulateWithSpice()
             slotFileSaveAs();
             schematic->setShowBias(biasState);
         }
+        schematic->cancelGraphLoading();   // its data is outdated now
         ExternSimDialog *SimDlg = new ExternSimDialog(schematic, false);
         connect(SimDlg, SIGNAL(simulated(ExternSimDialog*)), this, SLOT(slotAfterSpiceSimulation(ExternSimDialog*)));
         connect(SimDlg, SIGNAL(warnings()), this, SLOT(slotShowWarnings()));
@@ -3666,7 +3749,17 @@ void QucsApp::slotAfterSpiceSimulation(ExternSimDialog *SimDlg)
         SimDlg->show();
         return;
     }
-    if (SimDlg->wasSimulated()) {
+    showSpiceResults(sch, SimDlg->wasSimulated());
+    if (sch->getShowBias()>0 || QucsMain->TuningMode) SimDlg->close();
+}
+
+/*!
+ * \brief QucsApp::showSpiceResults Show the results of a SPICE simulation that
+ *        have been converted to the dataset of the schematic.
+ */
+void QucsApp::showSpiceResults(Schematic *sch, bool simulated)
+{
+    if (simulated) {
         if(sch->getSimOpenDpl()) {
             if (sch->getShowBias() < 1) {
                 if (!TuningMode) {
@@ -3684,8 +3777,7 @@ void QucsApp::slotAfterSpiceSimulation(ExternSimDialog *SimDlg)
         }
     }
 
-    sch->reloadGraphs();
-    sch->viewport()->update();
+    sch->reloadGraphsInBackground();
     if(sch->getSimRunScript()) {
       // run script
       octave->startOctave();
@@ -3694,7 +3786,6 @@ void QucsApp::slotAfterSpiceSimulation(ExternSimDialog *SimDlg)
     if (TuningMode) {
         tunerDia->SimulationEnded();
     }
-    if (sch->getShowBias()>0 || QucsMain->TuningMode) SimDlg->close();
 }
 
 void QucsApp::slotBuildVAModule()
@@ -3750,6 +3841,13 @@ void QucsApp::slotSearchLibComponent(const QString &comp)
         return;
     }
 
+    // all libraries are searched, those not parsed yet are parsed now
+    if (!a_pendingLibs.isEmpty()) {
+        for (QTreeWidgetItem* item : a_pendingLibs.values())
+            populateLibrary(item);
+        a_libIndex.save();
+    }
+
     QTreeWidgetItemIterator top_itm(libTreeWidget);
     while (*top_itm) {
         bool found = false;
@@ -24,11 +24,16 @@
 #include <QStack>
 #include <QFileSystemModel>
 #include <QSortFilterProxyModel>
+#include <QFuture>
+
+#include <atomic>
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
 
+#include "libraryindex.h"
+
 class QucsDoc;
 class Schematic;
 class SimMessage;
@@ -201,11 +206,14 @@ private slots:
   void slotShowModel();
   void slotSearchLibComponent(const QString &);
   void slotSearchLibClear();
+  void slotExpandLibrary(QTreeWidgetItem*);
 
 signals:
   void signalKillEmAll();
 
 public:
+  void showSpiceResults(Schematic *sch, bool simulated);
+
   MouseActions *view;
   QTabWidget *DocumentTab;
   QListWidget *CompComps;
@@ -257,6 +265,16 @@ private:
   int ccCurIdx; // CompChooser current index (used during search)
   bool a_netlist2Console;
 
+  LibraryIndex a_libIndex;  // parsed libraries, saved between sessions
+  QHash<QString, QTreeWidgetItem*> a_pendingLibs; // library path -> tree item not yet filled
+  struct FailedLibrary {
+    LibraryIndex::Library Parsed;
+    bool Reported = false;          // error shown, the item is not expandable any more
+  };
+  QHash<QString, FailedLibrary> a_failedLibs; // library path -> failed parse, until the file changes
+  QFuture<void> a_libWorker;        // parses the pending libraries
+  std::atomic<bool> a_libWorkerCancel;
+
 // ********** Methods ***************************************************
   void initView();
   void initCursorMenu();
@@ -283,6 +301,10 @@ private:
   void successExportMessages(bool ok);
   void fillLibrariesTreeView (void);
   bool populateLibTreeFromDir(const QString &LibDirPath, QList<QTreeWidgetItem *> &topitems, bool relpath = false);
+  void parsePendingLibraries();
+  void populateLibrary(QTreeWidgetItem *libitem);
+  bool libraryFailed(const QString &libPath);
+  void libraryParsed(const QString &libPath, bool relpath, const LibraryIndex::Library &lib);
   void saveSettings();
   QWidget *getSchematicWidget(QucsDoc *Doc);
 
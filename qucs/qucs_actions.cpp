@@ -1292,6 +1292,7 @@ void QucsApp::slotApplyCompText()
 
         if (is_unique) {
           component->Name = new_name;
+          component->markChanged();
           Doc->setChanged(true, true);  // only one undo state
         }
       }
@@ -1458,7 +1459,7 @@ void QucsApp::slotExportGraphAsCsv()
 
 
   int n, m;
-  double *py = g->cPointsY;
+  const double *py = g->cPointsY;
   int Count = g->countY * g->axis(0)->count;
   for(n = 0; n < Count; n++) {
     m = n;
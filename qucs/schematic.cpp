@@ -17,11 +17,13 @@
 
 #include <algorithm>
 #include <QString>
+#include <QtConcurrent>
 
 #include "components/vafile.h"
 #include "components/verilogfile.h"
 #include "components/vhdlfile.h"
 #include "diagrams/diagram.h"
+#include "diagrams/graphloader.h"
 #include "main.h"
 #include "mouseactions.h"
 #include "node.h"
@@ -82,14 +84,9 @@ Schematic::Schematic(QucsApp *App_, const QString &Name_) :
     a_tmpViewY1(-200),
     a_tmpViewX2(200),
     a_tmpViewY2(200),
-    a_undoActionIdx(0),
-    // The 'i' means state for being unchanged.
-    a_undoAction((QVector<QString*>() << new QString(" i\n</>\n</>\n</>\n</>\n"))),
-    a_undoSymbolIdx(0),
-    // The 'i' means state for being unchanged.
-    a_undoSymbol((QVector<QString*>() << new QString(" i\n</>\n</>\n</>\n</>\n"))),
     a_previousCursorPosition(),
     a_dragIsOkay(false),
+    a_graphLoader(new GraphLoader(this)),
     a_FileInfo(),
     a_Signals(),
     a_PortTypes(),
@@ -120,6 +117,8 @@ Schematic::Schematic(QucsApp *App_, const QString &Name_) :
         connect(this, SIGNAL(signalRedoState(bool)), App_, SLOT(slotUpdateRedo(bool)));
         connect(this, SIGNAL(signalFileChanged(bool)), App_, SLOT(slotFileChanged(bool)));
     }
+    connect(a_graphLoader, SIGNAL(diagramReady(Diagram*, const QString&)),
+            this, SLOT(slotGraphDataReady(Diagram*, const QString&)));
 }
 
 Schematic::~Schematic() {}
@@ -203,8 +202,8 @@ void Schematic::becomeCurrent(bool update)
             setChanged(true, true);
         }
 
-        emit signalUndoState(a_undoSymbolIdx != 0);
-        emit signalRedoState(a_undoSymbolIdx != a_undoSymbol.size() - 1);
+        emit signalUndoState(a_undoSymbol.canUndo());
+        emit signalRedoState(a_undoSymbol.canRedo());
     } else {
         a_Nodes = &a_DocNodes;
         a_Wires = &a_DocWires;
@@ -212,8 +211,8 @@ void Schematic::becomeCurrent(bool update)
         a_Paintings = &a_DocPaints;
         a_Components = &a_DocComps;
 
-        emit signalUndoState(a_undoActionIdx != 0);
-        emit signalRedoState(a_undoActionIdx != a_undoAction.size() - 1);
+        emit signalUndoState(a_undoAction.canUndo());
+        emit signalRedoState(a_undoAction.canRedo());
         if (update)
             reloadGraphs(); // load recent simulation data
     }
@@ -243,6 +242,7 @@ void Schematic::setChanged(bool c, bool fillStack, char Op)
     else if (a_DocChanged && (!c))
         emit signalFileChanged(false);
     a_DocChanged = c;
+    invalidateSpatialIndex();
 
     a_showBias = -1; // schematic changed => bias points may be invalid
 
@@ -251,53 +251,25 @@ void Schematic::setChanged(bool c, bool fillStack, char Op)
 
     // ................................................
     if (a_symbolMode) { // for symbol edit mode
-        while (a_undoSymbol.size() > a_undoSymbolIdx + 1) {
-            delete a_undoSymbol.last();
-            a_undoSymbol.pop_back();
-        }
-
-        a_undoSymbol.append(new QString(createSymbolUndoString(Op)));
-        a_undoSymbolIdx++;
+        a_undoSymbol.push(createSymbolUndoState(), Op);
 
         emit signalUndoState(true);
         emit signalRedoState(false);
 
-        while (static_cast<unsigned int>(a_undoSymbol.size())
-               > QucsSettings.maxUndo) { // "while..." because
-            delete a_undoSymbol.first();
-            a_undoSymbol.pop_front();
-            a_undoSymbolIdx--;
-        }
+        a_undoSymbol.limit(QucsSettings.maxUndo);
         return;
     }
 
     // ................................................
     // for schematic edit mode
-    while (a_undoAction.size() > a_undoActionIdx + 1) {
-        delete a_undoAction.last();
-        a_undoAction.pop_back();
-    }
-
-    if (Op == 'm') { // only one for move marker
-        if (a_undoAction.at(a_undoActionIdx)->at(0) == Op) {
-            delete a_undoAction.last();
-            a_undoAction.pop_back();
-            a_undoActionIdx--;
-        }
-    }
-
-    a_undoAction.append(new QString(createUndoString(Op)));
-    a_undoActionIdx++;
+    // only the changed elements are saved and stored
+    pushUndoState(Op);
 
     emit signalUndoState(true);
     emit signalRedoState(false);
 
-    while (static_cast<unsigned int>(a_undoAction.size())
-           > QucsSettings.maxUndo) { // "while..." because
-        delete a_undoAction.first();   // "maxUndo" could be decreased meanwhile
-        a_undoAction.pop_front();
-        a_undoActionIdx--;
-    }
+    // "maxUndo" could be decreased meanwhile
+    a_undoAction.limit(QucsSettings.maxUndo);
     return;
 }
 
@@ -423,7 +395,7 @@ void Schematic::paintFrame(QPainter* painter) {
 
 // -----------------------------------------------------------
 // Is called when the content (schematic or data display) has to be drawn.
-void Schematic::drawContents(QPainter *p, int, int, int, int)
+void Schematic::drawContents(QPainter *p, int clipx, int clipy, int clipw, int cliph)
 {
     QTransform trf{p->transform()};
     trf
@@ -444,7 +416,11 @@ void Schematic::drawContents(QPainter *p, int, int, int, int)
     if (!a_symbolMode)
         paintFrame(p);
 
-    drawElements(p);
+    // exposed area in schematic coordinates, with some room for pen widths
+    const QRect visible = QRectF{
+        clipx / a_Scale + a_ViewX1, clipy / a_Scale + a_ViewY1,
+        clipw / a_Scale, cliph / a_Scale}.toAlignedRect().adjusted(-10, -10, 10, 10);
+    drawElements(p, visible);
     if (a_showBias > 0) {
         drawDcBiasPoints(p);
     }
@@ -452,25 +428,32 @@ void Schematic::drawContents(QPainter *p, int, int, int, int)
     drawPostPaintEvents(p);
 }
 
-void Schematic::drawElements(QPainter* painter) {
-    for (auto* component : *a_Components) {
-        component->paint(painter);
+// Draws the elements within the visible area. Components, wires and nodes
+// are found through the spatial indices, which return them in list order.
+void Schematic::drawElements(QPainter* painter, const QRect& visible) {
+    ensureComponentIndex();
+    for (auto* e : a_compIndex.query(visible)) {
+        static_cast<Component*>(e)->paintCached(painter);
     }
 
-    for (auto* wire : *a_Wires) {
+    ensureWireIndex();
+    for (auto* e : a_wireIndex.query(visible)) {
+        auto* wire = static_cast<Wire*>(e);
         wire->paint(painter);
         if (wire->Label) {
             wire->Label->paint(painter); // separate because of paintSelected
         }
     }
 
-    for (auto* node : *a_Nodes) {
+    for (auto* e : a_nodeIndex.query(visible)) {
+        auto* node = static_cast<Node*>(e);
         node->paint(painter);
         if (node->Label) {
             node->Label->paint(painter); // separate because of paintSelected
         }
     }
 
+    // few, and their markers and arrow heads reach beyond their rectangles
     for (auto* diagram : *a_Diagrams) {
         diagram->paint(painter);
     }
@@ -1226,12 +1209,65 @@ Schematic::Selection Schematic::currentSelection() const {
 }
 
 // ---------------------------------------------------
-// Updates the graph data of all diagrams (load from data files).
+// Updates the graph data of all diagrams (load from data files). The
+// graphs of all diagrams are loaded concurrently.
 void Schematic::reloadGraphs()
+{
+    cancelGraphLoading();
+    loadGraphs(QList<Diagram*>(a_Diagrams->begin(), a_Diagrams->end()));
+}
+
+// Loads the simulation data of the graphs in the given diagrams.
+void Schematic::loadGraphs(const QList<Diagram*>& Diagrams)
+{
+    QFileInfo Info(a_DocName);
+    QString DataSet = Info.path() + QDir::separator() + a_DataSet;
+
+    QList<Graph*> Graphs;
+    for (Diagram *pd : Diagrams)
+        Graphs += pd->Graphs;
+    QList<int> Loaded = QtConcurrent::blockingMapped(
+        Graphs, [&DataSet](Graph *pg) { return pg->loadDatFile(DataSet); });
+
+    int n = 0;
+    for (Diagram *pd : Diagrams) {
+        QList<int> Results = Loaded.mid(n, pd->Graphs.size());
+        n += pd->Graphs.size();
+        pd->loadedGraphData(Results.count(1) < Results.size());
+    }
+}
+
+// Like reloadGraphs(), but the datasets are parsed in a worker thread and
+// the editor stays responsive. Each diagram is updated as soon as its data
+// is ready, until then it shows the previous data.
+void Schematic::reloadGraphsInBackground()
 {
     QFileInfo Info(a_DocName);
-    for (Diagram *pd : *a_Diagrams)
-        pd->loadGraphData(Info.path() + QDir::separator() + a_DataSet);
+    QList<Diagram*> Diagrams(a_Diagrams->begin(), a_Diagrams->end());
+    for (Diagram *pd : Diagrams)
+        pd->isLoading = true;
+    a_graphLoader->load(Diagrams, Info.path() + QDir::separator() + a_DataSet);
+    viewport()->update();
+}
+
+// Stops loading the graph data, e.g. if a new simulation is started.
+void Schematic::cancelGraphLoading()
+{
+    if (!a_graphLoader->isLoading()) return;
+    a_graphLoader->cancel();
+    for (Diagram *pd : a_DocDiags)
+        pd->isLoading = false;
+    viewport()->update();
+}
+
+void Schematic::slotGraphDataReady(Diagram *pd, const QString &DataSet)
+{
+    // the diagram may have been deleted meanwhile
+    if (std::find(a_DocDiags.begin(), a_DocDiags.end(), pd) == a_DocDiags.end())
+        return;
+    pd->isLoading = false;
+    pd->loadGraphData(DataSet);
+    viewport()->update();
 }
 
 // Copy function,
@@ -1267,6 +1303,7 @@ bool Schematic::load()
     a_DocComps.clear();
     a_DocWires.clear();
     a_DocNodes.clear();
+    invalidateSpatialIndex();
     a_DocDiags.clear();
     a_DocPaints.clear();
     a_SymbolPaints.clear();
@@ -1275,23 +1312,10 @@ bool Schematic::load()
         return false;
     a_lastSaved = QDateTime::currentDateTime();
 
-    while (!a_undoAction.isEmpty()) {
-        delete a_undoAction.last();
-        a_undoAction.pop_back();
-    }
-    a_undoActionIdx = 0;
-    while (!a_undoSymbol.isEmpty()) {
-        delete a_undoSymbol.last();
-        a_undoSymbol.pop_back();
-    }
-    a_symbolMode = true;
-    setChanged(false, true); // "not changed" state, but put on undo stack
-    a_undoSymbolIdx = 0;
-    a_undoSymbol.at(a_undoSymbolIdx)->replace(1, 1, 'i');
-    a_symbolMode = false;
-    setChanged(false, true); // "not changed" state, but put on undo stack
-    a_undoActionIdx = 0;
-    a_undoAction.at(a_undoActionIdx)->replace(1, 1, 'i');
+    // the loaded document is the "not changed" state of both stacks
+    setChanged(false);
+    a_undoSymbol.reset(createSymbolUndoState());
+    a_undoAction.reset(createUndoState());
 
     // The undo stack of the circuit symbol is initialized when first
     // entering its edit mode.
@@ -1329,18 +1353,9 @@ int Schematic::save()
     if (result >= 0) {
         setChanged(false);
 
-        QVector<QString *>::iterator it;
-        for (it = a_undoAction.begin(); it != a_undoAction.end(); it++) {
-            (*it)->replace(1, 1, ' '); //at(1) = ' '; state of being changed
-        }
-        //(1) = 'i';   // state of being unchanged
-        a_undoAction.at(a_undoActionIdx)->replace(1, 1, 'i');
-
-        for (it = a_undoSymbol.begin(); it != a_undoSymbol.end(); it++) {
-            (*it)->replace(1, 1, ' '); //at(1) = ' '; state of being changed
-        }
-        //at(1) = 'i';   // state of being unchanged
-        a_undoSymbol.at(a_undoSymbolIdx)->replace(1, 1, 'i');
+        // the current states are the ones of being unchanged
+        a_undoAction.setUnchanged();
+        a_undoSymbol.setUnchanged();
     }
 
     return result;
@@ -1628,47 +1643,32 @@ int Schematic::orderSymbolPorts()
 bool Schematic::undo()
 {
     if (a_symbolMode) {
-        if (a_undoSymbolIdx == 0) {
+        if (!a_undoSymbol.canUndo()) {
             return false;
         }
 
-        rebuildSymbol(a_undoSymbol.at(--a_undoSymbolIdx));
-
-        emit signalUndoState(a_undoSymbolIdx != 0);
-        emit signalRedoState(a_undoSymbolIdx != a_undoSymbol.size() - 1);
+        a_undoSymbol.undo();
+        restoreSymbolUndoState(a_undoSymbol.current());
 
-        if (a_undoSymbol.at(a_undoSymbolIdx)->at(1) == 'i'
-            && a_undoAction.at(a_undoActionIdx)->at(1) == 'i') {
-            setChanged(false, false);
-            return true;
-        }
+        emit signalUndoState(a_undoSymbol.canUndo());
+        emit signalRedoState(a_undoSymbol.canRedo());
 
-        setChanged(true, false);
+        setChanged(!(a_undoSymbol.isUnchanged() && a_undoAction.isUnchanged()), false);
         return true;
     }
 
     // ...... for schematic edit mode .......
-    if (a_undoActionIdx == 0) {
+    if (!a_undoAction.canUndo()) {
         return false;
     }
 
-    rebuild(a_undoAction.at(--a_undoActionIdx));
-    reloadGraphs(); // load recent simulation data
+    if (!restoreUndoState(a_undoAction.undo()))
+        a_undoAction.redo(); // the document was left as it is
 
-    emit signalUndoState(a_undoActionIdx != 0);
-    emit signalRedoState(a_undoActionIdx != a_undoAction.size() - 1);
-
-    if (a_undoAction.at(a_undoActionIdx)->at(1) == 'i') {
-        if (a_undoSymbol.isEmpty()) {
-            setChanged(false, false);
-            return true;
-        } else if (a_undoSymbol.at(a_undoSymbolIdx)->at(1) == 'i') {
-            setChanged(false, false);
-            return true;
-        }
-    }
+    emit signalUndoState(a_undoAction.canUndo());
+    emit signalRedoState(a_undoAction.canRedo());
 
-    setChanged(true, false);
+    setChanged(!(a_undoAction.isUnchanged() && a_undoSymbol.isUnchanged()), false);
     return true;
 }
 
@@ -1676,49 +1676,34 @@ bool Schematic::undo()
 bool Schematic::redo()
 {
     if (a_symbolMode) {
-        if (a_undoSymbolIdx == a_undoSymbol.size() - 1) {
+        if (!a_undoSymbol.canRedo()) {
             return false;
         }
 
-        rebuildSymbol(a_undoSymbol.at(++a_undoSymbolIdx));
+        a_undoSymbol.redo();
+        restoreSymbolUndoState(a_undoSymbol.current());
         adjustPortNumbers(); // set port names
 
-        emit signalUndoState(a_undoSymbolIdx != 0);
-        emit signalRedoState(a_undoSymbolIdx != a_undoSymbol.size() - 1);
+        emit signalUndoState(a_undoSymbol.canUndo());
+        emit signalRedoState(a_undoSymbol.canRedo());
 
-        if (a_undoSymbol.at(a_undoSymbolIdx)->at(1) == 'i'
-            && a_undoAction.at(a_undoActionIdx)->at(1) == 'i') {
-            setChanged(false, false);
-            return true;
-        }
-
-        setChanged(true, false);
+        setChanged(!(a_undoSymbol.isUnchanged() && a_undoAction.isUnchanged()), false);
         return true;
     }
 
     //
     // ...... for schematic edit mode .......
-    if (a_undoActionIdx == a_undoAction.size() - 1) {
+    if (!a_undoAction.canRedo()) {
         return false;
     }
 
-    rebuild(a_undoAction.at(++a_undoActionIdx));
-    reloadGraphs(); // load recent simulation data
-
-    emit signalUndoState(a_undoActionIdx != 0);
-    emit signalRedoState(a_undoActionIdx != a_undoAction.size() - 1);
+    if (!restoreUndoState(a_undoAction.redo()))
+        a_undoAction.undo(); // the document was left as it is
 
-    if (a_undoAction.at(a_undoActionIdx)->at(1) == 'i') {
-        if (a_undoSymbol.isEmpty()) {
-            setChanged(false, false);
-            return true;
-        } else if (a_undoSymbol.at(a_undoSymbolIdx)->at(1) == 'i') {
-            setChanged(false, false);
-            return true;
-        }
-    }
+    emit signalUndoState(a_undoAction.canUndo());
+    emit signalRedoState(a_undoAction.canRedo());
 
-    setChanged(true, false);
+    setChanged(!(a_undoAction.isUnchanged() && a_undoSymbol.isUnchanged()), false);
     return true;
 }
 
@@ -28,6 +28,8 @@
 #endif
 
 #include "qucsdoc.h"
+#include "spatialindex.h"
+#include "undohistory.h"
 #include "wire_planner.h"
 
 #include "qt3_compat/q3scrollview.h"
@@ -49,6 +51,7 @@ class Element;
 class Component;
 class Conductor;
 class Diagram;
+class GraphLoader;
 class Marker;
 class Node;
 class Painting;
@@ -157,6 +160,9 @@ public:
   int   adjustPortNumbers();
   int   orderSymbolPorts();
   void  reloadGraphs();
+  void  loadGraphs(const QList<Diagram*>&);
+  void  reloadGraphsInBackground();
+  void  cancelGraphLoading();
   bool  createSubcircuitSymbol();
 
   /**
@@ -290,10 +296,12 @@ private:
   int a_tmpViewY2;
   QRect a_tmpUsedArea;
 
-  int a_undoActionIdx;
-  QVector<QString *> a_undoAction;
-  int a_undoSymbolIdx;
-  QVector<QString *> a_undoSymbol;    // undo stack for circuit symbol
+  UndoHistory a_undoAction;
+  UndoHistory a_undoSymbol;    // undo stack for circuit symbol
+  // the element of every line of a_undoAction.current(), or nullptr if it
+  // is no longer in the document
+  std::vector<Element*> a_undoElements[4];
+  quint64 a_undoLogPos = 0;    // in the log of changed elements
 
 signals:
   void signalCursorPosChanged(int, int, QString);
@@ -322,6 +330,9 @@ protected slots:
   void slotScrollLeft();
   void slotScrollRight();
 
+private slots:
+  void slotGraphDataReady(Diagram*, const QString&);
+
 private:
   // Describes the area occupied by all elements of schematic, i.e. it is
   // the union of bounding rectangles of all elements.
@@ -333,6 +344,7 @@ private:
   QPoint a_previousCursorPosition;
 
   bool a_dragIsOkay;
+  GraphLoader *a_graphLoader;  // loads the graph data after a simulation
   /*! \brief hold system-independent information about a schematic file */
   QFileInfo a_FileInfo;
 
@@ -405,7 +417,7 @@ private:
     @return new scale value
   */
   double renderModel(double scale, QRect newModelBounds, QPoint modelPlaneCoords, QPoint viewportCoords);
-  void drawElements(QPainter* painter);
+  void drawElements(QPainter* painter, const QRect& visible);
   void drawDcBiasPoints(QPainter* painter);
   void drawPostPaintEvents(QPainter* painter);
   void paintFrame(QPainter* painter);
@@ -476,10 +488,33 @@ public:
 
   Painting* selectedPainting(float, float);
 
+  // to be called after the element lists were changed directly
+  void invalidateSpatialIndex() noexcept { a_wireIndexValid = a_compIndexValid = false; }
+
 
 private:
   void insertComponentNodes(Component*, bool);
 
+  // Spatial indices for the hit tests. Moved elements are updated in place
+  // (see Element::markChanged()), the indices are rebuilt on demand
+  // when the lists were changed. Nodes and wires are kept up to date while
+  // loading a document.
+  bool wireIndexCurrent() const noexcept;
+  void ensureWireIndex() const;
+  void ensureComponentIndex() const;
+  void indexNode(Node*);   // enters the node's current area
+  void indexWire(Wire*);
+
+  mutable SpatialIndex a_nodeIndex;
+  mutable SpatialIndex a_wireIndex;
+  mutable SpatialIndex a_compIndex;
+  mutable bool a_wireIndexValid = false;
+  mutable bool a_compIndexValid = false;
+  mutable quint64 a_wireIndexLogPos = 0;   // in the log of moved elements
+  mutable quint64 a_compIndexLogPos = 0;
+  mutable const void* a_wireIndexLists = nullptr;
+  mutable const void* a_compIndexLists = nullptr;
+
 /* ********************************************************************
    *****  The following methods are in the file                   *****
    *****  "schematic_file.cpp". They only access the QPtrLists    *****
@@ -520,10 +555,14 @@ private:
   QString createClipboardFile();
   bool    pasteFromClipboard(QTextStream *, std::list<Element*>*);
 
-  QString createUndoString(char);
-  bool    rebuild(QString *);
-  QString createSymbolUndoString(char);
-  bool    rebuildSymbol(QString *);
+  std::vector<Element*> undoElements(int);
+  QString undoLine(int, Element*);
+  UndoHistory::State createUndoState();
+  void pushUndoState(char);
+  bool restoreUndoState(const UndoHistory::Change&);
+  UndoHistory::State createSymbolUndoState();
+  bool restoreSymbolUndoState(const UndoHistory::State&);
+  bool restorePaintings(std::list<Painting*>*, const QStringList&);
 
   static void createNodeSet(QStringList&, int&, Conductor*, Node*);
   void throughAllNodes(bool, QStringList&, int&);
@@ -321,6 +321,100 @@ bool geometryIsInOrder(const std::list<Component*>* components, const std::list<
 }
 
 
+/* *******************************************************************
+   *****                                                         *****
+   *****              Spatial index of the elements              *****
+   *****                                                         *****
+   ******************************************************************* */
+
+// Areas in which the hit tests can find an element, with some margin.
+// Nodes and wires include their labels.
+static QRect nodeRect(const Node* pn)
+{
+    QRect r{pn->x() - 3, pn->y() - 3, 7, 7};
+    if (pn->Label) r = r.united(pn->Label->boundingRect().adjusted(-6, -6, 6, 6));
+    return r;
+}
+
+static QRect wireRect(const Wire* pw)
+{
+    QRect r = pw->boundingRect().adjusted(-6, -6, 6, 6);
+    if (pw->Label) r = r.united(pw->Label->boundingRect().adjusted(-6, -6, 6, 6));
+    return r;
+}
+
+static QRect compRect(const Component* pc)
+{
+    return pc->boundingRectIncludingProperties().adjusted(-2, -2, 2, 2);
+}
+
+// The index is current if it still covers the same lists and the moved
+// elements can be read from the log.
+bool Schematic::wireIndexCurrent() const noexcept
+{
+    return a_wireIndexValid
+        && a_wireIndexLogPos >= Element::changeLogBegin()
+        && a_wireIndexLists == a_Nodes
+        && a_nodeIndex.size() == int(a_Nodes->size())
+        && a_wireIndex.size() == int(a_Wires->size());
+}
+
+void Schematic::ensureWireIndex() const
+{
+    if (wireIndexCurrent()) {
+        // elements of other documents are not in the indices
+        for (Element* e : Element::changeLogSince(a_wireIndexLogPos)) {
+            if (a_nodeIndex.contains(e))
+                a_nodeIndex.update(e, nodeRect(static_cast<Node*>(e)));
+            else if (a_wireIndex.contains(e))
+                a_wireIndex.update(e, wireRect(static_cast<Wire*>(e)));
+        }
+        a_wireIndexLogPos = Element::changeLogEnd();
+        return;
+    }
+
+    a_nodeIndex.clear();
+    for (Node* pn : *a_Nodes) a_nodeIndex.insert(pn, nodeRect(pn));
+    a_wireIndex.clear();
+    for (Wire* pw : *a_Wires) a_wireIndex.insert(pw, wireRect(pw));
+
+    a_wireIndexValid = true;
+    a_wireIndexLogPos = Element::changeLogEnd();
+    a_wireIndexLists = a_Nodes;
+}
+
+void Schematic::indexNode(Node* pn)
+{
+    a_nodeIndex.update(pn, nodeRect(pn));
+}
+
+void Schematic::indexWire(Wire* pw)
+{
+    a_wireIndex.update(pw, wireRect(pw));
+}
+
+void Schematic::ensureComponentIndex() const
+{
+    if (a_compIndexValid
+        && a_compIndexLogPos >= Element::changeLogBegin()
+        && a_compIndexLists == a_Components
+        && a_compIndex.size() == int(a_Components->size())) {
+        for (Element* e : Element::changeLogSince(a_compIndexLogPos))
+            if (a_compIndex.contains(e))
+                a_compIndex.update(e, compRect(static_cast<Component*>(e)));
+        a_compIndexLogPos = Element::changeLogEnd();
+        return;
+    }
+
+    a_compIndex.clear();
+    for (Component* pc : *a_Components) a_compIndex.insert(pc, compRect(pc));
+
+    a_compIndexValid = true;
+    a_compIndexLogPos = Element::changeLogEnd();
+    a_compIndexLists = a_Components;
+}
+
+
 /* *******************************************************************
    *****                                                         *****
    *****              Actions handling the nodes                 *****
@@ -330,8 +424,11 @@ bool geometryIsInOrder(const std::list<Component*>* components, const std::list<
 // Provides a node located at given coordinates, either new or existing one
 Node* Schematic::provideNode(int x, int y)
 {
+    ensureWireIndex();
+
     // Check if there is a node at given coordinates
-    for (auto* node : *a_Nodes) {
+    for (auto* e : a_nodeIndex.query(QPoint{x, y})) {
+      auto* node = static_cast<Node*>(e);
       if (node->x() == x && node->y() == y) {
         return node;
       }
@@ -340,10 +437,12 @@ Node* Schematic::provideNode(int x, int y)
     // Create new node, if no existing one at given coordinates
     Node *new_node = new Node(x, y);
     a_Nodes->push_back(new_node);
+    a_nodeIndex.insert(new_node, nodeRect(new_node));
 
     // Check if the new node lies upon an existing wire
-    for (auto* wire : *a_Wires)
+    for (auto* e : a_wireIndex.query(QPoint{x, y}))
     {
+        auto* wire = static_cast<Wire*>(e);
         if (qucs_s::geom::is_between(new_node, wire->P1(), wire->P2())) {
             // split the wire into two wires
             splitWire(wire, new_node);
@@ -384,8 +483,8 @@ void merge(Node* donor, Node* recipient) {
 
     // Try to keep donor label
     if (recipient->Label == nullptr) {
-        recipient->Label = donor->Label;
-        donor->Label = nullptr;
+        recipient->setLabel(donor->Label);
+        donor->setLabel(nullptr);
     }
 }
 
@@ -445,7 +544,7 @@ Wire* merge_wires_at_node(Node* node) {
 
     // Isolate preserved label completely
     if (preserved_label != nullptr) {
-        preserved_label->pOwner->Label = nullptr;
+        preserved_label->pOwner->setLabel(nullptr);
         preserved_label->pOwner = nullptr;
     }
 
@@ -475,7 +574,7 @@ Wire* merge_wires_at_node(Node* node) {
 
     if (preserved_label != nullptr) {
         delete extended_wire->Label;
-        extended_wire->Label = preserved_label;
+        extended_wire->setLabel(preserved_label);
         preserved_label->pOwner = extended_wire;
     }
 
@@ -500,6 +599,7 @@ bool Schematic::optimizeWires() {
         a_Nodes->remove(redundant_node);
         delete redundant_node;
 
+        invalidateSpatialIndex();
         thereWereChanges = true;
     }
 
@@ -509,9 +609,10 @@ bool Schematic::optimizeWires() {
 // ---------------------------------------------------
 Node* Schematic::selectedNode(int x, int y)
 {
-    for(Node *pn : *a_Nodes) // test nodes
-        if(pn->getSelected(x, y))
-            return pn;
+    ensureWireIndex();
+    for(Element *pe : a_nodeIndex.query(QPoint{x, y})) // test nodes
+        if(static_cast<Node*>(pe)->getSelected(x, y))
+            return static_cast<Node*>(pe);
 
     return 0;
 }
@@ -546,9 +647,10 @@ void Schematic::selectWireLine(Element *pe, Node *pn, bool ctrl)
 // ---------------------------------------------------
 Wire* Schematic::selectedWire(int x, int y)
 {
-    for(Wire *pw : *a_Wires)
-        if(pw->getSelected(x, y))
-            return pw;
+    ensureWireIndex();
+    for(Element *pe : a_wireIndex.query(QPoint{x, y}))
+        if(static_cast<Wire*>(pe)->getSelected(x, y))
+            return static_cast<Wire*>(pe);
 
     return 0;
 }
@@ -557,6 +659,8 @@ Wire* Schematic::selectedWire(int x, int y)
 // Splits the wire "*pw" into two pieces by the node "*pn".
 Wire* Schematic::splitWire(Wire *source_wire, Node *splitter_node)
 {
+    const bool index_current = wireIndexCurrent();
+
     Wire *new_wire = new Wire(splitter_node, source_wire->Port2);
     new_wire->isSelected = source_wire->isSelected;
     source_wire->connectPort2(splitter_node);
@@ -565,11 +669,17 @@ Wire* Schematic::splitWire(Wire *source_wire, Node *splitter_node)
     if(source_wire->Label)
         if((source_wire->Label->cx > splitter_node->cx) || (source_wire->Label->cy > splitter_node->cy))
         {
-            new_wire->Label = source_wire->Label;   // label goes to the new wire
-            source_wire->Label = 0;
+            new_wire->setLabel(source_wire->Label);   // label goes to the new wire
+            source_wire->setLabel(0);
             new_wire->Label->pOwner = new_wire;
         }
 
+    // keep the index instead of rebuilding it, loading relies on that
+    if (index_current) {
+        indexWire(source_wire);
+        indexWire(new_wire);
+    }
+
     return new_wire;
 }
 
@@ -577,10 +687,13 @@ Wire* Schematic::splitWire(Wire *source_wire, Node *splitter_node)
 // become orphan after removing the wires.
 void Schematic::deleteWire(Wire *w, bool remove_orphans)
 {
+    const bool index_current = wireIndexCurrent();
+
     w->Port1->disconnect(w);
     // Delete node if it has become an orphan
     if (remove_orphans && w->Port1->conn_count() == 0) {
         a_Nodes->remove(w->Port1);
+        if (index_current) a_nodeIndex.remove(w->Port1);
         delete w->Port1;
     }
 
@@ -588,10 +701,12 @@ void Schematic::deleteWire(Wire *w, bool remove_orphans)
     // Delete node if it has become an orphan
     if (remove_orphans && w->Port2->conn_count() == 0) {
         a_Nodes->remove(w->Port2);
+        if (index_current) a_nodeIndex.remove(w->Port2);
         delete w->Port2;
     }
 
     a_Wires->remove(w);
+    if (index_current) a_wireIndex.remove(w);
     delete w;
 }
 
@@ -659,9 +774,15 @@ Element* Schematic::selectElement(float fX, float fY, bool flag, int *index)
     Element *pe_sel = 0;
     WireLabel *pl = 0;
 
+    // only the elements near the point are tested, in list order
+    ensureWireIndex();
+    ensureComponentIndex();
+    const QPoint point{x, y};
+
     // test all nodes and their labels
-    for (Node* pn : *a_Nodes)
+    for (Element* pe : a_nodeIndex.query(point))
     {
+        Node* pn = static_cast<Node*>(pe);
         if(!flag)
         {
             // The element cannot be deselected
@@ -714,8 +835,9 @@ Element* Schematic::selectElement(float fX, float fY, bool flag, int *index)
     }
 
     // test all wires and wire labels
-    for (Wire* pw : *a_Wires)
+    for (Element* pe : a_wireIndex.query(point))
     {
+        Wire* pw = static_cast<Wire*>(pe);
         if(pw->getSelected(x, y))
         {
             if(flag)
@@ -768,8 +890,9 @@ Element* Schematic::selectElement(float fX, float fY, bool flag, int *index)
     }
 
     // test all components
-    for (Component* pc : *a_Components)
+    for (Element* pe : a_compIndex.query(point))
     {
+        Component* pc = static_cast<Component*>(pe);
         if(pc->getSelected(x, y))
         {
             if(flag)
@@ -1190,7 +1313,7 @@ bool Schematic::deleteElements()
     auto selection = currentSelection();
 
     for (auto* l : selection.labels) {
-        l->pOwner->Label = nullptr;
+        l->pOwner->setLabel(nullptr);
         delete l;
         sel = true;
     }
@@ -1807,6 +1930,8 @@ void Schematic::insertRawComponent(Component *c, bool noOptimize)
     // connect every node of component to corresponding schematic node
     insertComponentNodes(c, noOptimize);
     a_Components->push_back(c);
+    c->markChanged();  // may take the place of a deleted one
+    a_compIndexValid = false;
 
     // a ground symbol erases an existing label on the wire line
     if(c->Model == "GND")
@@ -1816,7 +1941,7 @@ void Schematic::insertRawComponent(Component *c, bool noOptimize)
         if(pe) if((pe->Type & isComponent) == 0)
             {
                 delete ((Conductor*)pe)->Label;
-                ((Conductor*)pe)->Label = 0;
+                ((Conductor*)pe)->setLabel(0);
             }
         c->Model = "GND";    // rebuild component model
     }
@@ -1828,7 +1953,7 @@ void Schematic::recreateComponent(Component* comp)
     for (auto* port : comp->Ports) {
         if (port->Connection->Label != nullptr && port->Connection->conn_count() == 1) {
             saved_labels.push(port->Connection->Label);
-            port->Connection->Label = nullptr;
+            port->Connection->setLabel(nullptr);
         }
     }
 
@@ -1842,6 +1967,7 @@ void Schematic::recreateComponent(Component* comp)
 
     detachComp(comp);
     comp->recreate();  // to apply changes to the schematic symbol
+    comp->markChanged();
     insertRawComponent(comp);
 
     comp->Name = name;
@@ -1890,7 +2016,7 @@ void Schematic::insertComponent(Component *c)
             if(pe) if((pe->Type & isComponent) == 0)
                 {
                     delete ((Conductor*)pe)->Label;
-                    ((Conductor*)pe)->Label = 0;
+                    ((Conductor*)pe)->setLabel(0);
                 }
             c->Model = "GND";    // rebuild component model
         }
@@ -1911,6 +2037,8 @@ void Schematic::insertComponent(Component *c)
 
     setComponentNumber(c); // important for power sources and subcircuit ports
     a_Components->push_back(c);
+    c->markChanged();  // may take the place of a deleted one
+    a_compIndexValid = false;
 }
 
 // ---------------------------------------------------
@@ -1949,6 +2077,7 @@ void Schematic::activateCompsWithinRect(int x1, int y1, int x2, int y2)
                                 if(pc->Model == "GND")  // if existing, delete label on wire line
                                     oneLabel(pc->Ports.first()->Connection);
                         }
+                        pc->markChanged();
                         changed = true;
                     }
     }
@@ -1984,6 +2113,7 @@ bool Schematic::activateSpecifiedComponent(int x, int y)
             if(pc->Model == "GND")  // if existing, delete label on wire line
                 oneLabel(pc->Ports.first()->Connection);
     }
+    pc->markChanged();
     setChanged(true, true);
     return true;
 }
@@ -2010,6 +2140,7 @@ bool Schematic::activateSelectedComponents()
                     if(pc->Model == "GND")  // if existing, delete label on wire line
                         oneLabel(pc->Ports.first()->Connection);
             }
+            pc->markChanged();
             sel = true;
         }
 
@@ -2022,8 +2153,10 @@ bool Schematic::activateSelectedComponents()
 Component* Schematic::selectCompText(int x_, int y_, int& w, int& h) const
 {
     int a, b, dx, dy;
-    for(Component* pc : *a_Components)
+    ensureComponentIndex();
+    for(Element* pe : a_compIndex.query(QPoint{x_, y_}))
     {
+        auto* pc = static_cast<Component*>(pe);
         a = pc->cx + pc->tx;
         if(x_ < a)  continue;
         b = pc->cy + pc->ty;
@@ -2062,9 +2195,10 @@ Component* Schematic::searchSelSubcircuit()
 Component* Schematic::selectedComponent(int x, int y)
 {
     // test all components
-    for(Component* pc : *a_Components)
-        if(pc->getSelected(x, y))
-            return pc;
+    ensureComponentIndex();
+    for(Element* pe : a_compIndex.query(QPoint{x, y}))
+        if(static_cast<Component*>(pe)->getSelected(x, y))
+            return static_cast<Component*>(pe);
 
     return 0;
 }
@@ -2086,6 +2220,7 @@ void Schematic::detachComp(Component *c)
     }
     emit signalComponentDeleted(c);
     a_Components->remove(c);
+    invalidateSpatialIndex();
 }
 
 // Deletes the component 'c'.
@@ -2128,7 +2263,7 @@ void Schematic::oneLabel(Node *start_node)
         if (node->Label) {
             if (named) {
                 delete node->Label;
-                node->Label = nullptr;
+                node->setLabel(nullptr);
             }
             else {
                 named = true;
@@ -2146,7 +2281,7 @@ void Schematic::oneLabel(Node *start_node)
                 if (comp->isActive == COMP_IS_ACTIVE && comp->Model == "GND") {
                     named = true;
                     if (pl) {
-                        pl->pOwner->Label = nullptr;
+                        pl->pOwner->setLabel(nullptr);
                         delete pl;
                     }
                     pl = nullptr;
@@ -2163,7 +2298,7 @@ void Schematic::oneLabel(Node *start_node)
             if (wire->Label) {
                 if (named) {
                     delete wire->Label;
-                    wire->Label = nullptr;    // erase double names
+                    wire->setLabel(nullptr);    // erase double names
                 } else {
                     named = true;
                     pl = wire->Label;
@@ -2190,12 +2325,13 @@ int Schematic::placeNodeLabel(WireLabel *pl)
         }
 
         delete ((Conductor*)pe)->Label;
-        ((Conductor*)pe)->Label = 0;
+        ((Conductor*)pe)->setLabel(0);
     }
 
-    pn->Label = pl;   // insert node label
+    pn->setLabel(pl);   // insert node label
     pl->Type = isNodeLabel;
     pl->pOwner = pn;
+    a_wireIndexValid = false;
     return 0;
 }
 
@@ -2409,11 +2545,11 @@ std::pair<bool,Node*> Schematic::installWire(Wire* wire)
             internal::find_wire(last_pair.first, last_pair.second, a_Wires->begin(), a_Wires->end());
 
         if (wire->Label == nullptr) {
-            wire->Label = existing_wire->Label;
-            existing_wire->Label = nullptr;
+            wire->setLabel(existing_wire->Label);
+            existing_wire->setLabel(nullptr);
         } else {
             delete existing_wire->Label;
-            existing_wire->Label = nullptr;
+            existing_wire->setLabel(nullptr);
         }
 
         // Detach last wire
@@ -2433,6 +2569,7 @@ std::pair<bool,Node*> Schematic::installWire(Wire* wire)
         a_Wires->push_back(wire);
     }
 
+    a_wireIndexValid = false;
 
     // This value (which will be returned) indicates two things:
     // 1. If there was a change in schematic (i.e. the wire doesn't go all over
@@ -2455,7 +2592,7 @@ std::pair<bool,Node*> Schematic::installWire(Wire* wire)
             wire_label->cy == node_pair.first->y())
              {
                 delete node_pair.first->Label;
-                node_pair.first->Label = wire_label;
+                node_pair.first->setLabel(wire_label);
                 wire_label             = nullptr;
                 break;
              }
@@ -2464,7 +2601,7 @@ std::pair<bool,Node*> Schematic::installWire(Wire* wire)
         if (wire_label->cx == node_pair.second->x() &&
             wire_label->cy == node_pair.second->y()) {
                 delete node_pair.second->Label;
-                node_pair.first->Label = wire_label;
+                node_pair.first->setLabel(wire_label);
                 wire_label             = nullptr;
                 break;
              }
@@ -2478,7 +2615,7 @@ std::pair<bool,Node*> Schematic::installWire(Wire* wire)
         if (qucs_s::geom::is_between(QPoint{wire_label->cx, wire_label->cy},
                                      a_wire->Port1, a_wire->Port2)) {
             delete a_wire->Label;
-            a_wire->Label = wire_label;
+            a_wire->setLabel(wire_label);
             wire_label    = nullptr;
             break;
          }
@@ -2528,8 +2665,8 @@ public:
         delete dest_node->Label;
 
         // Transfer label to a new host
-        label->pOwner->Label = nullptr;
-        dest_node->Label = label;
+        label->pOwner->setLabel(nullptr);
+        dest_node->setLabel(label);
         label->pOwner = dest_node;
         label->Type = isNodeLabel;
         label->moveRootTo(dest_node->center().x(), dest_node->center().y());
@@ -2607,6 +2744,7 @@ bool Schematic::heal(const HealingParams* params) {
             internal::merge(*donor, recipient);
             a_Nodes->remove(*donor);
             delete *donor;
+            invalidateSpatialIndex();
             thereWereChanges = true;
         }
     }
@@ -2643,8 +2781,9 @@ bool Schematic::heal(const HealingParams* params) {
 
             if (unique_wires.contains(p)) {
                 if (unique_wires.at(p)->Label == nullptr) {
-                    unique_wires.at(p)->Label = wire->Label;
-                    wire->Label = nullptr;
+                    unique_wires.at(p)->setLabel(wire->Label);
+                    wire->setLabel(nullptr);
+                    a_wireIndexValid = false;
                 }
                 wire_duplicates.push_back(wire);
             } else {
@@ -2697,6 +2836,7 @@ bool Schematic::heal(const HealingParams* params) {
             internal::merge(*donor, recipient);
             a_Nodes->remove(*donor);
             delete *donor;
+            invalidateSpatialIndex();
             thereWereChanges = true;
         }
     }
@@ -2725,8 +2865,9 @@ bool Schematic::heal(const HealingParams* params) {
 
             if (unique_wires.contains(p)) {
                 if (unique_wires.at(p)->Label == nullptr) {
-                    unique_wires.at(p)->Label = wire->Label;
-                    wire->Label = nullptr;
+                    unique_wires.at(p)->setLabel(wire->Label);
+                    wire->setLabel(nullptr);
+                    a_wireIndexValid = false;
                 }
                 wire_duplicates.push_back(wire);
             } else {
@@ -2743,6 +2884,7 @@ bool Schematic::heal(const HealingParams* params) {
 
     // Remove orphan nodes
     a_Nodes->remove_if([](const Node* n) { return n->conn_count() == 0;});
+    a_wireIndexValid = false;
 
 
     // Remove wires between ports of the same component
@@ -2811,6 +2953,7 @@ void Schematic::dumbConnectWithWire(const QPoint& a, const QPoint& b) noexcept {
         a_Nodes->push_back(wire->Port1);
         a_Nodes->push_back(wire->Port2);
     }
+    a_wireIndexValid = false;
 }
 
 bool Schematic::healAfterMousyMutation()
@@ -24,11 +24,20 @@
 #include <QDir>
 #include <QStringList>
 #include <QPlainTextEdit>
+#include <QTextDocument>
 #include <QTextStream>
 #include <QList>
 #include <QProcess>
 #include <QDebug>
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "main.h"
 #include "node.h"
 #include "wire.h"
@@ -42,6 +51,7 @@
 #include "components/sparamfile.h"
 #include "module.h"
 #include "misc.h"
+#include "subnetlistcache.h"
 #include "extsimkernels/abstractspicekernel.h"
 #include "extsimkernels/s2spice.h"
 #include "osdi/osdi_0_3.h"
@@ -841,6 +851,7 @@ void Schematic::simpleInsertComponent(Component *c)
   }
 
   a_DocComps.push_back(c);
+  a_compIndexValid = false;
 }
 
 // -------------------------------------------------------------
@@ -880,12 +891,13 @@ void Schematic::simpleInsertWire(Wire *pw)
   Node* pn = provideNode(pw->P1());
 
   if(pw->P1() == pw->P2()) {
-    pn->Label = pw->Label;   // wire with length zero are just node labels
+    pn->setLabel(pw->Label);   // wire with length zero are just node labels
     if (pn->Label) {
       pn->Label->Type = isNodeLabel;
       pn->Label->pOwner = pn;
+      if (wireIndexCurrent()) indexNode(pn);
     }
-    pw->Label = nullptr;
+    pw->setLabel(nullptr);
     delete pw;           // delete wire because this is not a wire
     return;
   }
@@ -896,7 +908,11 @@ void Schematic::simpleInsertWire(Wire *pw)
   pn->connect(pw);  // connect schematic node to component node
   pw->Port2 = pn;
 
+  // keep the index up to date, so that loading stays linear
+  const bool index_current = wireIndexCurrent() && a_Wires == &a_DocWires;
   a_DocWires.push_back(pw);
+  if (index_current) indexWire(pw);
+  else a_wireIndexValid = false;
 }
 
 // -------------------------------------------------------------
@@ -927,7 +943,7 @@ bool Schematic::loadWires(QTextStream *stream, std::list<Element*> *List)
         w->Label->Type = isNodeLabel;
         List->push_back(w->Label);
         w->Label->pOwner = nullptr;
-        w->Label = nullptr;
+        w->setLabel(nullptr);
         delete w;
         continue;
       }
@@ -1058,13 +1074,16 @@ bool Schematic::loadDocument()
   // Keep reference to source file (the schematic file)
   setFileInfo(a_DocName);
 
+  // The whole file is read and decoded in one piece, the lines are then
+  // taken from memory.
+  QString FileString = QString::fromUtf8(file.readAll());
+  file.close();
   QString Line;
-  QTextStream stream(&file);
+  QTextStream stream(&FileString, QIODevice::ReadOnly);
 
   // read header **************************
   do {
     if(stream.atEnd()) {
-      file.close();
       return true;
     }
 
@@ -1072,7 +1091,6 @@ bool Schematic::loadDocument()
   } while(Line.isEmpty());
 
   if(Line.left(16) != "<Qucs Schematic ") {  // wrong file type ?
-    file.close();
     QMessageBox::critical(0, QObject::tr("Error"),
     QObject::tr("Wrong document type: ")+a_DocName);
     return false;
@@ -1090,7 +1108,6 @@ bool Schematic::loadDocument()
                                   QMessageBox::Yes|QMessageBox::No);
 
     if (result==QMessageBox::No) {
-        file.close();
         return false;
     }
 
@@ -1106,130 +1123,397 @@ bool Schematic::loadDocument()
 
     if(Line == "<Symbol>") {
       if (!loadPaintings(&stream, &a_SymbolPaints)) {
-        file.close();
         return false;
       }
     }
     else
     if(Line == "<Properties>") {
-      if(!loadProperties(&stream)) { file.close(); return false; } }
+      if(!loadProperties(&stream)) return false; }
     else
     if(Line == "<Components>") {
-      if(!loadComponents(&stream)) { file.close(); return false; } }
+      if(!loadComponents(&stream)) return false; }
     else
     if(Line == "<Wires>") {
-      if(!loadWires(&stream)) { file.close(); return false; } }
+      if(!loadWires(&stream)) return false; }
     else
     if(Line == "<Diagrams>") {
-      if (!loadDiagrams(&stream, &a_DocDiags)) { file.close(); return false; }
+      if (!loadDiagrams(&stream, &a_DocDiags)) return false;
     }
     else
     if(Line == "<Paintings>") {
-      if (!loadPaintings(&stream, &a_DocPaints)) { file.close(); return false; }
+      if (!loadPaintings(&stream, &a_DocPaints)) return false;
     }
     else {
        qDebug() << Line;
        QMessageBox::critical(0, QObject::tr("Error"),
       QObject::tr("File Format Error:\nUnknown field!"));
-      file.close();
       return false;
     }
   }
 
-  file.close();
   return true;
 }
 
 // -------------------------------------------------------------
-// Creates a Qucs file format (without document properties) in the returning
-// string. This is used to save state for undo operation.
-QString Schematic::createUndoString(char Op)
+// The elements of one section of the undo state, in document order:
+// components, wires (with labeled nodes), diagrams or paintings.
+std::vector<Element*> Schematic::undoElements(int Section)
 {
-  // Build element document.
-  QString s = "  \n";
-  s.replace(0,1,Op);
-  for(auto* pc : a_DocComps)
-    s += pc->save()+"\n";
-  s += "</>\n";  // short end flag
-
-  for(auto* pw : a_DocWires)
-    s += pw->save()+"\n";
-  // save all labeled nodes as wires
-  for(Node *pn : a_DocNodes)
-    if(pn->Label) s += pn->Label->save()+"\n";
-  s += "</>\n";
-
-  for(auto* pd : a_DocDiags)
-    s += pd->save()+"\n";
-  s += "</>\n";
+  std::vector<Element*> Elements;
+  switch(Section) {
+    case 0: Elements.assign(a_DocComps.begin(), a_DocComps.end());
+            break;
+    case 1: Elements.assign(a_DocWires.begin(), a_DocWires.end());
+            // save all labeled nodes as wires
+            for(Node *pn : a_DocNodes)
+              if(pn->Label) Elements.push_back(pn);
+            break;
+    case 2: Elements.assign(a_DocDiags.begin(), a_DocDiags.end());
+            break;
+    default: Elements.assign(a_DocPaints.begin(), a_DocPaints.end());
+  }
+  return Elements;
+}
 
-  for(auto* pp : a_DocPaints)
-    s += "<"+pp->save()+">\n";
-  s += "</>\n";
+// -------------------------------------------------------------
+// The saved element "e" of section "Section" of the undo state.
+QString Schematic::undoLine(int Section, Element *e)
+{
+  switch(Section) {
+    case 0: return static_cast<Component*>(e)->save();
+    case 1: if(e->Type == isWire) return static_cast<Wire*>(e)->save();
+            return static_cast<Node*>(e)->Label->save();
+    case 2: return static_cast<Diagram*>(e)->save();
+    default: return "<"+static_cast<Painting*>(e)->save()+">";
+  }
+}
 
+// -------------------------------------------------------------
+// Creates the state of the document for the undo history: the saved
+// components, wires (with labeled nodes), diagrams and paintings. The
+// elements of the lines are kept for the following steps.
+UndoHistory::State Schematic::createUndoState()
+{
+  UndoHistory::State s(4);
+  for(int i = 0; i < 4; i++) {
+    a_undoElements[i] = undoElements(i);
+    for(Element *e : a_undoElements[i])
+      s[i].append(undoLine(i, e));
+  }
+  a_undoLogPos = Element::changeLogEnd();
   return s;
 }
 
 // -------------------------------------------------------------
-// Same as "createUndoString(char Op)" but for symbol edit mode.
-QString Schematic::createSymbolUndoString(char Op)
+// For every element of "to" its index in "from", or -1 if it is new.
+// As in UndoHistory::match(), the matched elements keep their order.
+static std::vector<int> matchElements(const std::vector<Element*>& from,
+                                      const std::vector<Element*>& to)
 {
+  std::vector<int> Result(to.size(), -1);
+  const std::size_t Common = std::min(from.size(), to.size());
 
-  // Build element document.
-  QString s = "  \n";
-  s.replace(0,1,Op);
-  s += "</>\n";  // short end flag for components
-  s += "</>\n";  // short end flag for wires
-  s += "</>\n";  // short end flag for diagrams
+  std::size_t Begin = 0;
+  while(Begin < Common && from[Begin] == to[Begin]) {
+    Result[Begin] = int(Begin);
+    Begin++;
+  }
+  std::size_t End = 0;
+  while(End < Common - Begin
+        && from[from.size() - 1 - End] == to[to.size() - 1 - End]) {
+    Result[to.size() - 1 - End] = int(from.size() - 1 - End);
+    End++;
+  }
 
-  for(auto* pp : a_SymbolPaints)
-    s += "<"+pp->save()+">\n";
-  s += "</>\n";
+  std::unordered_map<Element*, int> Positions;
+  for(std::size_t i = Begin; i < from.size() - End; i++)
+    if(from[i]) Positions[from[i]] = int(i);
 
-  return s;
+  int Last = int(Begin) - 1;
+  for(std::size_t j = Begin; j < to.size() - End; j++) {
+    auto Found = Positions.find(to[j]);
+    if(Found == Positions.end() || Found->second <= Last) continue;
+    Last = Found->second;
+    Result[j] = Last;
+  }
+  return Result;
 }
 
 // -------------------------------------------------------------
-// Is quite similar to "loadDocument()" but with less error checking.
-// Used for "undo" function.
-bool Schematic::rebuild(QString *s)
+// Brings the elements of a section into the order after "Removed" and
+// "Added", as UndoHistory does with the lines. "Inserted" holds the
+// elements of the added lines, missing ones become nullptr.
+static void applyUndoEdits(std::vector<Element*>& Elements,
+                           const QVector<UndoHistory::Edit>& Removed,
+                           const QVector<UndoHistory::Edit>& Added,
+                           const std::vector<Element*>& Inserted = {})
 {
-  a_DocWires.clear();	// delete whole document
-  a_DocNodes.clear();
-  a_DocComps.clear();
-  a_DocDiags.clear();
-  a_DocPaints.clear();
+  std::vector<Element*> Result;
+  Result.reserve(Elements.size() - Removed.size() + Added.size());
+  int r = 0, a = 0;
+  auto insertUpTo = [&](std::size_t Position) {
+    for(; a < Added.size() && std::size_t(Added.at(a).Index) <= Position; a++)
+      Result.push_back(std::size_t(a) < Inserted.size() ? Inserted[a] : nullptr);
+  };
+  for(std::size_t i = 0; i < Elements.size(); i++) {
+    if(r < Removed.size() && std::size_t(Removed.at(r).Index) == i) {
+      r++;
+      continue;
+    }
+    insertUpTo(Result.size());
+    Result.push_back(Elements[i]);
+  }
+  insertUpTo(SIZE_MAX);
+  Elements.swap(Result);
+}
 
-  QString Line;
-  QTextStream stream(s, QIODevice::ReadOnly);
-  Line = stream.readLine();  // skip identity byte
+// -------------------------------------------------------------
+// Adds the changes of the document since the current undo state to the
+// undo history. Only the components and wires that were added, moved
+// within their list, selected or recorded as changed (see
+// Element::markChanged()) are saved anew, the others keep their lines.
+// Diagrams and paintings are few and always saved.
+void Schematic::pushUndoState(char Op)
+{
+  if(Op == 'm' && a_undoAction.op() == Op) {  // only one for move marker
+    const UndoHistory::Change Dropped = a_undoAction.dropCurrent();
+    for(int i = 0; i < 4; i++)
+      applyUndoEdits(a_undoElements[i], Dropped.Removed.value(i), Dropped.Added.value(i));
+  }
 
-  // read content *************************
-  if(!loadComponents(&stream))  return false;
-  if(!loadWires(&stream))  return false;
-  if (!loadDiagrams(&stream, &a_DocDiags)) return false;
-  if (!loadPaintings(&stream, &a_DocPaints)) return false;
+  // if records were dropped, all elements must be compared
+  const bool All = a_undoLogPos < Element::changeLogBegin();
+  std::unordered_set<Element*> Changed;
+  if(!All)
+    for(Element *e : Element::changeLogSince(a_undoLogPos))
+      Changed.insert(e);
+  a_undoLogPos = Element::changeLogEnd();
+
+  auto mayDiffer = [&](int Section, Element *e) {
+    if(All || Section >= 2 || e->isSelected || Changed.count(e)) return true;
+    if(e->Type == isWire) {
+      const WireLabel *pl = static_cast<Wire*>(e)->Label;
+      return pl && pl->isSelected;
+    }
+    const WireLabel *pl = e->Type == isNode ? static_cast<Node*>(e)->Label : nullptr;
+    return pl && pl->isSelected;
+  };
+
+  UndoHistory::Edits Removed(4), Added(4);
+  for(int i = 0; i < 4; i++) {
+    std::vector<Element*> Elements = undoElements(i);
+    const QStringList& Lines = a_undoAction.current().at(i);
+    const std::vector<int> Matched = matchElements(a_undoElements[i], Elements);
+
+    std::vector<bool> Kept(a_undoElements[i].size(), false);
+    for(std::size_t j = 0; j < Elements.size(); j++) {
+      const int k = Matched[j];
+      if(k >= 0 && !mayDiffer(i, Elements[j])) {
+        Kept[k] = true;
+        continue;
+      }
+      QString Line = undoLine(i, Elements[j]);
+      if(k >= 0 && Line == Lines.at(k)) {
+        Kept[k] = true;
+        continue;
+      }
+      Added[i].append(UndoHistory::Edit{int(j), Line});
+    }
+    for(std::size_t k = 0; k < Kept.size(); k++)
+      if(!Kept[k]) Removed[i].append(UndoHistory::Edit{int(k), Lines.at(k)});
 
-  return true;
+    a_undoElements[i].swap(Elements);
+  }
+  a_undoAction.push(Removed, Added, Op);
 }
 
 // -------------------------------------------------------------
-// Same as "rebuild(QString *s)" but for symbol edit mode.
-bool Schematic::rebuildSymbol(QString *s)
+// Same as "createUndoState()" but for symbol edit mode.
+UndoHistory::State Schematic::createSymbolUndoState()
 {
-  a_SymbolPaints.clear();	// delete whole document
+  UndoHistory::State s(4);
+  for(auto* pp : a_SymbolPaints)
+    s[3].append("<"+pp->save()+">");
 
-  QString Line;
-  QTextStream stream(s, QIODevice::ReadOnly);
-  Line = stream.readLine();  // skip identity byte
+  return s;
+}
 
-  // read content *************************
-  Line = stream.readLine();  // skip components
-  Line = stream.readLine();  // skip wires
-  Line = stream.readLine();  // skip diagrams
+// -------------------------------------------------------------
+// Applies a change of the undo history to the document. Only the elements
+// of the removed lines are deleted and those of the added lines created,
+// all others are kept as they are. The new elements are created first, a
+// broken line leaves the document as it is. Used for "undo" function.
+bool Schematic::restoreUndoState(const UndoHistory::Change& Change)
+{
+  std::vector<Element*> NewComps, NewWires;
+  std::list<Diagram*> NewDiags;
+  std::list<Painting*> NewPaints;
+  auto deleteNew = [&]() {
+    for(Element *pe : NewComps)  delete pe;
+    for(Element *pe : NewWires)  delete pe;
+    for(Diagram *pd : NewDiags)  delete pd;
+    for(Painting *pp : NewPaints)  delete pp;
+    return false;
+  };
 
-  if (!loadPaintings(&stream, &a_SymbolPaints)) return false;
+  for(const auto& E : Change.Added.value(0)) {
+    QString Line = E.Element.trimmed();
+    Component *pc = getComponentFromName(Line, this);
+    if(!pc) return deleteNew();
+    NewComps.push_back(pc);
+  }
+  for(const auto& E : Change.Added.value(1)) {
+    Wire *pw = new Wire();
+    NewWires.push_back(pw);
+    if(!pw->load(E.Element.trimmed())) return deleteNew();
+  }
+  if(!Change.Added.value(2).isEmpty()) {
+    QString Missing;
+    for(const auto& E : Change.Added.value(2))
+      Missing += E.Element + "\n";
+    Missing += "</>\n";
+    QTextStream stream(&Missing, QIODevice::ReadOnly);
+    if(!loadDiagrams(&stream, &NewDiags)) return deleteNew();
+  }
+  if(!Change.Added.value(3).isEmpty()) {
+    QString Missing;
+    for(const auto& E : Change.Added.value(3))
+      Missing += E.Element + "\n";
+    Missing += "</>\n";
+    QTextStream stream(&Missing, QIODevice::ReadOnly);
+    if(!loadPaintings(&stream, &NewPaints)) return deleteNew();
+  }
+
+  // remove the elements of the removed lines ...
+  std::set<Node*> Loose;
+  std::set<Element*> Dead;
+  for(const auto& E : Change.Removed.value(1)) {
+    Element *pe = a_undoElements[1][E.Index];
+    if(!pe) continue;
+    if(pe->Type == isWire) {
+      auto* pw = static_cast<Wire*>(pe);
+      pw->Port1->disconnect(pw);
+      pw->Port2->disconnect(pw);
+      Loose.insert(pw->Port1);
+      Loose.insert(pw->Port2);
+      Dead.insert(pw);
+    }
+    else {
+      auto* pn = static_cast<Node*>(pe);
+      delete pn->Label;
+      pn->setLabel(nullptr);
+      Loose.insert(pn);
+    }
+  }
+  a_DocWires.remove_if([&Dead](Wire* pw) { return Dead.count(pw) > 0; });
 
+  for(const auto& E : Change.Removed.value(0)) {
+    auto* pc = static_cast<Component*>(a_undoElements[0][E.Index]);
+    if(!pc) continue;
+    for(Port *pp : pc->Ports) {
+      pp->Connection->disconnect(pc);
+      Loose.insert(pp->Connection);
+    }
+    emit signalComponentDeleted(pc);
+    Dead.insert(pc);
+  }
+  a_DocComps.remove_if([&Dead](Component* pc) { return Dead.count(pc) > 0; });
+  for(Element *pe : Dead) delete pe;
+
+  // ... and the nodes left without connection and label
+  std::set<Node*> DeadNodes;
+  for(Node *pn : Loose)
+    if(pn->conn_count() == 0 && !pn->Label) DeadNodes.insert(pn);
+  a_DocNodes.remove_if([&DeadNodes](Node* pn) { return DeadNodes.count(pn) > 0; });
+  for(Node *pn : DeadNodes) delete pn;
+  invalidateSpatialIndex();
+
+  // Insert the new elements. As in loadDocument(), the components
+  // come before the wires.
+  for(Element *pe : NewComps)
+    simpleInsertComponent(static_cast<Component*>(pe));
+  for(Element*& pe : NewWires) {
+    auto* pw = static_cast<Wire*>(pe);
+    const QPoint P1 = pw->P1();
+    const bool isNodeLabel = P1 == pw->P2();
+    simpleInsertWire(pw);  // deletes "pw" if it is a node label
+    if(isNodeLabel) pe = provideNode(P1);
+  }
+
+  applyUndoEdits(a_undoElements[0], Change.Removed.value(0), Change.Added.value(0), NewComps);
+  a_DocComps.clear();
+  for(Element *pe : a_undoElements[0])
+    a_DocComps.push_back(static_cast<Component*>(pe));
+
+  applyUndoEdits(a_undoElements[1], Change.Removed.value(1), Change.Added.value(1), NewWires);
+  a_DocWires.clear();
+  for(Element *pe : a_undoElements[1])
+    if(pe->Type == isWire) a_DocWires.push_back(static_cast<Wire*>(pe));
+  invalidateSpatialIndex();
+
+  // diagrams and paintings have no connections
+  if(!Change.Removed.value(2).isEmpty() || !NewDiags.empty()) {
+    cancelGraphLoading();  // the loader may hold a diagram to delete
+    for(const auto& E : Change.Removed.value(2))
+      delete a_undoElements[2][E.Index];
+    applyUndoEdits(a_undoElements[2], Change.Removed.value(2), Change.Added.value(2),
+                   std::vector<Element*>(NewDiags.begin(), NewDiags.end()));
+    a_DocDiags.clear();
+    for(Element *pe : a_undoElements[2])
+      a_DocDiags.push_back(static_cast<Diagram*>(pe));
+
+    // only the new diagrams need the simulation data
+    loadGraphs(QList<Diagram*>(NewDiags.begin(), NewDiags.end()));
+  }
+
+  if(!Change.Removed.value(3).isEmpty() || !NewPaints.empty()) {
+    for(const auto& E : Change.Removed.value(3))
+      delete a_undoElements[3][E.Index];
+    applyUndoEdits(a_undoElements[3], Change.Removed.value(3), Change.Added.value(3),
+                   std::vector<Element*>(NewPaints.begin(), NewPaints.end()));
+    a_DocPaints.clear();
+    for(Element *pe : a_undoElements[3])
+      a_DocPaints.push_back(static_cast<Painting*>(pe));
+  }
+  return true;
+}
+
+// -------------------------------------------------------------
+// Same as "restoreUndoState()" but for symbol edit mode.
+bool Schematic::restoreSymbolUndoState(const UndoHistory::State& s)
+{
+  return restorePaintings(&a_SymbolPaints, s.at(3));
+}
+
+// -------------------------------------------------------------
+// Brings the paintings in "List" into the saved state "Lines".
+bool Schematic::restorePaintings(std::list<Painting*> *List, const QStringList& Lines)
+{
+  std::vector<Painting*> Paints(List->begin(), List->end());
+  QStringList PaintLines;
+  for(auto* pp : Paints)
+    PaintLines.append("<"+pp->save()+">");
+  const QVector<int> Matched = UndoHistory::match(PaintLines, Lines);
+  if(Matched.count(-1) == 0 && Paints.size() == std::size_t(Lines.size()))
+    return true;  // nothing changed
+
+  QString Missing;
+  for(int j = 0; j < Lines.size(); j++)
+    if(Matched[j] < 0) Missing += Lines.at(j) + "\n";
+  Missing += "</>\n";
+  QTextStream stream(&Missing, QIODevice::ReadOnly);
+  std::list<Painting*> NewPaints;
+  if(!loadPaintings(&stream, &NewPaints)) return false;
+
+  std::vector<bool> Kept(Paints.size(), false);
+  for(int i : Matched) if(i >= 0) Kept[i] = true;
+  for(std::size_t i = 0; i < Paints.size(); i++)
+    if(!Kept[i]) delete Paints[i];
+
+  List->clear();
+  auto NewPaint = NewPaints.begin();
+  for(int j = 0; j < Lines.size(); j++)
+    List->push_back(Matched[j] >= 0 ? Paints[Matched[j]] : *NewPaint++);
   return true;
 }
 
@@ -1402,6 +1686,23 @@ void Schematic::propagateNode(QStringList& Collect,
 
 #include <iostream>
 
+// -------------------------------------------------------------
+// Notes a definition written into the netlist of a subcircuit from
+// "Begin" on, and caches it if writing it had no other effects. It is
+// written again from the cache when the subcircuit is taken from there.
+static void addDefinition(QTextStream *stream, Component *pc, const QString& File,
+                          const QString& Type, const QString& Key,
+                          qsizetype Begin, bool Cacheable)
+{
+  if(Begin < 0) return;   // not within a subcircuit
+  if(Cacheable) {
+    stream->flush();
+    SubNetlistCache::insert(Key, stream->string()->mid(Begin),
+                            SubNetlistCache::dependencies(pc));
+  }
+  SubNetlistCache::addNested(File, Type, Key, Begin);
+}
+
 /*!
  * \brief Schematic::throughAllComps
  * Goes through all schematic components and allows special component
@@ -1424,6 +1725,12 @@ bool Schematic::throughAllComps(QTextStream *stream, int& countInit,
 
     if(pc->isActive != COMP_IS_ACTIVE) continue;
 
+    // record the files read for this subcircuit netlist
+    if(SubNetlistCache::isRecording()) {
+      pc->setSchematic (this);   // file names are relative to this schematic
+      SubNetlistCache::addDependencies(pc);
+    }
+
     // check analog/digital typed components
     if(a_isAnalog) {
       if((pc->Type & isAnalogComponent) == 0) {
@@ -1450,9 +1757,13 @@ bool Schematic::throughAllComps(QTextStream *stream, int& countInit,
       // tell the subcircuit it belongs to this schematic
       pc->setSchematic (this);
       QString f = pc->getSubcircuitFile();
+      s = pc->Props.first()->Value;
+      QString Key = SubNetlistCache::key(f, s, a_isAnalog, a_isVerilog);
+      const qsizetype Begin = SubNetlistCache::position();
       SubMap::Iterator it = FileList.find(f);
       if(it != FileList.end())
       {
+        SubNetlistCache::addNested(f, "SCH", Key, Begin);
         if (!it.value().PortTypes.isEmpty())
         {
           i = 0;
@@ -1472,8 +1783,26 @@ bool Schematic::throughAllComps(QTextStream *stream, int& countInit,
       FileList.insert(f, sub);
 
 
+      // an unchanged subcircuit is taken from the cache without loading it
+      if(!a_creatingLib && SubNetlistCache::write(Key, *stream, sub.PortTypes))
+      {
+        i = 0;
+        // apply in/out signal types of subcircuit
+        for (Port *pp : pc->Ports)
+        {
+            pp->Type = sub.PortTypes[i];
+            pp->Connection->DType = pp->Type;
+            i++;
+        }
+        FileList.insert(f,sub);
+        SubNetlistCache::addNested(f, "SCH", Key, Begin);
+        continue;
+      }
+
       // load subcircuit schematic
-      s = pc->Props.first()->Value;
+      QString Netlist;
+      QTextStream SubStream(&Netlist);
+      auto Files = std::make_unique<SubNetlistCache::Recorder>(f, SubStream);
       Schematic *d = new Schematic(0, pc->getSubcircuitFile());
       if(!d->loadDocument())      // load document if possible
       {
@@ -1490,7 +1819,15 @@ bool Schematic::throughAllComps(QTextStream *stream, int& countInit,
       d->a_isVerilog = a_isVerilog;
       d->a_isAnalog = a_isAnalog;
       d->a_creatingLib = a_creatingLib;
-      r = d->createSubNetlist(stream, countInit, Collect, ErrText, NumPorts);
+
+      // the netlist is cached only if netlisting has no other effects:
+      // no nodesets and no messages
+      int countInit0 = countInit;
+      qsizetype Collect0 = Collect.size();
+      int Messages0 = ErrText->document()->characterCount();
+      r = d->createSubNetlist(&SubStream, countInit, Collect, ErrText, NumPorts);
+      SubStream.flush();
+      (*stream) << Netlist;
       if (r)
       {
         i = 0;
@@ -1505,7 +1842,12 @@ bool Schematic::throughAllComps(QTextStream *stream, int& countInit,
         sub.PortTypes = d->a_PortTypes;
         FileList.insert(f,sub);
         //FileList.replace(f, sub);
+        if (!a_creatingLib && countInit == countInit0 && Collect.size() == Collect0
+            && ErrText->document()->characterCount() == Messages0)
+          Files->insert(Key, sub.PortTypes);
       }
+      Files.reset();   // the enclosing subcircuit records again
+      SubNetlistCache::addNested(f, "SCH", Key, Begin);
       delete d;
       if(!r)
       {
@@ -1523,9 +1865,13 @@ bool Schematic::throughAllComps(QTextStream *stream, int& countInit,
       }
       QString scfile = pc->getSubcircuitFile();
       s = scfile + "/" + pc->Props.at(1)->Value;
+      QString Key = SubNetlistCache::key(s, "LIB", a_isAnalog, a_isVerilog);
+      const qsizetype Begin = SubNetlistCache::position();
       SubMap::Iterator it = FileList.find(s);
-      if(it != FileList.end())
+      if(it != FileList.end()) {
+        SubNetlistCache::addNested(s, "LIB", Key, Begin);
         continue;   // insert each library subcircuit just one time
+      }
       FileList.insert(s, SubFile("LIB", s));
 
       unsigned whatisit = a_isAnalog?1:(a_isVerilog?4:2);
@@ -1536,6 +1882,7 @@ bool Schematic::throughAllComps(QTextStream *stream, int& countInit,
             else whatisit = 8;
         } else whatisit = 1;
       }
+      qsizetype Collect0 = Collect.size();
       r = lib->createSubNetlist(stream, Collect, whatisit);
 
       if(!r) {
@@ -1544,6 +1891,7 @@ bool Schematic::throughAllComps(QTextStream *stream, int& countInit,
         arg(pc->Name, pc->Props.at(1)->Value, scfile));
         return false;
       }
+      addDefinition(stream, pc, s, "LIB", Key, Begin, Collect.size() == Collect0);
       continue;
     }
 
@@ -1558,9 +1906,13 @@ bool Schematic::throughAllComps(QTextStream *stream, int& countInit,
         return false;
       }
       QString f = pc->getSubcircuitFile();
+      QString Key = SubNetlistCache::key(f, "CIR", a_isAnalog, a_isVerilog);
+      const qsizetype Begin = SubNetlistCache::position();
       SubMap::Iterator it = FileList.find(f);
-      if(it != FileList.end())
+      if(it != FileList.end()) {
+        SubNetlistCache::addNested(f, "CIR", Key, Begin);
         continue;   // insert each spice component just one time
+      }
       FileList.insert(f, SubFile("CIR", f));
 
       SpiceFile *sf = (SpiceFile*)pc;
@@ -1571,6 +1923,7 @@ bool Schematic::throughAllComps(QTextStream *stream, int& countInit,
       if(!r){
         return false;
       }
+      addDefinition(stream, pc, f, "CIR", Key, Begin, sf->getErrorText().isEmpty());
       continue;
     }
 
@@ -1606,16 +1959,22 @@ bool Schematic::throughAllComps(QTextStream *stream, int& countInit,
         return false;
       }
       QString f = pc->getSubcircuitFile();
+      s = ((pc->Model == "VHDL") ? "VHD" : "VER");
+      QString Key = SubNetlistCache::key(f, s, a_isAnalog, a_isVerilog);
+      const qsizetype Begin = SubNetlistCache::position();
       SubMap::Iterator it = FileList.find(f);
-      if(it != FileList.end())
+      if(it != FileList.end()) {
+        SubNetlistCache::addNested(f, s, Key, Begin);
         continue;   // insert each vhdl/verilog component just one time
-      s = ((pc->Model == "VHDL") ? "VHD" : "VER");
+      }
       FileList.insert(f, SubFile(s, f));
 
+      QString Errors;
       if(pc->Model == "VHDL") {
         VHDL_File *vf = (VHDL_File*)pc;
         r = vf->createSubNetlist(stream);
-        ErrText->appendPlainText(vf->getErrorText());
+        Errors = vf->getErrorText();
+        ErrText->appendPlainText(Errors);
         if(!r) {
           return false;
         }
@@ -1623,11 +1982,13 @@ bool Schematic::throughAllComps(QTextStream *stream, int& countInit,
       if(pc->Model == "Verilog") {
         Verilog_File *vf = (Verilog_File*)pc;
         r = vf->createSubNetlist(stream);
-        ErrText->appendPlainText(vf->getErrorText());
+        Errors = vf->getErrorText();
+        ErrText->appendPlainText(Errors);
         if(!r) {
           return false;
         }
       }
+      addDefinition(stream, pc, f, s, Key, Begin, Errors.isEmpty());
       continue;
     }
   }
@@ -0,0 +1,63 @@
+/***************************************************************************
+                           schematictokenizer.cpp
+                          ------------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "schematictokenizer.h"
+
+SchematicTokenizer::SchematicTokenizer(QStringView line)
+{
+  if (line.size() < 2 || line.front() != u'<' || line.back() != u'>')
+    return;
+  Valid = true;
+
+  const QChar *Pos = line.data() + 1;   // cut off start and end character
+  const QChar *End = line.data() + line.size() - 1;
+  while (Pos < End) {
+    if (*Pos == u' ') {
+      Pos++;
+      continue;
+    }
+
+    if (*Pos == u'"') {
+      const QChar *Begin = ++Pos;
+      while (Pos < End && *Pos != u'"') Pos++;   // an open quote runs to the end
+      Quoted.append(Fields.size());
+      Fields.append(Field{QStringView(Begin, Pos), true});
+      if (Pos < End) Pos++;
+      continue;
+    }
+
+    const QChar *Begin = Pos;
+    while (Pos < End && *Pos != u' ' && *Pos != u'"') Pos++;
+    Fields.append(Field{QStringView(Begin, Pos), false});
+  }
+}
+
+QStringView SchematicTokenizer::at(int i) const
+{
+  return i < Fields.size() ? Fields.at(i).Text : QStringView();
+}
+
+QStringView SchematicTokenizer::quoted(int n) const
+{
+  return n < Quoted.size() ? Fields.at(Quoted.at(n)).Text : QStringView();
+}
+
+QStringView SchematicTokenizer::afterQuoted(int n) const
+{
+  if (n >= Quoted.size()) return QStringView();
+  const int i = Quoted.at(n) + 1;
+  if (i >= Fields.size() || Fields.at(i).IsQuoted) return QStringView();
+  return Fields.at(i).Text;
+}
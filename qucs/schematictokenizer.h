@@ -0,0 +1,59 @@
+/***************************************************************************
+                            schematictokenizer.h
+                           ----------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SCHEMATICTOKENIZER_H
+#define SCHEMATICTOKENIZER_H
+
+#include <QStringView>
+#include <QVarLengthArray>
+
+/*!
+ * \file schematictokenizer.h
+ * \brief Splits an element line of a schematic file into its fields.
+ *
+ * An element line looks like
+ *
+ *   <R R1 1 100 200 -26 15 0 0 "50 Ohm" 1 "26.85" 0 "european" 0>
+ *
+ * The line is walked once and the fields are kept as views into it, so
+ * nothing is copied until a field is stored. Quoted fields are returned
+ * without the quotes and may contain spaces. Asking for a field beyond
+ * the end gives an empty view, like QString::section() does.
+ */
+class SchematicTokenizer {
+public:
+  explicit SchematicTokenizer(QStringView line);
+
+  bool isValid() const { return Valid; }   // enclosed in "<" and ">"
+  int count() const { return Fields.size(); }
+  QStringView at(int i) const;
+
+  // the quoted fields and the field following each of them
+  int quotedCount() const { return Quoted.size(); }
+  QStringView quoted(int n) const;
+  QStringView afterQuoted(int n) const;
+
+private:
+  struct Field {
+    QStringView Text;
+    bool IsQuoted;
+  };
+
+  QVarLengthArray<Field, 64> Fields;
+  QVarLengthArray<int, 32> Quoted;   // indices into Fields
+  bool Valid = false;
+};
+
+#endif
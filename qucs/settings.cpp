@@ -52,6 +52,7 @@ void settingsManager::initDefaults()
     m_Defaults["GridColor"] = QColor(qRgb(25, 25, 25));
     m_Defaults["DefaultGraphLineWidth"] = "1";
     m_Defaults["maxUndo"] = 20;
+    m_Defaults["DataSetCacheSize"] = 512;
     m_Defaults["QucsHomeDir"] = QDir::homePath() + QDir::toNativeSeparators("/QucsWorkspace");
 
 #ifdef Q_OS_WIN
@@ -81,6 +82,10 @@ void settingsManager::initDefaults()
     m_Defaults["TextAntiAliasing"] = false;
     m_Defaults["fullTraceName"] = false;
     m_Defaults["NgspiceCompatMode"] = spicecompat::NgspDefault;
+    m_Defaults["NgspiceSweepShards"] = 1;
+    m_Defaults["NgspiceShared"] = false;
+    m_Defaults["NgspiceLibrary"] = "ngspice";
+    m_Defaults["SimResultCacheSize"] = 256;
     m_Defaults["AllowFlexibleWires"] = false;
     m_Defaults["AllowLayingWiresAnew"] = false;
 }
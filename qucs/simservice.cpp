@@ -0,0 +1,416 @@
+/***************************************************************************
+                               simservice.cpp
+                              ----------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "simservice.h"
+#include "main.h"
+#include "module.h"
+#include "schematic.h"
+#include "components/component.h"
+#include "diagrams/datasetcache.h"
+#include "extsimkernels/externsimdialog.h"
+#include "extsimkernels/ngspice.h"
+#include "extsimkernels/spicecompat.h"
+#include "extsimkernels/xyce.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTextStream>
+
+#include <cstdio>
+
+static QJsonObject failure(const QString& error)
+{
+  QJsonObject Reply;
+  Reply["ok"] = false;
+  Reply["error"] = error;
+  return Reply;
+}
+
+// "simulator" of a request, -1 if unknown
+static int simulatorOf(const QJsonObject& request)
+{
+  QString Name = request["simulator"].toString("ngspice").toLower();
+  if (Name == "ngspice") return spicecompat::simNgspice;
+  if (Name == "xyce") return spicecompat::simXyce;
+  if (Name == "qucsator") return spicecompat::simQucsator;
+  return -1;
+}
+
+SimService::SimService(QObject *parent)
+  : QObject(parent)
+{
+  QucsSettings.DefaultSimulator = spicecompat::simNgspice;
+  Module::registerModules();  // once for all requests
+}
+
+/*!
+   Reads requests from stdin until it ends or "quit" is received. The
+   replies are written to stdout.
+*/
+int SimService::serveStdin()
+{
+  QFile In, Out;
+  if (!In.open(stdin, QIODevice::ReadOnly) || !Out.open(stdout, QIODevice::WriteOnly))
+    return -1;
+
+  while (!Quit) {
+    QByteArray Line = In.readLine();
+    if (Line.isEmpty()) break;  // end of input
+    if (Line.trimmed().isEmpty()) continue;
+    Out.write(handle(Line));
+    Out.flush();
+  }
+  return 0;
+}
+
+/*!
+   Listens on the local socket "name". The requests are handled by the
+   event loop of the application, which ends with "quit".
+*/
+bool SimService::listen(const QString& name)
+{
+  Server = new QLocalServer(this);
+  QLocalServer::removeServer(name);  // left over by a crashed service
+  if (!Server->listen(name)) {
+    fprintf(stderr, "Error: Could not listen on %s: %s\n", name.toLocal8Bit().constData(),
+            Server->errorString().toLocal8Bit().constData());
+    return false;
+  }
+  connect(Server, &QLocalServer::newConnection, this, &SimService::slotNewConnection);
+  return true;
+}
+
+void SimService::slotNewConnection()
+{
+  while (QLocalSocket *Socket = Server->nextPendingConnection()) {
+    connect(Socket, &QLocalSocket::readyRead, this, &SimService::slotReadRequests);
+    connect(Socket, &QLocalSocket::disconnected, Socket, &QObject::deleteLater);
+  }
+}
+
+void SimService::slotReadRequests()
+{
+  QLocalSocket *Socket = qobject_cast<QLocalSocket*>(sender());
+  if (!Socket) return;
+  while (Socket->canReadLine()) {
+    QByteArray Line = Socket->readLine();
+    if (Line.trimmed().isEmpty()) continue;
+    Socket->write(handle(Line));
+    Socket->flush();
+    if (Quit) {
+      QCoreApplication::quit();
+      return;
+    }
+  }
+}
+
+/*!
+   Handles one request line and returns the reply line.
+*/
+QByteArray SimService::handle(const QByteArray& line)
+{
+  QJsonParseError Error;
+  QJsonDocument Request = QJsonDocument::fromJson(line, &Error);
+  QJsonObject Reply;
+  if (!Request.isObject())
+    Reply = failure(QStringLiteral("Invalid request: %1").arg(Error.errorString()));
+  else
+    Reply = handle(Request.object());
+  return QJsonDocument(Reply).toJson(QJsonDocument::Compact) + '\n';
+}
+
+QJsonObject SimService::handle(const QJsonObject& request)
+{
+  QElapsedTimer Timer;
+  Timer.start();
+
+  QString Cmd = request["cmd"].toString();
+  QJsonObject Reply;
+  if (Cmd == "open") Reply = open(request);
+  else if (Cmd == "close") Reply = close(request);
+  else if (Cmd == "set") Reply = set(request);
+  else if (Cmd == "netlist") Reply = netlist(request);
+  else if (Cmd == "simulate") Reply = simulate(request);
+  else if (Cmd == "variables") Reply = variables(request);
+  else if (Cmd == "fetch") Reply = fetch(request);
+  else if (Cmd == "quit") {
+    Quit = true;
+    Reply["ok"] = true;
+  }
+  else Reply = failure(QStringLiteral("Unknown command \"%1\"").arg(Cmd));
+
+  if (!Reply.contains("ok")) Reply["ok"] = true;
+  if (request.contains("id")) Reply["id"] = request["id"];
+  Reply["ms"] = Timer.elapsed();
+  return Reply;
+}
+
+/*!
+   Returns the loaded schematic "fileName". It is loaded if it is not
+   in memory yet or if its file changed since.
+*/
+Schematic* SimService::document(const QString& fileName, QString& error, bool reload)
+{
+  QFileInfo Info(fileName);
+  QString Path = Info.canonicalFilePath();
+  if (Path.isEmpty()) {
+    error = QStringLiteral("Could not find schematic \"%1\"").arg(fileName);
+    return nullptr;
+  }
+
+  auto Found = Documents.find(Path);
+  if (Found != Documents.end()) {
+    if (!reload && Found->Modified == Info.lastModified()) return Found->Doc.get();
+    Documents.erase(Found);
+  }
+
+  Schematic *Doc = openSchematic(Path);
+  if (!Doc) {
+    error = QStringLiteral("Could not load schematic \"%1\"").arg(fileName);
+    return nullptr;
+  }
+  Document& New = Documents[Path];
+  New.Doc.reset(Doc);
+  New.Modified = Info.lastModified();
+  return Doc;
+}
+
+/*!
+   Returns the dataset of a request, either given by "dataset" or the
+   one simulated last for "schematic" and "simulator".
+*/
+QString SimService::datasetName(const QJsonObject& request, QString& error) const
+{
+  QString Dataset = request["dataset"].toString();
+  if (!Dataset.isEmpty()) return Dataset;
+
+  QString FileName = request["schematic"].toString();
+  int Simulator = simulatorOf(request);
+  if (FileName.isEmpty() || Simulator < 0) {
+    error = QStringLiteral("No dataset given");
+    return QString();
+  }
+  QFileInfo Info(FileName);
+  QString Ext = Simulator == spicecompat::simXyce ? ".dat.xyce"
+              : Simulator == spicecompat::simNgspice ? ".dat.ngspice" : ".dat";
+  return Info.absoluteDir().absoluteFilePath(Info.completeBaseName() + Ext);
+}
+
+QJsonObject SimService::open(const QJsonObject& request)
+{
+  QString Error;
+  Schematic *Doc = document(request["schematic"].toString(), Error,
+                            request["reload"].toBool());
+  if (!Doc) return failure(Error);
+
+  QJsonArray Names;
+  for (Component *pc : *Doc->a_Components)
+    Names.append(pc->Name);
+  QJsonObject Reply;
+  Reply["components"] = Names;
+  return Reply;
+}
+
+QJsonObject SimService::close(const QJsonObject& request)
+{
+  QString Path = QFileInfo(request["schematic"].toString()).canonicalFilePath();
+  if (!Documents.remove(Path))
+    return failure(QStringLiteral("Schematic is not loaded"));
+  return QJsonObject();
+}
+
+/*!
+   Changes a property of a component in the loaded schematic. The file
+   is not changed.
+*/
+QJsonObject SimService::set(const QJsonObject& request)
+{
+  QString Error;
+  Schematic *Doc = document(request["schematic"].toString(), Error);
+  if (!Doc) return failure(Error);
+
+  QString Name = request["component"].toString();
+  Component *Found = nullptr;
+  for (Component *pc : *Doc->a_Components) {
+    if (pc->Name == Name) {
+      Found = pc;
+      break;
+    }
+  }
+  if (!Found) return failure(QStringLiteral("No component \"%1\"").arg(Name));
+
+  Property *pp = Found->getProperty(request["property"].toString());
+  if (!pp) return failure(QStringLiteral("Component \"%1\" has no property \"%2\"")
+                            .arg(Name, request["property"].toString()));
+
+  QJsonObject Reply;
+  Reply["old"] = pp->Value;
+  pp->Value = request["value"].toVariant().toString();
+  Doc->recreateComponent(Found);  // e.g. another subcircuit file
+  return Reply;
+}
+
+/*!
+   Writes the netlist to "output", or returns it if no output is given.
+*/
+QJsonObject SimService::netlist(const QJsonObject& request)
+{
+  QString Error;
+  Schematic *Doc = document(request["schematic"].toString(), Error);
+  if (!Doc) return failure(Error);
+  int Simulator = simulatorOf(request);
+  if (Simulator < 0) return failure(QStringLiteral("Unknown simulator"));
+  QucsSettings.DefaultSimulator = Simulator;
+
+  QString Output = request["output"].toString();
+  QString FileName = Output;
+  if (FileName.isEmpty())
+    FileName = QDir(QucsSettings.S4Qworkdir).absoluteFilePath("service.cir");
+
+  bool Written = false;
+  if (Simulator == spicecompat::simQucsator) {
+    QFile File(FileName);
+    if (File.open(QIODevice::WriteOnly)) {
+      QTextStream Stream(&File);
+      Written = writeQucsatorNetlist(Doc, Stream);
+    }
+  } else {
+    QFile::remove(FileName);
+    if (Simulator == spicecompat::simXyce)
+      Xyce(Doc).SaveNetlist(FileName, false);
+    else
+      Ngspice(Doc).SaveNetlist(FileName, false);
+    Written = QFile::exists(FileName);
+  }
+  if (!Written) return failure(QStringLiteral("Could not write netlist"));
+
+  QJsonObject Reply;
+  if (Output.isEmpty()) {
+    QFile File(FileName);
+    if (File.open(QIODevice::ReadOnly))
+      Reply["netlist"] = QString::fromUtf8(File.readAll());
+    File.remove();
+  } else {
+    Reply["netlist"] = QFileInfo(Output).absoluteFilePath();
+  }
+  return Reply;
+}
+
+/*!
+   Simulates the loaded schematic and writes the dataset. A result cached
+   for the same netlist is reused unless "force" is set.
+*/
+QJsonObject SimService::simulate(const QJsonObject& request)
+{
+  QString Error;
+  Schematic *Doc = document(request["schematic"].toString(), Error);
+  if (!Doc) return failure(Error);
+  int Simulator = simulatorOf(request);
+  if (Simulator != spicecompat::simNgspice && Simulator != spicecompat::simXyce)
+    return failure(QStringLiteral("Only Ngspice and Xyce can simulate"));
+  QucsSettings.DefaultSimulator = Simulator;
+
+  QString Dataset = datasetName(request, Error);
+  std::unique_ptr<AbstractSpiceKernel> Kernel;
+  if (Simulator == spicecompat::simXyce)
+    Kernel.reset(new Xyce(Doc));
+  else
+    Kernel.reset(new Ngspice(Doc));
+  Kernel->setUseResultCache(!request["force"].toBool());
+  Kernel->slotSimulate();
+  bool Finished = Kernel->waitEndOfSimulation(-1);   // however long it takes
+  if (Finished) Kernel->convertToQucsData(Dataset);
+
+  QString Log = Kernel->getOutput();
+  QJsonObject Reply;
+  Reply["passed"] = Finished && QFile::exists(Dataset)
+                    && !ExternSimDialog::logContainsError(Log);
+  Reply["dataset"] = QFileInfo(Dataset).absoluteFilePath();
+  Reply["log"] = Log;
+  return Reply;
+}
+
+QJsonObject SimService::variables(const QJsonObject& request)
+{
+  QString Error;
+  QString Dataset = datasetName(request, Error);
+  if (Dataset.isEmpty()) return failure(Error);
+  DataSetPtr Data = DataSetCache::instance().dataSet(Dataset);
+  if (!Data) return failure(QStringLiteral("Could not read dataset \"%1\"").arg(Dataset));
+
+  QJsonArray Names;
+  for (const DataSetVarInfo& Info : Data->directory()) {
+    QJsonObject Var;
+    Var["name"] = Info.Name;
+    Var["independent"] = Info.isIndep;
+    Var["dependencies"] = QJsonArray::fromStringList(Info.Deps);
+    Names.append(Var);
+  }
+  QJsonObject Reply;
+  Reply["variables"] = Names;
+  return Reply;
+}
+
+/*!
+   Returns the values of one dataset variable. Complex values are split
+   into "real" and "imag", digital values are returned as strings.
+*/
+QJsonObject SimService::fetch(const QJsonObject& request)
+{
+  QString Error;
+  QString Dataset = datasetName(request, Error);
+  if (Dataset.isEmpty()) return failure(Error);
+  DataSetPtr Data = DataSetCache::instance().dataSet(Dataset);
+  if (!Data) return failure(QStringLiteral("Could not read dataset \"%1\"").arg(Dataset));
+  QString Name = request["variable"].toString();
+  DataSetVarPtr Var = Data->variable(Name);
+  if (!Var) return failure(QStringLiteral("No variable \"%1\"").arg(Name));
+
+  QJsonObject Reply;
+  Reply["variable"] = Var->Name;
+  Reply["independent"] = Var->isIndep;
+  Reply["dependencies"] = QJsonArray::fromStringList(Var->Deps);
+
+  if (Var->isDigital) {
+    QJsonArray Values;
+    for (const QByteArray& Bits : Var->Digital.split('\0').mid(0, Var->count))
+      Values.append(QString::fromLatin1(Bits));
+    Reply["values"] = Values;
+    return Reply;
+  }
+
+  const double *p = Var->data();
+  QJsonArray Real, Imag;
+  bool isComplex = false;
+  for (int i = 0; i < Var->count; i++) {
+    if (Var->isIndep) {
+      Real.append(p[i]);
+    } else {
+      Real.append(p[2*i]);
+      Imag.append(p[2*i+1]);
+      if (p[2*i+1] != 0.0) isComplex = true;
+    }
+  }
+  Reply["real"] = Real;
+  if (isComplex) Reply["imag"] = Imag;
+  return Reply;
+}
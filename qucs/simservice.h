@@ -0,0 +1,90 @@
+/***************************************************************************
+                                simservice.h
+                               --------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SIMSERVICE_H
+#define SIMSERVICE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+
+#include <memory>
+
+class QLocalServer;
+class Schematic;
+
+/*!
+ * \file simservice.h
+ * \brief Headless service that netlists and simulates schematics on request.
+ *
+ * Requests and replies are JSON objects, one per line, read from stdin
+ * or from the clients of a local socket. Every request has a "cmd" and
+ * an optional "id" that is copied into the reply:
+ *
+ *   open      {schematic, reload}       load a schematic, list its components
+ *   close     {schematic}               drop a loaded schematic
+ *   set       {schematic, component, property, value}
+ *   netlist   {schematic, simulator, output}
+ *   simulate  {schematic, simulator, dataset, force}
+ *   variables {dataset | schematic, simulator}
+ *   fetch     {dataset | schematic, simulator, variable}
+ *   quit
+ *
+ * Loaded schematics stay in memory with the changes made by "set", until
+ * their file changes on disk. Datasets are kept by DataSetCache, library
+ * files and subcircuits by their own caches, so repeated requests only
+ * pay for what changed. Requests are handled one after the other.
+ */
+class SimService : public QObject {
+  Q_OBJECT
+
+public:
+  explicit SimService(QObject *parent = nullptr);
+
+  QJsonObject handle(const QJsonObject& request);
+  QByteArray handle(const QByteArray& line);
+
+  int serveStdin();
+  bool listen(const QString& name);
+
+private slots:
+  void slotNewConnection();
+  void slotReadRequests();
+
+private:
+  struct Document {
+    std::shared_ptr<Schematic> Doc;
+    QDateTime Modified;
+  };
+
+  Schematic* document(const QString& fileName, QString& error, bool reload = false);
+  QString datasetName(const QJsonObject& request, QString& error) const;
+
+  QJsonObject open(const QJsonObject& request);
+  QJsonObject close(const QJsonObject& request);
+  QJsonObject set(const QJsonObject& request);
+  QJsonObject netlist(const QJsonObject& request);
+  QJsonObject simulate(const QJsonObject& request);
+  QJsonObject variables(const QJsonObject& request);
+  QJsonObject fetch(const QJsonObject& request);
+
+  QHash<QString, Document> Documents;   // by canonical path
+  QLocalServer *Server = nullptr;
+  bool Quit = false;
+};
+
+#endif
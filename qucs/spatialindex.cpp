@@ -0,0 +1,109 @@
+/***************************************************************************
+                              spatialindex.cpp
+                             ------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "spatialindex.h"
+
+#include <algorithm>
+
+void SpatialIndex::clear()
+{
+  Entries.clear();
+  Cells.clear();
+  NextOrder = 0;
+}
+
+quint64 SpatialIndex::cellKey(int cx, int cy)
+{
+  return (quint64(quint32(cx)) << 32) | quint32(cy);
+}
+
+void SpatialIndex::addToCells(Element *e, const QRect& r)
+{
+  for (int cx = r.left() >> CellShift; cx <= r.right() >> CellShift; cx++)
+    for (int cy = r.top() >> CellShift; cy <= r.bottom() >> CellShift; cy++)
+      Cells[cellKey(cx, cy)].append(e);
+}
+
+void SpatialIndex::removeFromCells(Element *e, const QRect& r)
+{
+  for (int cx = r.left() >> CellShift; cx <= r.right() >> CellShift; cx++)
+    for (int cy = r.top() >> CellShift; cy <= r.bottom() >> CellShift; cy++) {
+      auto Cell = Cells.find(cellKey(cx, cy));
+      if (Cell == Cells.end()) continue;
+      Cell->removeOne(e);
+      if (Cell->isEmpty()) Cells.erase(Cell);
+    }
+}
+
+void SpatialIndex::insert(Element *e, const QRect& Rect)
+{
+  QRect r = Rect.normalized();
+  Entries.insert(e, Entry{r, NextOrder++});
+  addToCells(e, r);
+}
+
+void SpatialIndex::update(Element *e, const QRect& Rect)
+{
+  auto Found = Entries.find(e);
+  if (Found == Entries.end()) {
+    insert(e, Rect);
+    return;
+  }
+  QRect r = Rect.normalized();
+  if (Found->Rect == r) return;
+  removeFromCells(e, Found->Rect);
+  Found->Rect = r;
+  addToCells(e, r);
+}
+
+void SpatialIndex::remove(Element *e)
+{
+  auto Found = Entries.find(e);
+  if (Found == Entries.end()) return;
+  removeFromCells(e, Found->Rect);
+  Entries.erase(Found);
+}
+
+std::vector<Element*> SpatialIndex::query(const QRect& Rect) const
+{
+  QRect r = Rect.normalized();
+  std::vector<std::pair<quint64, Element*>> Found;
+
+  qint64 CellCount = qint64((r.right() >> CellShift) - (r.left() >> CellShift) + 1)
+                   * ((r.bottom() >> CellShift) - (r.top() >> CellShift) + 1);
+  if (CellCount > Entries.size()) {   // cheaper to test every element
+    for (auto it = Entries.constBegin(); it != Entries.constEnd(); ++it)
+      if (it->Rect.intersects(r)) Found.emplace_back(it->Order, it.key());
+  } else {
+    for (int cx = r.left() >> CellShift; cx <= r.right() >> CellShift; cx++)
+      for (int cy = r.top() >> CellShift; cy <= r.bottom() >> CellShift; cy++) {
+        auto Cell = Cells.constFind(cellKey(cx, cy));
+        if (Cell == Cells.constEnd()) continue;
+        for (Element *e : *Cell) {
+          const Entry& E = *Entries.constFind(e);
+          if (E.Rect.intersects(r)) Found.emplace_back(E.Order, e);
+        }
+      }
+  }
+
+  // in insertion order, an element spanning several cells only once
+  std::sort(Found.begin(), Found.end());
+  Found.erase(std::unique(Found.begin(), Found.end()), Found.end());
+
+  std::vector<Element*> Result;
+  Result.reserve(Found.size());
+  for (const auto& f : Found) Result.push_back(f.second);
+  return Result;
+}
@@ -0,0 +1,65 @@
+/***************************************************************************
+                               spatialindex.h
+                              ----------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <QHash>
+#include <QRect>
+#include <QVector>
+
+#include <vector>
+
+class Element;
+
+/*!
+ * \file spatialindex.h
+ * \brief Uniform grid of element bounding rectangles.
+ *
+ * Every element is entered into all grid cells its rectangle touches.
+ * A query returns the elements whose rectangles intersect the query
+ * rectangle, in the order they were inserted. Schematic inserts its
+ * elements in list order, so the hit tests find the same element as a
+ * walk over the list.
+ */
+class SpatialIndex {
+public:
+  void clear();
+  void insert(Element*, const QRect&);
+  void update(Element*, const QRect&);   // keeps the order
+  void remove(Element*);
+  bool contains(Element* e) const { return Entries.contains(e); }
+  std::vector<Element*> query(const QRect&) const;
+  std::vector<Element*> query(const QPoint& p) const { return query(QRect(p, p)); }
+  int size() const { return Entries.size(); }
+
+private:
+  static constexpr int CellShift = 6;   // cells of 64 x 64 units
+
+  struct Entry {
+    QRect Rect;
+    quint64 Order;
+  };
+
+  static quint64 cellKey(int cx, int cy);
+  void addToCells(Element*, const QRect&);
+  void removeFromCells(Element*, const QRect&);
+
+  QHash<Element*, Entry> Entries;
+  QHash<quint64, QVector<Element*>> Cells;
+  quint64 NextOrder = 0;
+};
+
+#endif
@@ -0,0 +1,196 @@
+/***************************************************************************
+                             subnetlistcache.cpp
+                            ---------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "subnetlistcache.h"
+#include "main.h"
+#include "schematic.h"
+#include "components/component.h"
+
+#include <QFileInfo>
+#include <QTextStream>
+
+// the cache is dropped as a whole when it holds more subcircuits
+static constexpr int MaxEntries = 512;
+
+QList<SubNetlistCache::Recorder*> SubNetlistCache::Recorders;
+
+extern SubMap FileList;   // nested definitions written so far
+
+QHash<QString, SubNetlistCache::Entry>& SubNetlistCache::entries()
+{
+  static QHash<QString, Entry> Entries;
+  return Entries;
+}
+
+QString SubNetlistCache::key(const QString& File, const QString& DocName,
+                             bool isAnalog, bool isVerilog)
+{
+  return QStringLiteral("%1|%2|%3|%4|%5").arg(File, DocName)
+      .arg(int(isAnalog)).arg(int(isVerilog)).arg(QucsSettings.DefaultSimulator);
+}
+
+bool SubNetlistCache::isUpToDate(const Entry& e)
+{
+  for(const FileStamp& f : e.Files) {
+    QFileInfo Info(f.File);
+    if(Info.lastModified() != f.Modified || Info.size() != f.Size)
+      return false;
+  }
+  return true;
+}
+
+/*!
+ * Writes the cached netlist of a subcircuit to "stream", with the nested
+ * definitions not yet in "FileList". Returns false if there is no valid
+ * entry for the subcircuit or one of them, nothing is written then.
+ */
+bool SubNetlistCache::write(const QString& Key, QTextStream& stream, QStringList& PortTypes)
+{
+  QString Netlist;
+  QStringList Inserted;
+  if(!collect(Key, Netlist, PortTypes, Inserted)) {
+    for(const QString& File : Inserted)
+      FileList.remove(File);
+    return false;
+  }
+  stream << Netlist;
+  return true;
+}
+
+bool SubNetlistCache::collect(const QString& Key, QString& Netlist,
+                              QStringList& PortTypes, QStringList& Inserted)
+{
+  auto it = entries().find(Key);
+  if(it == entries().end()) return false;
+  if(!isUpToDate(*it)) {
+    entries().erase(it);
+    return false;
+  }
+  const Entry e = *it;   // erasing a nested entry may move it
+
+  for(qsizetype i = 0; i < e.Definitions.size(); i++) {
+    Netlist += e.Pieces.at(i);
+    const Nested& d = e.Definitions.at(i);
+    if(FileList.contains(d.File))
+      continue;   // written before, as netlisting does
+    FileList.insert(d.File, SubFile(d.Type, d.File));
+    Inserted.append(d.File);
+    QStringList NestedPorts;
+    if(!collect(d.Key, Netlist, NestedPorts, Inserted))
+      return false;
+    FileList[d.File].PortTypes = NestedPorts;
+  }
+  Netlist += e.Pieces.last();
+
+  PortTypes = e.PortTypes;
+  for(const FileStamp& f : e.Files)   // for an enclosing subcircuit
+    addDependency(f.File);
+  return true;
+}
+
+void SubNetlistCache::insert(const QString& Key, const QString& Netlist,
+                             const QStringList& Files)
+{
+  Entry e;
+  e.Pieces.append(Netlist);
+  insert(Key, e, Files);
+}
+
+void SubNetlistCache::insert(const QString& Key, Entry& e, const QStringList& Files)
+{
+  if(entries().size() >= MaxEntries) entries().clear();
+  for(const QString& File : Files) {
+    QFileInfo Info(File);
+    e.Files.append({File, Info.lastModified(), Info.size()});
+  }
+  entries().insert(Key, e);
+}
+
+void SubNetlistCache::clear()
+{
+  entries().clear();
+}
+
+void SubNetlistCache::addDependency(const QString& File)
+{
+  if(File.isEmpty()) return;
+  for(Recorder* r : Recorders)
+    if(!r->Files.contains(File))
+      r->Files.append(File);
+}
+
+/*!
+ * Returns the files a component of a netlisted subcircuit reads,
+ * e.g. SPICE, library and HDL files.
+ */
+QStringList SubNetlistCache::dependencies(Component* pc)
+{
+  QStringList Files = pc->getSpiceLibraryFiles();
+  const QString File = pc->getSubcircuitFile();
+  if(pc->Model != "Sub" && !File.isEmpty())  // added by the Recorder of the subcircuit
+    Files.prepend(File);
+  return Files;
+}
+
+void SubNetlistCache::addDependencies(Component* pc)
+{
+  for(const QString& File : dependencies(pc))
+    addDependency(File);
+}
+
+qsizetype SubNetlistCache::position()
+{
+  if(Recorders.isEmpty()) return -1;
+  QTextStream& Stream = Recorders.last()->Stream;
+  Stream.flush();
+  return Stream.string()->size();
+}
+
+void SubNetlistCache::addNested(const QString& File, const QString& Type,
+                                const QString& Key, qsizetype Begin)
+{
+  if(Recorders.isEmpty()) return;
+  Recorders.last()->Spans.append({File, Type, Key, Begin, position()});
+}
+
+SubNetlistCache::Recorder::Recorder(const QString& File, QTextStream& Stream)
+  : Stream(Stream)
+{
+  Recorders.append(this);
+  addDependency(File);
+}
+
+// The nested definitions are cut out of the netlist, the rest is kept
+// in pieces around them.
+void SubNetlistCache::Recorder::insert(const QString& Key, const QStringList& PortTypes)
+{
+  Stream.flush();
+  const QString& Netlist = *Stream.string();
+  Entry e;
+  qsizetype Pos = 0;
+  for(const Span& s : Spans) {
+    e.Pieces.append(Netlist.mid(Pos, s.Begin - Pos));
+    e.Definitions.append({s.File, s.Type, s.Key});
+    Pos = s.End;
+  }
+  e.Pieces.append(Netlist.mid(Pos));
+  e.PortTypes = PortTypes;
+  SubNetlistCache::insert(Key, e, Files);
+}
+
+SubNetlistCache::Recorder::~Recorder()
+{
+  Recorders.removeOne(this);
+}
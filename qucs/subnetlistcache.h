@@ -0,0 +1,121 @@
+/***************************************************************************
+                              subnetlistcache.h
+                             -------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SUBNETLISTCACHE_H
+#define SUBNETLISTCACHE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+class Component;
+class QTextStream;
+
+/*!
+ * \file subnetlistcache.h
+ * \brief Cache of the netlists of subcircuit schematics.
+ *
+ * Schematic::throughAllComps() loads every subcircuit schematic and
+ * netlists it, each time a netlist is created. The cache keeps the
+ * netlist text and the port types of a subcircuit together with the
+ * files it was created from: the subcircuit schematic, nested
+ * subcircuits, SPICE, library and HDL files. An entry is used as long
+ * as none of these files changed on disk, so the subcircuit schematic
+ * is not loaded at all.
+ *
+ * Netlisting writes every nested definition (subcircuit, library
+ * component, SPICE or HDL file) only once, the first time it is found,
+ * and notes it in the global "FileList". So an entry keeps only the own
+ * text of the subcircuit and the places of its nested definitions. When
+ * the entry is written, a nested definition that is not yet in
+ * "FileList" is written from its own entry and added to "FileList".
+ */
+class SubNetlistCache {
+public:
+  // key of a subcircuit netlist, it depends on the netlisting mode too
+  static QString key(const QString& File, const QString& DocName,
+                     bool isAnalog, bool isVerilog);
+  static bool write(const QString& Key, QTextStream& stream, QStringList& PortTypes);
+  static void clear();
+
+  static bool isRecording() { return !Recorders.isEmpty(); }
+  static void addDependencies(Component*);
+  static QStringList dependencies(Component*);
+
+  // Position in the netlist of the innermost recorder, -1 if none records.
+  static qsizetype position();
+  // Notes a nested definition for the innermost recorder. It was written
+  // from "Begin" to the current position, or before if both are equal.
+  static void addNested(const QString& File, const QString& Type,
+                        const QString& Key, qsizetype Begin);
+
+  /*!
+   * Collects the files and the nested definitions of a subcircuit
+   * netlist, while the subcircuit is netlisted into "Stream". Recorders
+   * are nested like the subcircuits, every file is added to all active
+   * recorders, a nested definition only to the innermost one.
+   */
+  class Recorder {
+  public:
+    Recorder(const QString& File, QTextStream& Stream);
+    ~Recorder();
+    // caches the netlist written into the stream
+    void insert(const QString& Key, const QStringList& PortTypes);
+  private:
+    friend class SubNetlistCache;
+    struct Span {
+      QString File, Type, Key;
+      qsizetype Begin, End;
+    };
+    QTextStream& Stream;
+    QStringList Files;
+    QList<Span> Spans;
+  };
+
+  // caches a definition without nested ones, e.g. of a SPICE file
+  static void insert(const QString& Key, const QString& Netlist,
+                     const QStringList& Files);
+
+private:
+  struct FileStamp {
+    QString File;
+    QDateTime Modified;
+    qint64 Size;
+  };
+  struct Nested {
+    QString File;   // in "FileList"
+    QString Type;
+    QString Key;    // of its entry
+  };
+  struct Entry {
+    QStringList Pieces;     // own text, the nested definitions go between
+    QList<Nested> Definitions;
+    QStringList PortTypes;
+    QList<FileStamp> Files;
+  };
+
+  static QHash<QString, Entry>& entries();
+  static void insert(const QString& Key, Entry& e, const QStringList& Files);
+  static bool collect(const QString& Key, QString& Netlist,
+                      QStringList& PortTypes, QStringList& Inserted);
+  static void addDependency(const QString& File);
+  static bool isUpToDate(const Entry&);
+
+  static QList<Recorder*> Recorders;
+};
+
+#endif
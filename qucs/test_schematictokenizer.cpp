@@ -0,0 +1,121 @@
+/***************************************************************************
+                         test_schematictokenizer.cpp
+                        -----------------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#undef NDEBUG
+#include <cassert>
+
+#include <QString>
+
+#include "schematictokenizer.h"
+
+static bool is(QStringView Field, const char *Text)
+{
+  return Field == QLatin1String(Text);
+}
+
+namespace test_fields {
+void run() {
+  const QString Line =
+    R"(<R R1 1 100 200 -26 15 0 0 "50 Ohm" 1 "26.85" 0 "european" 0>)";
+  const SchematicTokenizer s(Line);
+  assert(s.isValid());
+  assert(s.count() == 15);
+  assert(is(s.at(0), "R") && is(s.at(1), "R1") && is(s.at(5), "-26"));
+
+  // quoted fields keep their spaces, but lose the quotes
+  assert(is(s.at(9), "50 Ohm"));
+  assert(s.quotedCount() == 3);
+  assert(is(s.quoted(0), "50 Ohm") && is(s.afterQuoted(0), "1"));
+  assert(is(s.quoted(1), "26.85") && is(s.afterQuoted(1), "0"));
+  assert(is(s.quoted(2), "european") && is(s.afterQuoted(2), "0"));
+
+  // more than one space between the fields
+  const QString Spaced = "<  a   b  >";
+  const SchematicTokenizer t(Spaced);
+  assert(t.count() == 2 && is(t.at(0), "a") && is(t.at(1), "b"));
+}
+} // namespace test_fields
+
+namespace test_empty_quotes {
+void run() {
+  // a wire without a label
+  const QString Line = R"(<0 0 100 0 "" 0 0 0 "">)";
+  const SchematicTokenizer s(Line);
+  assert(s.isValid());
+  assert(s.count() == 9);
+  assert(s.at(4).isEmpty() && s.at(8).isEmpty());
+  assert(s.quotedCount() == 2);
+  assert(s.quoted(0).isEmpty() && is(s.afterQuoted(0), "0"));
+  assert(s.quoted(1).isEmpty() && s.afterQuoted(1).isEmpty());
+
+  // adjacent quotes and a quote right after a field
+  const QString Adjacent = R"(<a "x""" b"y">)";
+  const SchematicTokenizer t(Adjacent);
+  assert(t.count() == 5);
+  assert(is(t.at(0), "a") && is(t.at(1), "x") && t.at(2).isEmpty());
+  assert(is(t.at(3), "b") && is(t.at(4), "y"));
+  assert(t.quotedCount() == 3);
+  assert(t.afterQuoted(0).isEmpty());   // followed by a quoted field
+  assert(is(t.afterQuoted(1), "b"));
+}
+} // namespace test_empty_quotes
+
+namespace test_unterminated_quote {
+void run() {
+  // an open quote runs to the end of the line
+  const QString Line = R"(<Eqn Eqn1 1 "y = x + 1 1>)";
+  const SchematicTokenizer s(Line);
+  assert(s.isValid());
+  assert(s.count() == 4);
+  assert(s.quotedCount() == 1);
+  assert(is(s.quoted(0), "y = x + 1 1"));
+  assert(s.afterQuoted(0).isEmpty());
+}
+} // namespace test_unterminated_quote
+
+namespace test_past_the_end {
+void run() {
+  const QString Line = R"(<a "b c" d>)";
+  const SchematicTokenizer s(Line);
+  assert(s.count() == 3);
+  assert(s.at(3).isEmpty() && s.at(100).isEmpty());
+  assert(s.quotedCount() == 1);
+  assert(s.quoted(1).isEmpty() && s.afterQuoted(1).isEmpty());
+
+  const QString Empty = "<>";
+  const SchematicTokenizer t(Empty);
+  assert(t.isValid() && t.count() == 0);
+  assert(t.at(0).isEmpty() && t.quoted(0).isEmpty() && t.afterQuoted(0).isEmpty());
+}
+} // namespace test_past_the_end
+
+namespace test_invalid {
+void run() {
+  for (const char *Text : {"", "<", ">", "a b c", "<a b c", "a b c>"}) {
+    const QString Line = Text;
+    const SchematicTokenizer s(Line);
+    assert(!s.isValid());
+    assert(s.count() == 0 && s.at(0).isEmpty());
+  }
+}
+} // namespace test_invalid
+
+int main() {
+  test_fields::run();
+  test_empty_quotes::run();
+  test_unterminated_quote::run();
+  test_past_the_end::run();
+  test_invalid::run();
+}
@@ -0,0 +1,115 @@
+/***************************************************************************
+                            test_spatialindex.cpp
+                           -----------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#undef NDEBUG
+#include <cassert>
+
+#include "spatialindex.h"
+
+// the index only compares the pointers
+class Element {
+public:
+  int Id = 0;
+};
+
+using Hits = std::vector<Element*>;
+
+namespace test_insert {
+/*
+   A spans several cells, B and C overlap it, D lies far away at
+   negative coordinates.
+*/
+void run() {
+  Element A, B, C, D;
+  SpatialIndex Index;
+  Index.insert(&A, QRect(QPoint(0, 0), QPoint(300, 100)));
+  Index.insert(&B, QRect(QPoint(40, 20), QPoint(90, 150)));
+  Index.insert(&C, QRect(QPoint(70, 50), QPoint(120, 180)));
+  Index.insert(&D, QRect(QPoint(-1000, -1000), QPoint(-990, -990)));
+  assert(Index.size() == 4);
+  assert(Index.contains(&A) && Index.contains(&D));
+
+  // overlapping elements come in insertion order
+  assert((Index.query(QPoint(80, 60)) == Hits{&A, &B, &C}));
+  assert((Index.query(QPoint(80, 140)) == Hits{&B, &C}));
+  assert((Index.query(QPoint(250, 10)) == Hits{&A}));
+  assert((Index.query(QPoint(-995, -995)) == Hits{&D}));
+  assert(Index.query(QPoint(500, 500)).empty());
+
+  // an element in several cells is returned once
+  assert((Index.query(QRect(QPoint(0, 0), QPoint(300, 10))) == Hits{&A}));
+
+  // a rectangle covering more cells than elements tests every element
+  assert((Index.query(QRect(QPoint(-5000, -5000), QPoint(5000, 5000)))
+          == Hits{&A, &B, &C, &D}));
+
+  // the corners are inside, a rectangle given the wrong way round too
+  assert((Index.query(QPoint(300, 100)) == Hits{&A}));
+  assert((Index.query(QRect(QPoint(-990, -990), QPoint(-1000, -1000))) == Hits{&D}));
+}
+} // namespace test_insert
+
+namespace test_update {
+void run() {
+  Element A, B;
+  SpatialIndex Index;
+  Index.insert(&A, QRect(QPoint(0, 0), QPoint(10, 10)));
+  Index.insert(&B, QRect(QPoint(0, 0), QPoint(10, 10)));
+
+  // A moves away and back, but stays in front of B
+  Index.update(&A, QRect(QPoint(500, 500), QPoint(510, 510)));
+  assert((Index.query(QPoint(5, 5)) == Hits{&B}));
+  assert((Index.query(QPoint(505, 505)) == Hits{&A}));
+  Index.update(&A, QRect(QPoint(5, 5), QPoint(20, 20)));
+  assert((Index.query(QPoint(7, 7)) == Hits{&A, &B}));
+  assert(Index.query(QPoint(505, 505)).empty());
+
+  // an unchanged rectangle
+  Index.update(&B, QRect(QPoint(10, 10), QPoint(0, 0)));
+  assert((Index.query(QPoint(7, 7)) == Hits{&A, &B}));
+
+  // an unknown element is inserted
+  Element C;
+  Index.update(&C, QRect(QPoint(8, 8), QPoint(9, 9)));
+  assert(Index.size() == 3);
+  assert((Index.query(QPoint(8, 8)) == Hits{&A, &B, &C}));
+}
+} // namespace test_update
+
+namespace test_remove {
+void run() {
+  Element A, B;
+  SpatialIndex Index;
+  Index.insert(&A, QRect(QPoint(0, 0), QPoint(200, 200)));
+  Index.insert(&B, QRect(QPoint(100, 100), QPoint(150, 150)));
+
+  Index.remove(&A);
+  assert(!Index.contains(&A) && Index.size() == 1);
+  assert(Index.query(QPoint(10, 10)).empty());
+  assert((Index.query(QPoint(120, 120)) == Hits{&B}));
+  Index.remove(&A);   // not in the index any more
+  assert(Index.size() == 1);
+
+  Index.clear();
+  assert(Index.size() == 0);
+  assert(Index.query(QPoint(120, 120)).empty());
+}
+} // namespace test_remove
+
+int main() {
+  test_insert::run();
+  test_update::run();
+  test_remove::run();
+}
@@ -0,0 +1,180 @@
+/***************************************************************************
+                            test_undohistory.cpp
+                           ----------------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#undef NDEBUG
+#include <cassert>
+
+#include "undohistory.h"
+
+using State = UndoHistory::State;
+using Edits = UndoHistory::Edits;
+
+// a document with the given components and wires
+static State document(const QStringList& Components, const QStringList& Wires)
+{
+  State s(4);
+  s[0] = Components;
+  s[1] = Wires;
+  return s;
+}
+
+static bool isEdit(const QVector<UndoHistory::Edit>& Section, int n,
+                   int Index, const QString& Element)
+{
+  return n < Section.size() && Section.at(n).Index == Index
+         && Section.at(n).Element == Element;
+}
+
+namespace test_match {
+void run() {
+  using Indices = QVector<int>;
+  const QStringList abc{"a", "b", "c"};
+
+  assert(UndoHistory::match(abc, abc) == (Indices{0, 1, 2}));
+  assert(UndoHistory::match({}, abc) == (Indices{-1, -1, -1}));
+  assert(UndoHistory::match(abc, {}).isEmpty());
+
+  // removed, inserted and edited elements
+  assert(UndoHistory::match({"a", "b", "c", "d"}, {"a", "c", "d"}) == (Indices{0, 2, 3}));
+  assert(UndoHistory::match({"a", "b"}, {"a", "x", "b"}) == (Indices{0, -1, 1}));
+  assert(UndoHistory::match(abc, {"a", "B", "c"}) == (Indices{0, -1, 2}));
+
+  // the matched elements keep their order, a moved one is new
+  assert(UndoHistory::match({"a", "b", "c", "d"}, {"c", "a", "b", "d"})
+         == (Indices{2, -1, -1, 3}));
+
+  // equal elements are matched once each
+  assert(UndoHistory::match({"x", "y", "x"}, {"x", "x"}) == (Indices{0, 2}));
+  assert(UndoHistory::match({"x", "x"}, {"x", "x", "x"}) == (Indices{0, 1, -1}));
+}
+} // namespace test_match
+
+namespace test_difference {
+void run() {
+  const State Before = document({"A", "B", "C", "D"}, {});
+  const State After = document({"A", "X", "C", "Y", "D"}, {});
+
+  UndoHistory History;
+  History.reset(Before);
+  History.push(After, 'i');
+  assert(History.current() == After);
+  assert(History.op() == 'i');
+
+  // undo removes the added lines and inserts the removed ones
+  const UndoHistory::Change Undone = History.undo();
+  assert(History.current() == Before);
+  assert(History.op() == ' ');
+  assert(Undone.Removed.at(0).size() == 2);
+  assert(isEdit(Undone.Removed.at(0), 0, 1, "X"));
+  assert(isEdit(Undone.Removed.at(0), 1, 3, "Y"));
+  assert(Undone.Added.at(0).size() == 1);
+  assert(isEdit(Undone.Added.at(0), 0, 1, "B"));
+  assert(Undone.Removed.at(1).isEmpty() && Undone.Added.at(1).isEmpty());
+
+  const UndoHistory::Change Redone = History.redo();
+  assert(History.current() == After);
+  assert(isEdit(Redone.Removed.at(0), 0, 1, "B"));
+  assert(isEdit(Redone.Added.at(0), 1, 3, "Y"));
+  assert(!History.canRedo());
+}
+} // namespace test_difference
+
+namespace test_label_removal {
+/*
+   The label "vout" is removed from the first wire. Only the line of
+   that wire changes, the other wire keeps its line.
+*/
+const QString Labelled = R"(<0 0 100 0 "vout" 40 -20 40 "">)";
+const QString Plain = R"(<0 0 100 0 "" 0 0 0 "">)";
+const QString Other = R"(<100 0 100 100 "" 0 0 0 "">)";
+
+void run() {
+  const State Before = document({}, {Labelled, Other});
+  const State After = document({}, {Plain, Other});
+
+  // compared as whole states
+  UndoHistory History;
+  History.reset(Before);
+  History.push(After, 'c');
+  assert(History.current() == After);
+
+  UndoHistory::Change Undone = History.undo();
+  assert(History.current() == Before);
+  assert(Undone.Removed.at(1).size() == 1 && isEdit(Undone.Removed.at(1), 0, 0, Plain));
+  assert(Undone.Added.at(1).size() == 1 && isEdit(Undone.Added.at(1), 0, 0, Labelled));
+
+  // given by the touched lines, as Schematic::pushUndoState() does
+  Edits Removed(4), Added(4);
+  Removed[1].append(UndoHistory::Edit{0, Labelled});
+  Added[1].append(UndoHistory::Edit{0, Plain});
+  History.reset(Before);
+  History.push(Removed, Added, 'c');
+  assert(History.current() == After);
+  History.undo();
+  assert(History.current() == Before);
+  History.redo();
+  assert(History.current() == After);
+}
+} // namespace test_label_removal
+
+namespace test_steps {
+void run() {
+  const State S0 = document({"A"}, {});
+  const State S1 = document({"A", "B"}, {});
+  const State S2 = document({"A", "B", "C"}, {});
+  const State S3 = document({"B", "C"}, {});
+
+  UndoHistory History;
+  History.reset(S0);
+  assert(!History.canUndo() && !History.canRedo());
+  assert(History.isUnchanged());
+
+  History.push(S1, 'i');
+  History.push(S2, 'i');
+  assert(!History.isUnchanged());
+  History.setUnchanged();
+
+  // a new step drops the ones to redo, also the saved state
+  History.undo();
+  assert(History.current() == S1 && History.canRedo());
+  assert(!History.isUnchanged());
+  History.push(S3, 'd');
+  assert(History.current() == S3 && !History.canRedo());
+  History.undo();
+  History.redo();
+  assert(!History.isUnchanged());
+
+  // the latest step is forgotten
+  const UndoHistory::Change Dropped = History.dropCurrent();
+  assert(History.current() == S1 && !History.canRedo());
+  assert(isEdit(Dropped.Added.at(0), 0, 0, "A"));
+
+  // only the newest states are kept
+  History.push(S2, 'i');
+  History.setUnchanged();
+  History.limit(2);
+  assert(History.current() == S2 && History.isUnchanged());
+  History.undo();
+  assert(History.current() == S1 && !History.canUndo());
+  assert(History.canRedo());
+}
+} // namespace test_steps
+
+int main() {
+  test_match::run();
+  test_difference::run();
+  test_label_removal::run();
+  test_steps::run();
+}
@@ -0,0 +1,162 @@
+/***************************************************************************
+                              undohistory.cpp
+                             -----------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "undohistory.h"
+
+#include <QHash>
+
+UndoHistory::UndoHistory()
+{
+  reset(State(4));
+}
+
+void UndoHistory::reset(const State& state)
+{
+  Current = state;
+  Steps.clear();
+  Ops.clear();
+  Ops.append(' ');
+  Index = 0;
+  Saved = 0;
+}
+
+void UndoHistory::push(const State& state, char op)
+{
+  const Step Diff = difference(Current, state);
+  push(Diff.Removed, Diff.Added, op);
+}
+
+void UndoHistory::push(const Edits& removed, const Edits& added, char op)
+{
+  Steps.resize(Index);
+  Ops.resize(Index + 1);
+  if (Saved > Index) Saved = -1;
+
+  apply(Current, removed, added);
+  Steps.append(Step{removed, added});
+  Ops.append(op);
+  Index++;
+}
+
+UndoHistory::Change UndoHistory::dropCurrent()
+{
+  if (Index == 0) return Change{};
+  const Change Dropped = undo();
+  Steps.resize(Index);
+  Ops.resize(Index + 1);
+  if (Saved > Index) Saved = -1;
+  return Dropped;
+}
+
+void UndoHistory::limit(int maxStates)
+{
+  while (Ops.size() > maxStates && Index > 0) {
+    Steps.removeFirst();
+    Ops.removeFirst();
+    Index--;
+    Saved = Saved > 0 ? Saved - 1 : -1;
+  }
+}
+
+UndoHistory::Change UndoHistory::undo()
+{
+  if (!canUndo()) return Change{};
+  const Step& Last = Steps.at(--Index);
+  apply(Current, Last.Added, Last.Removed);
+  return Change{Last.Added, Last.Removed};
+}
+
+UndoHistory::Change UndoHistory::redo()
+{
+  if (!canRedo()) return Change{};
+  const Step& Next = Steps.at(Index++);
+  apply(Current, Next.Removed, Next.Added);
+  return Change{Next.Removed, Next.Added};
+}
+
+/*!
+   Matches the elements of two versions of a section. Unchanged elements
+   at the start and the end are matched directly. In between, every element
+   of "to" is matched to the next equal element of "from" after the last
+   match, so a moved or edited element shows up as removed and added.
+*/
+QVector<int> UndoHistory::match(const QStringList& from, const QStringList& to)
+{
+  QVector<int> Result(to.size(), -1);
+  const int Common = qMin(from.size(), to.size());
+
+  int Begin = 0;
+  while (Begin < Common && from.at(Begin) == to.at(Begin)) {
+    Result[Begin] = Begin;
+    Begin++;
+  }
+  int End = 0;
+  while (End < Common - Begin
+         && from.at(from.size() - 1 - End) == to.at(to.size() - 1 - End)) {
+    Result[to.size() - 1 - End] = from.size() - 1 - End;
+    End++;
+  }
+
+  QHash<QString, QVector<int>> Positions;
+  for (int i = Begin; i < from.size() - End; i++)
+    Positions[from.at(i)].append(i);
+  QHash<QString, int> Used;
+
+  int Last = Begin - 1;
+  for (int j = Begin; j < to.size() - End; j++) {
+    auto Found = Positions.constFind(to.at(j));
+    if (Found == Positions.constEnd()) continue;
+    int& Next = Used[to.at(j)];
+    while (Next < Found->size() && Found->at(Next) <= Last) Next++;
+    if (Next == Found->size()) continue;
+    Last = Found->at(Next++);
+    Result[j] = Last;
+  }
+  return Result;
+}
+
+UndoHistory::Step UndoHistory::difference(const State& from, const State& to)
+{
+  Step Diff;
+  Diff.Removed.resize(to.size());
+  Diff.Added.resize(to.size());
+  for (int s = 0; s < to.size(); s++) {
+    const QStringList& From = from.value(s);
+    const QStringList& To = to.at(s);
+    const QVector<int> Matched = match(From, To);
+
+    QVector<bool> Kept(From.size(), false);
+    for (int j = 0; j < To.size(); j++) {
+      if (Matched.at(j) < 0) Diff.Added[s].append(Edit{j, To.at(j)});
+      else Kept[Matched.at(j)] = true;
+    }
+    for (int i = 0; i < From.size(); i++)
+      if (!Kept.at(i)) Diff.Removed[s].append(Edit{i, From.at(i)});
+  }
+  return Diff;
+}
+
+// The edits are sorted by index. Removing goes from the back, so that
+// the indices stay valid, inserting from the front.
+void UndoHistory::apply(State& state, const Edits& remove, const Edits& insert)
+{
+  if (state.size() < insert.size()) state.resize(insert.size());
+  for (int s = 0; s < remove.size(); s++)
+    for (auto it = remove.at(s).crbegin(); it != remove.at(s).crend(); ++it)
+      state[s].removeAt(it->Index);
+  for (int s = 0; s < insert.size(); s++)
+    for (const Edit& E : insert.at(s))
+      state[s].insert(E.Index, E.Element);
+}
@@ -0,0 +1,93 @@
+/***************************************************************************
+                               undohistory.h
+                              ---------------
+    copyright            : (C) 2026 by Qucs-S team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef UNDOHISTORY_H
+#define UNDOHISTORY_H
+
+#include <QStringList>
+#include <QVector>
+
+/*!
+ * \file undohistory.h
+ * \brief Undo history that stores the differences between document states.
+ *
+ * A state is a document split into sections (components, wires, diagrams,
+ * paintings), each a list of saved elements in list order. Only the current
+ * state is kept in full. Every step stores the elements removed from and
+ * added to the sections, so the memory grows with the size of the changes
+ * and not with the size of the document.
+ *
+ * A step is either given by the lines it touches or found by comparing a
+ * whole new state with the current one. Undo and redo return the change
+ * they made to the current state, so that the document can follow it
+ * element by element.
+ */
+class UndoHistory {
+public:
+  using State = QVector<QStringList>;
+
+  struct Edit {
+    int Index;
+    QString Element;
+  };
+  using Edits = QVector<QVector<Edit>>;   // per section, sorted by index
+
+  // The lines removed from the current state, at their old indices, and
+  // the lines inserted afterwards, at their new indices. Copies are cheap,
+  // the edits are shared with the step.
+  struct Change {
+    Edits Removed;
+    Edits Added;
+  };
+
+  UndoHistory();
+
+  void reset(const State& state);
+  void push(const State& state, char op);   // drops the steps to redo
+  void push(const Edits& removed, const Edits& added, char op);
+  Change dropCurrent();   // forgets the latest step, the previous state is current
+  void limit(int maxStates);
+
+  bool canUndo() const { return Index > 0; }
+  bool canRedo() const { return Index < Steps.size(); }
+  Change undo();
+  Change redo();
+  const State& current() const { return Current; }
+
+  char op() const { return Ops.at(Index); }   // operation that led to the current state
+  bool isUnchanged() const { return Index == Saved; }
+  void setUnchanged() { Saved = Index; }
+
+  // For every element of "to" the index of the same element in "from",
+  // or -1 if it is new. The matched elements keep their order.
+  static QVector<int> match(const QStringList& from, const QStringList& to);
+
+private:
+  struct Step {
+    Edits Removed;   // from the previous state, per section
+    Edits Added;     // to the next state, per section
+  };
+
+  static Step difference(const State& from, const State& to);
+  static void apply(State& state, const Edits& remove, const Edits& insert);
+
+  State Current;
+  QVector<Step> Steps;   // Steps[n] leads from state n to state n+1
+  QVector<char> Ops;     // per state
+  int Index = 0;         // of the current state
+  int Saved = 0;         // state in which the document is unchanged, or -1
+};
+
+#endif
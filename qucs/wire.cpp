@@ -19,6 +19,7 @@
 #include "one_point.h"
 #include "schematic.h"
 #include "node.h"
+#include "schematictokenizer.h"
 
 #include <QPainter>
 
@@ -53,6 +54,7 @@ Wire::~Wire()
 
 bool Wire::rotate() noexcept
 {
+  markChanged();
   qucs_s::geom::rotate_point_ccw(x1, y1, cx, cy);
   qucs_s::geom::rotate_point_ccw(x2, y2, cx, cy);
 
@@ -121,6 +123,7 @@ void Wire::setName(int distFromPort1, int text_x, int text_y, const QString& nam
 
 void Wire::setName(const QString& Name_, const QString& Value_, int root_x, int root_y, int x_, int y_)
 {
+  markChanged();  // the label is part of the wire's area
   if(Name_.isEmpty() && Value_.isEmpty()) {
     delete Label;
     Label = nullptr;
@@ -160,27 +163,19 @@ QString Wire::save()
 bool Wire::load(const QString& _s)
 {
   bool ok;
-  QString s = _s;
+  const SchematicTokenizer s(_s);
+  if(!s.isValid()) return false;
 
-  if(s.at(0) != '<') return false;
-  if(s.at(s.length()-1) != '>') return false;
-  s = s.mid(1, s.length()-2);   // cut off start and end character
-
-  QString n;
-  n  = s.section(' ',0,0);    // x1
-  x1 = n.toInt(&ok);
+  x1 = s.at(0).toInt(&ok);    // x1
   if(!ok) return false;
 
-  n  = s.section(' ',1,1);    // y1
-  y1 = n.toInt(&ok);
+  y1 = s.at(1).toInt(&ok);    // y1
   if(!ok) return false;
 
-  n  = s.section(' ',2,2);    // x2
-  x2 = n.toInt(&ok);
+  x2 = s.at(2).toInt(&ok);    // x2
   if(!ok) return false;
 
-  n  = s.section(' ',3,3);    // y2
-  y2 = n.toInt(&ok);
+  y2 = s.at(3).toInt(&ok);    // y2
   if(!ok) return false;
 
   // Quick fix for ra3xdh#1273 (25.03.25)
@@ -199,18 +194,18 @@ bool Wire::load(const QString& _s)
 
   updateCenter();
 
-  n = s.section('"',1,1);
+  const QString n = s.quoted(0).toString();
   if(!n.isEmpty()) {     // is wire labeled ?
-    int nx = s.section(' ',5,5).toInt(&ok);   // x coordinate
+    int nx = s.at(5).toInt(&ok);   // x coordinate
     if(!ok) return false;
 
-    int ny = s.section(' ',6,6).toInt(&ok);   // y coordinate
+    int ny = s.at(6).toInt(&ok);   // y coordinate
     if(!ok) return false;
 
-    int delta = s.section(' ',7,7).toInt(&ok);// delta for x/y root coordinate
+    int delta = s.at(7).toInt(&ok);// delta for x/y root coordinate
     if(!ok) return false;
 
-    setName(delta, nx, ny, n, s.section('"',3,3));  // Wire Label
+    setName(delta, nx, ny, n, s.quoted(1).toString());  // Wire Label
   }
 
   return true;
@@ -320,6 +315,7 @@ void Wire::connectPort2(Node* n)
 }
 
 inline void Wire::updateCenter() noexcept {
+  markChanged();
   cx = std::midpoint(x1, x2);
   cy = std::midpoint(y1, y2);
 }
\ No newline at end of file
@@ -119,6 +119,7 @@ void WireLabel::paint(QPainter *p) const {
 
 void WireLabel::setName(const QString& Name_)
 {
+  ownerChanged();  // changes the text size
   Name = Name_;
 
   // get size of text using the screen-compatible metric
@@ -159,6 +160,7 @@ QPoint WireLabel::root() const noexcept
 
 bool WireLabel::moveRoot(int dx, int dy) noexcept
 {
+  ownerChanged();
   cx += dx;
   cy += dy;
   return dx != 0 || dy != 0;
@@ -167,6 +169,7 @@ bool WireLabel::moveRoot(int dx, int dy) noexcept
 bool WireLabel::moveRootTo(int x, int y) noexcept
 {
   const bool is_different = x != cx || y != cy;
+  ownerChanged();
   cx = x;
   cy = y;
   return is_different;
@@ -179,6 +182,7 @@ QPoint WireLabel::center() const noexcept
 
 bool WireLabel::moveCenter(int dx, int dy) noexcept
 {
+  ownerChanged();
   x1 += dx;
   y1 += dy;
   return dx != 0 || dy != 0;
@@ -186,6 +190,7 @@ bool WireLabel::moveCenter(int dx, int dy) noexcept
 
 bool WireLabel::rotate() noexcept
 {
+  ownerChanged();
   qucs_s::geom::rotate_point_ccw(x1, y1, cx, cy);
   return true;
 }
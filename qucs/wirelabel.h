@@ -82,6 +82,9 @@ public:
   QRect boundingRect() const noexcept override;
 
 private:
+  // the label is part of the area of its wire or node
+  void ownerChanged() noexcept { if (pOwner) pOwner->markChanged(); }
+
   bool isHighlighted = false;
   QSize textSize;
 };